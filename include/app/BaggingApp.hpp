@@ -14,6 +14,8 @@ struct BaggingOptions {
     std::string prunerType;      
     double      prunerParam;     
     uint32_t    seed;           
+    std::string maxFeatures = "all";  // 每次分裂的候选特征数：all / sqrt / log2 / 比例 / 个数
+    bool        oobImportance = false; // 训练时同步计算 OOB 置换重要性
 };
 
 
@@ -3,7 +3,8 @@
 #include "boosting/model/RegressionBoostingModel.hpp"
 #include <vector>
 #include <memory>
-#include <random>
+#include <string>
+#include "functions/random/Philox.hpp"
 
 
 class IDartStrategy {
@@ -11,10 +12,11 @@ public:
     virtual ~IDartStrategy() = default;
     
     
+    // rng：本轮的计数器型随机流（由 dartSeed 与迭代序号决定）
     virtual std::vector<int> selectDroppedTrees(
         int totalTrees, 
         double dropRate,
-        std::mt19937& gen) const = 0;
+        Philox& rng) const = 0;
     
     
     virtual double computeDropoutPrediction(
@@ -53,6 +53,20 @@ public:
         std::vector<double>& gradients) const;
     
     
+    // 融合内核: 一次遍历完成 y_pred += lr * treePred，并输出损失、梯度、
+    // Hessian 与 |梯度|。treePred 为空指针时只计算不更新；hessians /
+    // absGradients 为空指针时跳过对应输出。返回更新后的平均损失。
+    // 新树的输出 treePred 由调用方先单独遍历一次算好，树的遍历不在内核中。
+    virtual double updatePredictionsAndGradients(
+        const std::vector<double>& y_true,
+        const double* treePred,
+        double learningRate,
+        std::vector<double>& y_pred,
+        std::vector<double>& gradients,
+        std::vector<double>* hessians = nullptr,
+        std::vector<double>* absGradients = nullptr) const;
+    
+    
     virtual double computeBatchLossWithTiming(
         const std::vector<double>& y_true,
         const std::vector<double>& y_pred,
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "IRegressionLoss.hpp"
+#include <cmath>
 
 
 class SquaredLoss : public IRegressionLoss {
@@ -37,4 +38,44 @@ public:
             gradients[i] = y_true[i] - y_pred[i];
         }
     }
+    
+    
+    double updatePredictionsAndGradients(
+        const std::vector<double>& y_true,
+        const double* treePred,
+        double learningRate,
+        std::vector<double>& y_pred,
+        std::vector<double>& gradients,
+        std::vector<double>* hessians = nullptr,
+        std::vector<double>* absGradients = nullptr) const override {
+        
+        const size_t n = y_true.size();
+        gradients.resize(n);
+        if (hessians) hessians->resize(n);
+        if (absGradients) absGradients->resize(n);
+        
+        const double* yt = y_true.data();
+        double* pred = y_pred.data();
+        double* grad = gradients.data();
+        double* hess = hessians ? hessians->data() : nullptr;
+        double* absGrad = absGradients ? absGradients->data() : nullptr;
+        double totalLoss = 0.0;
+        
+        
+        #pragma omp parallel for simd reduction(+:totalLoss) schedule(static) if(n > 2000)
+        for (size_t i = 0; i < n; ++i) {
+            double p = pred[i];
+            if (treePred) {
+                p += learningRate * treePred[i];
+                pred[i] = p;
+            }
+            const double r = yt[i] - p;
+            grad[i] = r;
+            totalLoss += 0.5 * r * r;
+            if (hess) hess[i] = 1.0;
+            if (absGrad) absGrad[i] = std::abs(r);
+        }
+        
+        return n > 0 ? totalLoss / n : 0.0;
+    }
 };
@@ -69,6 +69,13 @@ public:
     size_t getTreeCount() const { return trees_.size(); }
     
     
+    void truncate(size_t numTrees) {
+        if (numTrees < trees_.size()) {
+            trees_.erase(trees_.begin() + numTrees, trees_.end());
+        }
+    }
+    
+    
     void setBaseScore(double score) { baseScore_ = score; }
     double getBaseScore() const { return baseScore_; }
     
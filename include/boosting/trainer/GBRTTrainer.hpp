@@ -10,7 +10,6 @@
 #include <memory>
 #include <iostream>
 #include <vector>
-#include <random>
 
 struct GBRTConfig {
     // 基本参数
@@ -73,10 +72,21 @@ public:
                   double& mse,
                   double& mae);
     
+    /** 视图训练：梯度按紧凑行号存放，训练行需拷贝（视图为整个矩阵时不拷贝） */
+    void trainOnView(const DatasetView& view);
+    
+    /** 视图评估：逐行指针预测，只收集 O(行数) 的标签与预测值 */
+    void evaluateOnView(const DatasetView& view,
+                        double& loss,
+                        double& mse,
+                        double& mae);
+    
     const RegressionBoostingModel* getModel() const { return &model_; }
     std::string name() const { return "GBRT_Optimized"; }
     
     const std::vector<double>& getTrainingLoss() const { return trainingLoss_; }
+    const std::vector<double>& getValidationLoss() const { return validationLoss_; }
+    int getBestIteration() const { return bestIteration_; }
     
     std::vector<double> getFeatureImportance(int numFeatures) const {
         return model_.getFeatureImportance(numFeatures);
@@ -90,6 +100,12 @@ public:
         valRowLength_ = rowLength;
         hasValidation_ = true;
     }
+    
+    void setValidationData(const DatasetView& validation) {
+        validation.materialize(X_val_, y_val_);
+        valRowLength_ = validation.numFeatures();
+        hasValidation_ = true;
+    }
 
 private:
     GBRTConfig config_;
@@ -104,9 +120,14 @@ private:
     int valRowLength_;
     bool hasValidation_ = false;
     
+    // **验证集增量预测: 每轮只累加最新一棵树**
+    std::vector<double> valPredictions_;
+    double bestValidationLoss_ = 0.0;
+    int bestIteration_ = -1;
+    std::vector<double> bestTreeWeights_;   // DART：最佳迭代时各树的权重
+    
     // DART组件
     std::unique_ptr<IDartStrategy> dartStrategy_;
-    mutable std::mt19937 dartGen_;
     
     // **核心优化方法**
     void trainStandardOptimized(const std::vector<double>& X,
@@ -120,22 +141,11 @@ private:
     // **并行计算方法**
     double computeBaseScoreParallel(const std::vector<double>& y) const;
     
-    double computeTotalLossParallel(const std::vector<double>& y,
-                                   const std::vector<double>& pred) const;
-    
-    void computeResidualsParallel(const std::vector<double>& y,
-                                 const std::vector<double>& pred,
-                                 std::vector<double>& residuals) const;
-    
     void batchTreePredictOptimized(const SingleTreeTrainer* trainer,
                                   const std::vector<double>& X,
                                   int rowLength,
                                   std::vector<double>& predictions) const;
     
-    void updatePredictionsVectorized(const std::vector<double>& treePred,
-                                    double lr,
-                                    std::vector<double>& predictions) const;
-    
     // **DART专用并行方法**
     void computeDartPredictionsParallel(const std::vector<double>& X,
                                        int rowLength,
@@ -153,6 +163,12 @@ private:
     
     bool shouldEarlyStop(const std::vector<double>& losses, int patience) const;
     
+    // **验证集早停**
+    void initValidationPredictions(double baseScore);
+    void updateValidationPredictions(const Node* tree, double factor);
+    bool checkValidationEarlyStop(int iter);
+    void rollbackToBestIteration();
+    
     // **原有方法保留**
     std::unique_ptr<SingleTreeTrainer> createTreeTrainer() const;
     std::unique_ptr<IDartStrategy> createDartStrategy() const;
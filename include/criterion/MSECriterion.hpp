@@ -6,4 +6,8 @@ class MSECriterion : public ISplitCriterion {
 public:
     double nodeMetric(const std::vector<double>& labels,
                       const std::vector<int>& indices) const override;
+
+    double nodeMetricWeighted(const std::vector<double>& labels,
+                              const std::vector<double>& weights,
+                              const std::vector<int>& indices) const override;
 };
@@ -5,9 +5,13 @@
 #include "../tree/ISplitCriterion.hpp"
 #include "../tree/IPruner.hpp"
 #include "tree/trainer/SingleTreeTrainer.hpp"
+#include "ensemble/FlatForest.hpp"
+#include "functions/random/Philox.hpp"
 #include <vector>
 #include <memory>
-#include <random>
+#include <string>
+#include <cstdint>
+#include <functional>
 
 
 class BaggingTrainer : public ITreeTrainer {
@@ -28,9 +32,32 @@ public:
                int rowLength,
                const std::vector<double>& labels) override;
 
+    /** 视图训练：各树以 Bootstrap 行号（重复表示抽中次数）直接在共享矩阵上建树，不拷贝样本 */
+    void trainOnView(const DatasetView& view) override;
+
+    /**
+     * 按批领取树序号：返回本批要训练的全局树序号，空列表表示没有剩余的树
+     * 由某个训练线程在临界区内调用（同一时刻至多一个线程），其余线程照常建树；
+     * 在其中做 MPI 通信需要 MPI_THREAD_SERIALIZED
+     */
+    using TreeBatchSource = std::function<std::vector<int>()>;
+
+    /**
+     * 动态调度训练：各线程建完一棵树就从本地队列取下一个树序号，队列空时由取号线程
+     * 调用 nextBatch 补充，没有按批的线程同步；来源耗尽后结束
+     * expectedTrees：本次预计训练的树数（仅用于进度输出，未知时传 -1）
+     * 每棵树的随机性只取决于基础种子与全局树序号，与由哪个线程 / 进程训练无关
+     */
+    void trainOnView(const DatasetView& view, const TreeBatchSource& nextBatch,
+                     int expectedTrees = -1);
+
+    /** 单行预测：在紧凑森林上串行遍历所有树（不开并行区，适合逐行打分） */
     double predict(const double* sample,
                    int rowLength) const override;
 
+    /** 本训练器全部树的预测之和，按全局树序号顺序相加 */
+    double predictSum(const double* sample) const { return forest_.predictSum(sample); }
+
     void evaluate(const std::vector<double>& X,
                   int rowLength,
                   const std::vector<double>& y,
@@ -39,7 +66,26 @@ public:
 
     
     int getNumTrees() const { return numTrees_; }
+
+    /** 已训练各树的全局序号，与 getForest() 中的树一一对应 */
+    const std::vector<int>& getTreeIds() const { return treeIds_; }
+    
+    /** 训练后展开的紧凑森林（MPI 聚合全部树时按节点数组传输） */
+    const FlatForest& getForest() const { return forest_; }
     double getSampleRatio() const { return sampleRatio_; }
+
+    /**
+     * 随机森林模式：每次分裂只评估 max_features 个随机候选特征
+     * spec 取 "all"（默认，纯行 Bagging）、"sqrt"、"log2"、小数比例（如 "0.3"）或整数个数
+     */
+    void setMaxFeatures(const std::string& spec);
+    const std::string& getMaxFeatures() const { return maxFeatures_; }
+
+    /** 将 max_features 规格解析为候选特征数；0 表示全部特征 */
+    static int resolveMaxFeatures(const std::string& spec, int numFeatures);
+
+    /** 训练时同步计算 OOB 置换特征重要性（每棵树额外 F 次袋外预测，默认关闭） */
+    void setOOBImportance(bool enabled) { oobImportance_ = enabled; }
     
     
     std::vector<double> getFeatureImportance(int numFeatures) const;
@@ -49,6 +95,51 @@ public:
                        int rowLength,
                        const std::vector<double>& labels) const;
 
+    /**
+     * train 为训练时使用的同一视图（袋外行号是视图内序号）
+     * 袋外预测已在训练中随每棵树完成而累积，这里只做一次归约
+     */
+    double getOOBError(const DatasetView& train) const;
+
+    /** 训练中累积的袋外预测和与次数（按视图内序号） */
+    const std::vector<double>& getOOBPredictionSums() const { return oobSums_; }
+    const std::vector<uint32_t>& getOOBPredictionCounts() const { return oobCounts_; }
+
+    /** 单棵树的袋外贡献：升序的袋外位置及该树的预测，以及该树的置换重要性增量 */
+    struct OOBContribution {
+        int treeId = -1;
+        std::vector<int> rows;
+        std::vector<double> predictions;
+        std::vector<double> importance;   // 未启用置换重要性或袋外行少于 2 个时为空
+    };
+
+    /** 各树的袋外贡献，按全局树序号排列（跨进程汇总后再按序号折叠） */
+    const std::vector<OOBContribution>& getOOBContributions() const { return oobContributions_; }
+
+    /**
+     * 按给定顺序（全局树序号）逐树折叠袋外贡献：加法顺序固定，
+     * 结果只取决于树集合，与线程数、进程数和树的分配无关
+     */
+    static void foldOOB(const std::vector<const OOBContribution*>& ordered,
+                        size_t dataSize, int numFeatures,
+                        std::vector<double>& sums, std::vector<uint32_t>& counts,
+                        std::vector<double>& importanceSums, int& importanceTrees);
+
+    /** 由袋外预测和与次数计算 OOB MSE（按序号顺序求和） */
+    static double oobMeanSquaredError(const DatasetView& train,
+                                      const std::vector<double>& sums,
+                                      const std::vector<uint32_t>& counts);
+
+    /**
+     * OOB 置换重要性：各树置换特征 j 后袋外 MSE 的增量，按树平均
+     * 仅在 setOOBImportance(true) 后训练时可用，否则为空
+     */
+    std::vector<double> getOOBPermutationImportance() const;
+
+    /** 置换重要性的未平均累加值与参与树数（跨进程归约用） */
+    const std::vector<double>& getOOBImportanceSums() const { return oobImportanceSums_; }
+    int getOOBImportanceTrees() const { return oobImportanceTrees_; }
+
 private:
     
     int numTrees_;
@@ -59,36 +150,41 @@ private:
     std::string splitMethod_;
     std::string prunerType_;
     double prunerParam_;
-    
-    
-    mutable std::mt19937 gen_;
+    std::string maxFeatures_ = "all";
+    uint32_t seed_;
     
     
     std::vector<std::unique_ptr<SingleTreeTrainer>> trees_;
-    std::vector<std::vector<int>> oobIndices_;  
-    
-    
-    std::unique_ptr<ISplitFinder> createSplitFinder() const;
+    std::vector<int> treeIds_;
+    FlatForest forest_;
+    
+    // 训练中随每棵树完成记录的袋外贡献，以及按树序号折叠后的统计
+    bool oobImportance_ = false;
+    std::vector<OOBContribution> oobContributions_;
+    std::vector<double> oobSums_;
+    std::vector<uint32_t> oobCounts_;
+    std::vector<double> oobImportanceSums_;
+    int oobImportanceTrees_ = 0;
+    
+    // 单棵树的袋外贡献（只写该树自己的记录，无共享写入）；permRng 非空时同时计算置换重要性
+    OOBContribution computeOOB(int treeId,
+                               const SingleTreeTrainer& tree,
+                               const DatasetView& view,
+                               std::vector<int> oob,
+                               Philox* permRng) const;
+    
+    
+    // treeKey：随机分裂阈值的种子，按树区分
+    std::unique_ptr<ISplitFinder> createSplitFinder(uint64_t treeKey) const;
     std::unique_ptr<ISplitCriterion> createCriterion() const;
     std::unique_ptr<IPruner> createPruner(const std::vector<double>& X_val,
                                          int rowLength,
                                          const std::vector<double>& y_val) const;
     
     
-    void bootstrapSample(int dataSize,
-                        std::vector<int>& sampleIndices,
-                        std::vector<int>& oobIndices) const;
-    
-    
-    void extractSubsetOptimized(const std::vector<double>& originalData,
-                               int rowLength,
-                               const std::vector<double>& originalLabels,
-                               const std::vector<int>& indices,
-                               std::vector<double>& subData,
-                               std::vector<double>& subLabels) const;
-    
+    // sampleIndices 按行号升序、按抽中次数重复；oobIndices 为未抽中的位置
     void bootstrapSample(int dataSize,
                         std::vector<int>& sampleIndices,
                         std::vector<int>& oobIndices,
-                        std::mt19937& localGen) const;  
+                        Philox& rng) const;
 };
@@ -0,0 +1,67 @@
+// =============================================================================
+// include/ensemble/FlatForest.hpp - 紧凑森林：单行预测的串行快速路径
+// =============================================================================
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "tree/Node.hpp"
+
+/**
+ * 将多棵树的节点按先序存入一个连续数组：左孩子紧随父节点，只记录右孩子位置
+ * 单行预测串行遍历所有树，不开并行区、不做通信；节点为 POD，可直接按字节传输
+ */
+class FlatForest {
+public:
+    struct FlatNode {
+        int    feature;  // < 0 表示叶子
+        int    right;    // 右孩子下标（左孩子为当前下标 + 1）
+        double value;    // 内部节点为阈值，叶子为预测值
+    };
+
+    void clear() {
+        nodes_.clear();
+        roots_.clear();
+    }
+
+    /** 追加一棵树（root 为空时按预测 0 的单叶子处理） */
+    void addTree(const Node* root);
+
+    /** 追加另一森林的全部树 */
+    void append(const FlatForest& other);
+
+    /** 只追加另一森林的第 k 棵树（按全局树序号重排时使用） */
+    void appendTree(const FlatForest& other, size_t k);
+
+    /** 由原始节点 / 根下标数组重建（跨进程传输后使用） */
+    void assign(std::vector<FlatNode> nodes, std::vector<int> roots) {
+        nodes_ = std::move(nodes);
+        roots_ = std::move(roots);
+    }
+
+    bool empty() const { return roots_.empty(); }
+    size_t numTrees() const { return roots_.size(); }
+    const std::vector<FlatNode>& nodes() const { return nodes_; }
+    const std::vector<int>& roots() const { return roots_; }
+
+    /** 所有树对一行的预测之和（按树的存放顺序相加） */
+    double predictSum(const double* sample) const {
+        double sum = 0.0;
+        for (size_t k = 0; k < roots_.size(); ++k) sum += predictTree(sample, k);
+        return sum;
+    }
+
+    /** 第 k 棵树对一行的预测 */
+    double predictTree(const double* sample, size_t k) const {
+        const FlatNode* nodes = nodes_.data();
+        int i = roots_[k];
+        while (nodes[i].feature >= 0) {
+            i = (sample[nodes[i].feature] <= nodes[i].value) ? i + 1 : nodes[i].right;
+        }
+        return nodes[i].value;
+    }
+
+private:
+    std::vector<FlatNode> nodes_;
+    std::vector<int> roots_;
+};
@@ -3,6 +3,7 @@
 #include <mpi.h>
 #include <vector>
 #include <memory>
+#include <functional>
 
 /**
  * MPI-enabled Bagging trainer that distributes tree training across MPI processes
@@ -22,17 +23,49 @@ public:
     
     ~MPIBaggingTrainer();
     
+    // Random forest mode: candidate features per split (see BaggingTrainer::setMaxFeatures)
+    void setMaxFeatures(const std::string& spec) { localBagging_->setMaxFeatures(spec); }
+    
+    // Compute OOB permutation importance while training (see BaggingTrainer::setOOBImportance)
+    void setOOBImportance(bool enabled) { localBagging_->setOOBImportance(enabled); }
+    
+    // Dynamic scheduling (default): threads on every rank claim tree ids on demand from a
+    // shared counter, so slow trees do not stall a whole rank's block. Requires
+    // MPI_THREAD_SERIALIZED when more than one OpenMP thread runs; otherwise static is used.
+    // Static scheduling: each rank trains one contiguous block of tree ids.
+    // Either way tree t depends only on the seed and t, so the forest is the same.
+    void setDynamicScheduling(bool enabled) { dynamicScheduling_ = enabled; }
+    
+    // Trees trained by this process in the last call to train()/trainOnView()
+    int getLocalNumTrees() const { return localNumTrees_; }
+    
     // Main training method - handles MPI distribution
     // numFeatures: actual number of features (without label column)
     void train(const std::vector<double>& data,
                int numFeatures,
                const std::vector<double>& labels);
     
+    // Train on a view over a shared matrix (no copy of the training partition)
+    void trainOnView(const DatasetView& view);
+    
     // Single prediction - aggregates predictions from all trees
+    // After gatherForest() this rank scores serially on its full copy of the forest;
+    // otherwise it is collective (one MPI_Allreduce of per-tree predictions per call).
+    // Either way the trees are summed in global id order
     // numFeatures: actual number of features (without label column)
     double predict(const double* sample, int numFeatures) const;
     
-    // Batch prediction - more efficient for multiple predictions
+    // Collect every process's trees on the ranks that serve predictions (collective)
+    // rootRank < 0: all ranks receive the forest; otherwise only rootRank does,
+    // and only that rank may call predict() afterwards.
+    // Trees are ordered by global tree id, independent of which rank trained them
+    void gatherForest(int rootRank = -1);
+    bool hasGlobalForest() const { return !globalForest_.empty(); }
+    
+    // Batch prediction - more efficient for multiple predictions (collective)
+    // Rows are split across ranks and scored on the id-ordered forest, in chunks; the
+    // MPI_Iallgatherv of one chunk overlaps scoring of the next. Without a prior
+    // gatherForest() on every rank, each call gathers the forest first
     // numFeatures: actual number of features (without label column)
     void predictBatch(const std::vector<double>& X,
                       int numFeatures,
@@ -46,14 +79,24 @@ public:
                   double& mse,
                   double& mae);
     
+    // Evaluation on a view; every process must pass a view with the same rows
+    void evaluateOnView(const DatasetView& view, double& mse, double& mae);
+    
     // Get feature importance aggregated from all trees
     std::vector<double> getFeatureImportance(int numFeatures) const;
     
-    // Get OOB error (only available on master process)
+    // Get OOB error over all trees; collective, every process passes the training rows
     // numFeatures: actual number of features (without label column)
     double getOOBError(const std::vector<double>& data,
                        int numFeatures,
                        const std::vector<double>& labels) const;
+    
+    // Per-tree OOB predictions recorded during training are folded in tree id order,
+    // so the result matches a single-process run bit for bit (collective)
+    double getOOBError(const DatasetView& train) const;
+    
+    // OOB permutation importance averaged over all trees; collective, empty when disabled
+    std::vector<double> getOOBPermutationImportance(int numFeatures) const;
 
 private:
     // MPI-specific members
@@ -72,14 +115,52 @@ private:
     double prunerParam_;
     uint32_t baseSeed_;
     
-    // Local trees (subset assigned to this process)
+    // Local trees (subset claimed by this process)
     std::unique_ptr<BaggingTrainer> localBagging_;
     int localNumTrees_;
     int treeOffset_;
+    bool dynamicScheduling_ = true;
     
-    // Tree assignment calculation
+    // All trees in global id order, filled by gatherForest()
+    FlatForest globalForest_;
+    
+    // Rows per non-blocking exchange, and how many exchanges may be outstanding
+    static constexpr size_t kPredictChunkRows = 8192;
+    static constexpr size_t kMaxInFlightChunks = 4;
+    
+    // Called with [begin, end) once those rows hold their final aggregated prediction
+    using ChunkCallback = std::function<void(size_t, size_t)>;
+    
+    // Aggregated predictions for every row of the view (collective)
+    // Empty on every process when the processes passed different row counts
+    void predictRows(const DatasetView& view,
+                     std::vector<double>& predictions,
+                     const ChunkCallback& onChunk = nullptr) const;
+    
+    // Gather every rank's trees into forest in global id order (collective);
+    // rootRank < 0 fills it on all ranks, otherwise only on rootRank
+    void collectForest(FlatForest& forest, int rootRank) const;
+    
+    // Static tree assignment: contiguous block of ids for a rank
     std::pair<int, int> calculateTreeAssignment(int rank, int size, int totalTrees) const;
     
+    // Dynamic tree assignment: each OpenMP thread claims one id at a time with
+    // MPI_Fetch_and_op on a counter window hosted by rank 0
+    // (collective; the window lives for one training run)
+    void trainDynamic(const DatasetView& view);
+    
+    // Whether any OpenMP thread may make (serialized) MPI calls during training
+    static bool threadsMayCallMPI();
+    
+    // Gather every rank's per-tree OOB contributions on rank 0 and fold them in
+    // global tree id order (collective); returns true on rank 0, which holds the result.
+    // numFeatures == 0 skips the permutation importance deltas
+    bool foldGlobalOOB(size_t n, int numFeatures,
+                       std::vector<double>& sums,
+                       std::vector<uint32_t>& counts,
+                       std::vector<double>& importanceSums,
+                       int& importanceTrees) const;
+    
     // Collective operations
     void gatherPredictions(const double* localPred, double* globalPred) const;
     void gatherFeatureImportance(const std::vector<double>& localImportance,
@@ -0,0 +1,114 @@
+// =============================================================================
+// include/ensemble/MPIDataLoader.hpp - MPI 分片并行加载、节点共享内存与分块集合通信
+// =============================================================================
+#pragma once
+
+#include <mpi.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "pipeline/ConstSpan.hpp"
+
+namespace mpi_data {
+
+/** 单次 MPI 调用传输的最大元素数：MPI 计数为 int，超过的部分拆成多轮 */
+constexpr size_t kMaxChunkElements = size_t(1) << 28;
+
+/** 分块广播：count 可超过 2^31 */
+void bcastChunked(double* data, size_t count, int root, MPI_Comm comm,
+                  size_t chunkElements = kMaxChunkElements);
+
+/**
+ * 分块全收集：各进程贡献 local（长度可不同），global 按进程序拼接
+ * 每轮各进程至多发送 chunkElements / size 个元素，轮数由最长的贡献决定
+ */
+void allgatherChunked(const std::vector<double>& local,
+                      std::vector<double>& global,
+                      MPI_Comm comm,
+                      size_t chunkElements = kMaxChunkElements);
+
+/**
+ * 分块变长收集（按字节，用于结构体数组）：root < 0 时全收集，否则只有 root 接收
+ * counts 返回各进程贡献的字节数（64 位），global 按进程序拼接；非接收进程的 global 为空
+ */
+void gatherBytesChunked(const void* local, size_t bytes,
+                        std::vector<char>& global,
+                        std::vector<uint64_t>& counts,
+                        int root, MPI_Comm comm,
+                        size_t chunkElements = kMaxChunkElements);
+
+/** 分块原地求和归约：count 可超过 2^31 */
+void allreduceSumChunked(double* data, size_t count, MPI_Comm comm,
+                         size_t chunkElements = kMaxChunkElements);
+
+/** 全收集后的完整数据集，每个进程上与 DataIO::readDataset 的结果相同 */
+struct ShardedDataset {
+    std::vector<double> X;
+    std::vector<double> y;
+    int rowLength = 0;       // features + 1，与 DataIO 一致
+    size_t localRows = 0;    // 本进程解析的行数
+};
+
+/**
+ * 分片并行加载（集合调用）：
+ *   - 单个文件：各进程读取 CSV 的一段字节区间（或 .dtbin / 二进制缓存的一段行）
+ *   - 多个文件 / glob：文件按进程连续分配，各自走 DataIO::readCSVFiles
+ * 随后按进程序全收集，行顺序与单进程读取相同；不支持列投影
+ */
+ShardedDataset loadSharded(const std::string& spec, MPI_Comm comm);
+
+/**
+ * 节点共享数组：同一节点（MPI_COMM_TYPE_SHARED）上的进程共用一块 MPI-3 共享内存窗口，
+ * 节点首进程分配整块，其余进程通过 MPI_Win_shared_query 取得同一块的地址
+ * 构造与析构均为 comm 上的集合调用；须在 MPI_Finalize 之前析构
+ */
+class NodeSharedArray {
+public:
+    NodeSharedArray() = default;
+    NodeSharedArray(size_t count, MPI_Comm comm);
+    ~NodeSharedArray();
+
+    NodeSharedArray(const NodeSharedArray&) = delete;
+    NodeSharedArray& operator=(const NodeSharedArray&) = delete;
+    NodeSharedArray(NodeSharedArray&& other) noexcept;
+    NodeSharedArray& operator=(NodeSharedArray&& other) noexcept;
+
+    double* data() { return base_; }
+    const double* data() const { return base_; }
+    size_t size() const { return size_; }
+
+    /** 节点内通信域（窗口的进程组）与节点内进程数 */
+    MPI_Comm nodeComm() const { return nodeComm_; }
+    int nodeRanks() const;
+
+    /** 窗口同步：写入前后调用，保证节点内其他进程看到完整数据（节点内集合调用） */
+    void fence();
+
+private:
+    void release();
+
+    MPI_Win win_ = MPI_WIN_NULL;
+    MPI_Comm nodeComm_ = MPI_COMM_NULL;
+    double* base_ = nullptr;
+    size_t size_ = 0;
+};
+
+/** 特征矩阵位于节点共享窗口中的数据集：每个节点只驻留一份 X，标签仍为各进程私有 */
+struct SharedDataset {
+    NodeSharedArray X;
+    std::vector<double> y;
+    int rowLength = 0;       // features + 1，与 DataIO 一致
+    size_t localRows = 0;    // 本进程解析的行数
+
+    ConstSpan<double> features() const { return ConstSpan<double>(X.data(), X.size()); }
+};
+
+/**
+ * 与 loadSharded 相同的分片读取，但特征矩阵写入节点共享窗口：
+ * 各进程把自己的分片拷入窗口中的全局位置，各节点首进程之间再广播其余节点的分片
+ * 行顺序与单进程读取相同；训练器通过 ConstSpan 视图原地读取
+ */
+SharedDataset loadShardedShared(const std::string& spec, MPI_Comm comm);
+
+} // namespace mpi_data
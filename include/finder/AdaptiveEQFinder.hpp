@@ -10,7 +10,7 @@ public:
           variabilityThreshold_(variabilityThreshold) {}
     
     std::tuple<int, double, double> findBestSplit(
-        const std::vector<double>& data,
+        ConstSpan<double> data,
         int rowLen,
         const std::vector<double>& labels,
         const std::vector<int>& idx,
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "tree/ISplitFinder.hpp"
+#include "histogram/PrecomputedHistograms.hpp"
 #include <string>
 
 class AdaptiveEWFinder : public ISplitFinder {
@@ -10,7 +11,7 @@ public:
         : minBins_(minBins), maxBins_(maxBins), rule_(rule) {}
     
     std::tuple<int, double, double> findBestSplit(
-        const std::vector<double>& data,
+        ConstSpan<double> data,
         int rowLen,
         const std::vector<double>& labels,
         const std::vector<int>& idx,
@@ -21,10 +22,11 @@ private:
     int minBins_;
     int maxBins_;
     std::string rule_;
+    mutable PrecomputedHistogramCache histograms_;   // 按数据与训练行缓存的预计算分桶
     
     // **新增**: 优化的自适应等宽方法
     std::tuple<int, double, double> findBestSplitAdaptiveEWOptimized(
-        const std::vector<double>& data,
+        ConstSpan<double> data,
         int rowLen,
         const std::vector<double>& labels,
         const std::vector<int>& idx,
@@ -8,10 +8,19 @@ class ExhaustiveSplitFinder : public ISplitFinder {
 public:
     
     std::tuple<int, double, double>
-    findBestSplit(const std::vector<double>& data,
+    findBestSplit(ConstSpan<double> data,
                   int                         rowLength,
                   const std::vector<double>&  labels,
                   const std::vector<int>&     indices,
                   double                      currentMetric,
                   const ISplitCriterion&      criterion) const override;
+
+    std::tuple<int, double, double>
+    findBestSplitWeighted(ConstSpan<double> data,
+                          int                         rowLength,
+                          const std::vector<double>&  labels,
+                          const std::vector<double>&  weights,
+                          const std::vector<int>&     indices,
+                          double                      currentMetric,
+                          const ISplitCriterion&      criterion) const override;
 };
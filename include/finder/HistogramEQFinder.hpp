@@ -1,25 +1,37 @@
 #pragma once
 
 #include "tree/ISplitFinder.hpp"
+#include "histogram/PrecomputedHistograms.hpp"
 
 class HistogramEQFinder : public ISplitFinder {
 public:
     explicit HistogramEQFinder(int bins = 64) : bins_(bins) {}
     
     std::tuple<int, double, double> findBestSplit(
-        const std::vector<double>& data,
+        ConstSpan<double> data,
         int rowLen,
         const std::vector<double>& labels,
         const std::vector<int>& idx,
         double parentMetric,
         const ISplitCriterion& criterion) const override;
 
+    // 加权版本：桶内累积 GOSS 权重
+    std::tuple<int, double, double> findBestSplitWeighted(
+        ConstSpan<double> data,
+        int rowLen,
+        const std::vector<double>& labels,
+        const std::vector<double>& weights,
+        const std::vector<int>& idx,
+        double parentMetric,
+        const ISplitCriterion& criterion) const override;
+
 private:
     int bins_;
+    mutable PrecomputedHistogramCache histograms_;   // 按数据与训练行缓存的预计算分桶
     
     // **新增**: 优化的等频分裂方法
     std::tuple<int, double, double> findBestSplitEqualFrequencyOptimized(
-        const std::vector<double>& data,
+        ConstSpan<double> data,
         int rowLen,
         const std::vector<double>& labels,
         const std::vector<int>& idx,
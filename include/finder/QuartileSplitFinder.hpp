@@ -5,7 +5,7 @@
 class QuartileSplitFinder : public ISplitFinder {
 public:
     std::tuple<int, double, double> findBestSplit(
-        const std::vector<double>& data,
+        ConstSpan<double> data,
         int rowLen,
         const std::vector<double>& labels,
         const std::vector<int>& idx,
@@ -1,16 +1,16 @@
 #pragma once
 
 #include "tree/ISplitFinder.hpp"
-#include <random>
 #include <tuple>
 #include <vector>
 
 class RandomSplitFinder : public ISplitFinder {
 public:
-    explicit RandomSplitFinder(int k = 10, uint32_t seed = 42)
-      : k_(k), gen_(seed) {}
+    // 每个 (节点, 特征) 的 k 个阈值来自独立的计数器型随机流，与线程数、调用顺序无关
+    explicit RandomSplitFinder(int k = 10, uint64_t seed = 42)
+      : k_(k), seed_(seed) {}
     std::tuple<int, double, double> findBestSplit(
-        const std::vector<double>& data,
+        ConstSpan<double> data,
         int rowLen,
         const std::vector<double>& labels,
         const std::vector<int>& idx,
@@ -18,5 +18,5 @@ public:
         const ISplitCriterion& criterion) const override;
 private:
     int               k_;
-    mutable std::mt19937 gen_;  
+    uint64_t          seed_;
 };
@@ -0,0 +1,119 @@
+// =============================================================================
+// include/functions/io/BinaryDataset.hpp - 二进制列存数据集缓存（内存映射加载）
+// =============================================================================
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class MappedFile;
+
+/**
+ * 源文件签名：大小 + 纳秒修改时间 + 首尾各 4 KiB 的内容哈希
+ * 文件系统时间戳按时钟节拍推进，同一节拍内的等长改写只能靠内容哈希识别
+ */
+struct SourceSignature {
+    uint64_t size = 0;
+    int64_t mtimeNs = 0;
+    uint64_t contentHash = 0;
+
+    bool operator==(const SourceSignature& o) const {
+        return size == o.size && mtimeNs == o.mtimeNs && contentHash == o.contentHash;
+    }
+};
+
+/**
+ * 文件布局（本机字节序，各段按 64 字节对齐）：
+ *   BinaryDatasetHeader
+ *   features  列存 float64 / float32，features[f * rows + i]
+ *   labels    float64[rows]
+ *   weights   float64[rows]                （可选）
+ *   bins      uint16[features * rows] 列存  （可选，预计算桶号）
+ */
+struct BinaryDatasetHeader {
+    char magic[8];                 // "DTBIN01\0"
+    uint32_t version;
+    uint32_t flags;                // kFloat32 | kHasWeights | kHasBins
+    uint64_t rows;
+    uint64_t features;
+    uint64_t sourceSize;           // 源 CSV 大小（缓存失效判定）
+    int64_t sourceMtime;           // 源 CSV 修改时间（纳秒）
+    uint64_t sourceHash;           // 源 CSV 首尾页内容哈希
+    uint32_t numBins;              // 预计算桶数（kHasBins 时有效）
+    uint32_t reserved;
+    uint64_t featuresOffset;
+    uint64_t labelsOffset;
+    uint64_t weightsOffset;
+    uint64_t binsOffset;
+    uint64_t fileSize;
+};
+
+class BinaryDataset {
+public:
+    static constexpr uint32_t kVersion = 2;
+    static constexpr uint32_t kFloat32 = 1u << 0;
+    static constexpr uint32_t kHasWeights = 1u << 1;
+    static constexpr uint32_t kHasBins = 1u << 2;
+
+    struct WriteOptions {
+        bool float32 = false;
+        const std::vector<double>* weights = nullptr;     // 长度 rows
+        const std::vector<uint16_t>* bins = nullptr;      // 列存，长度 features * rows
+        uint32_t numBins = 0;
+        SourceSignature source;
+    };
+
+    /** 映射并校验缓存文件；文件缺失或损坏时返回 nullptr */
+    static std::unique_ptr<BinaryDataset> open(const std::string& path);
+
+    /** 由行存矩阵写出缓存：先写临时文件再原子 rename，并发运行不会读到半成品 */
+    static bool write(const std::string& path,
+                      const std::vector<double>& rowMajorFeatures,
+                      const std::vector<double>& labels,
+                      size_t numFeatures,
+                      const WriteOptions& options);
+    static bool write(const std::string& path,
+                      const std::vector<float>& rowMajorFeatures,
+                      const std::vector<double>& labels,
+                      size_t numFeatures,
+                      const WriteOptions& options);
+
+    /** 计算源文件签名，文件不可访问时返回 false */
+    static bool sourceSignature(const std::string& path, SourceSignature& signature);
+
+    ~BinaryDataset();
+
+    size_t rows() const { return static_cast<size_t>(header_.rows); }
+    size_t features() const { return static_cast<size_t>(header_.features); }
+    bool isFloat32() const { return (header_.flags & kFloat32) != 0; }
+    bool hasWeights() const { return (header_.flags & kHasWeights) != 0; }
+    bool hasBins() const { return (header_.flags & kHasBins) != 0; }
+    uint32_t numBins() const { return header_.numBins; }
+    bool matchesSource(const SourceSignature& signature) const {
+        return header_.sourceSize == signature.size && header_.sourceMtime == signature.mtimeNs &&
+               header_.sourceHash == signature.contentHash;
+    }
+
+    // 零拷贝列访问（指向映射内存）
+    const double* featureColumn(size_t f) const;       // 仅 float64
+    const float* featureColumnF32(size_t f) const;     // 仅 float32
+    const double* labels() const;
+    const double* weights() const;                     // 无权重时 nullptr
+    const uint16_t* binColumn(size_t f) const;         // 无桶号时 nullptr
+
+    /** 并行转置为训练代码使用的行存矩阵 */
+    void toRowMajor(std::vector<double>& rowMajorFeatures) const;
+    void toRowMajor(std::vector<float>& rowMajorFeatures) const;
+    /** 只转置行 [rowBegin, rowEnd)（分片加载），只触及映射中对应的列段 */
+    void toRowMajor(std::vector<double>& rowMajorFeatures, size_t rowBegin, size_t rowEnd) const;
+
+private:
+    BinaryDataset() = default;
+
+    std::unique_ptr<MappedFile> file_;
+    BinaryDatasetHeader header_{};
+    const char* base_ = nullptr;
+};
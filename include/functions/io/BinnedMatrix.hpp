@@ -0,0 +1,124 @@
+// =============================================================================
+// include/functions/io/BinnedMatrix.hpp - 流式分桶矩阵（两遍扫描，不驻留 double 特征矩阵）
+// =============================================================================
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+class MappedFile;
+template <typename T> class BasicDatasetView;
+
+/** 可合并的单特征取值范围摘要（按批统计后合并） */
+struct FeatureRangeSketch {
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+
+    void add(double v) {
+        if (v < min) min = v;
+        if (v > max) max = v;
+    }
+    void merge(const FeatureRangeSketch& other) {
+        if (other.min < min) min = other.min;
+        if (other.max > max) max = other.max;
+    }
+};
+
+/**
+ * 单特征分桶：桶 b 覆盖 (upper[b-1], upper[b]]，与预测时的 value <= threshold 一致
+ *   initEqualWidth：[min, max] 等宽切分，桶号由算术定位
+ *   initFromCuts：分位数摘要给出的切点（等频），桶号二分查找
+ * 常数特征只有 1 个桶且 upper 为空
+ */
+struct FeatureBinning {
+    double vMin = 0.0;
+    double width = 0.0;         // > 0 表示等宽
+    int bins = 1;
+    std::vector<double> upper;
+
+    void initEqualWidth(double minValue, double maxValue, int maxBins);
+    void initFromCuts(const std::vector<double>& cuts, double minValue, double maxValue);
+
+    uint16_t index(double v) const {
+        if (upper.empty()) return 0;
+        if (width <= 0.0) {
+            const auto it = std::lower_bound(upper.begin(), upper.end() - 1, v);
+            return static_cast<uint16_t>(it - upper.begin());
+        }
+        int b = static_cast<int>((v - vMin) / width);
+        b = b < 0 ? 0 : (b > bins - 1 ? bins - 1 : b);
+        while (b > 0 && v <= upper[b - 1]) --b;
+        while (b < bins - 1 && v > upper[b]) ++b;
+        return static_cast<uint16_t>(b);
+    }
+};
+
+/**
+ * 由 CSV 流式构建的列存桶号矩阵：bins[f * rows + i]
+ *   第 1 遍：分批读取，合并各特征摘要（等宽：取值范围；等频：分位数摘要）并计数行数
+ *   第 2 遍：分批分桶，写入内存或磁盘溢写文件（随后只读映射）
+ * 任意时刻只驻留一个批次的 double 数据，标签常驻内存
+ */
+class BinnedMatrix {
+public:
+    /**
+     * @param spillPath 为空时桶号矩阵保存在内存，否则写到该文件并映射访问（析构时删除）
+     * @return 文件无法打开或没有数据行时返回 nullptr
+     */
+    static std::unique_ptr<BinnedMatrix> fromCSV(const std::string& filename,
+                                                 int maxBins,
+                                                 size_t batchRows = 65536,
+                                                 const std::string& spillPath = "",
+                                                 bool equalFrequency = false);
+
+    /**
+     * 由内存中的数据视图构建（桶号矩阵常驻内存），分桶规则与 fromCSV 相同
+     * T 为特征元素类型，对 double / float 显式实例化；视图行顺序即训练行顺序
+     */
+    template <typename T>
+    static std::unique_ptr<BinnedMatrix> fromView(const BasicDatasetView<T>& view,
+                                                  int maxBins,
+                                                  bool equalFrequency = false);
+
+    ~BinnedMatrix();
+
+    BinnedMatrix(const BinnedMatrix&) = delete;
+    BinnedMatrix& operator=(const BinnedMatrix&) = delete;
+
+    size_t rows() const { return rows_; }
+    int features() const { return features_; }
+    int maxBins() const { return maxBins_; }
+    bool isEqualFrequency() const { return equalFrequency_; }
+    bool isSpilled() const { return spill_ != nullptr; }
+
+    const uint16_t* binColumn(int f) const { return base_ + static_cast<size_t>(f) * rows_; }
+    const uint16_t* data() const { return base_; }
+    const FeatureBinning& binning(int f) const { return binnings_[f]; }
+    const std::vector<double>& labels() const { return labels_; }
+
+    /** 训练行的特征代表值（所在桶上界），按 value <= threshold 遍历树与原值等价 */
+    double representative(int f, size_t row) const {
+        const auto& upper = binnings_[f].upper;
+        return upper.empty() ? binnings_[f].vMin : upper[binColumn(f)[row]];
+    }
+
+private:
+    BinnedMatrix() = default;
+
+    size_t rows_ = 0;
+    int features_ = 0;
+    int maxBins_ = 0;
+    bool equalFrequency_ = false;
+    std::vector<FeatureBinning> binnings_;
+    std::vector<double> labels_;
+
+    std::vector<uint16_t> memoryBins_;
+    std::unique_ptr<MappedFile> spill_;
+    std::string spillPath_;
+    const uint16_t* base_ = nullptr;
+};
@@ -16,14 +16,57 @@
 
 class DataIO {
 public:
-    // **核心方法**
+    // **核心方法**：源文件旁存在有效的 <filename>.dtbin 缓存时直接映射加载，
+    // 否则解析 CSV 并写出缓存供后续运行复用；直接给出 .dtbin 文件时按二进制数据集加载
     std::pair<std::vector<double>, std::vector<double>>
     readCSV(const std::string& filename, int& rowLength);
 
+    // **float32 特征**：内存减半，标签仍为 double；缓存写在 <filename>.f32.dtbin，
+    // 也可复用 readCSV 的 float64 缓存
+    std::pair<std::vector<float>, std::vector<double>>
+    readCSVFloat(const std::string& filename, int& rowLength);
+
+    // **多文件加载的列投影**：按表头列名选择特征与标签，未选中的列只跳过、不解析
+    struct ColumnSelection {
+        std::vector<std::string> features;  // 为空表示除标签外的全部列（首个文件的表头顺序）
+        std::string label;                  // 为空表示最后一列
+        bool empty() const { return features.empty() && label.empty(); }
+    };
+
+    // 多个 CSV 分片并发解析到一个预分配矩阵：各文件按表头名映射列，列顺序可以不同
+    // 缺少所选列时抛出 std::runtime_error
+    std::pair<std::vector<double>, std::vector<double>>
+    readCSVFiles(const std::vector<std::string>& paths, int& rowLength,
+                 const ColumnSelection& selection = {});
+
+    // 数据集说明：逗号分隔的路径列表，每项可为 glob（如 parts/*.csv）；
+    // 单个文件且无投影时走 readCSV（含二进制缓存），否则走 readCSVFiles
+    std::pair<std::vector<double>, std::vector<double>>
+    readDataset(const std::string& spec, int& rowLength,
+                const ColumnSelection& selection = {});
+
+    // **分片读取**：numShards 个读者各取文件的一段，按 shard 顺序拼接即为完整数据集
+    // CSV 按字节均分，一行归属其首字节所在的分片；.dtbin 文件（或有效的二进制缓存）
+    // 按行均分，只转置本片行。某片不含数据行时 rowLength 为 0
+    std::pair<std::vector<double>, std::vector<double>>
+    readCSVShard(const std::string& filename, int shard, int numShards, int& rowLength);
+
+    // 展开数据集说明为文件列表（glob 结果按字典序），没有匹配的模式被忽略
+    static std::vector<std::string> expandPaths(const std::string& spec);
+    // 按分隔符切分并去掉各项首尾空白，空项丢弃
+    static std::vector<std::string> splitList(const std::string& list, char sep = ',');
+
+    // 二进制数据集缓存开关（默认开启，环境变量 DT_BINARY_CACHE=0 关闭）
+    void setBinaryCacheEnabled(bool enabled) { binaryCacheEnabled_ = enabled; }
+    bool isBinaryCacheEnabled() const { return binaryCacheEnabled_; }
+    static std::string binaryCachePath(const std::string& filename);
+    static std::string binaryCachePathF32(const std::string& filename);
+
+    // 每行一个结果，定点 10 位小数；实现同 writeResultsParallel
     void writeResults(const std::vector<double>& results,
                       const std::string& filename);
 
-    // **新增：批量处理方法（用于大文件）**
+    // **批量处理方法（用于大文件）**：同一文件的连续批次从上次的字节偏移继续
     bool readCSVBatch(const std::string& filename, 
                       std::vector<double>& flattenedFeatures,
                       std::vector<double>& labels,
@@ -31,12 +74,24 @@ public:
                       size_t batchSize = 10000,
                       size_t skipRows = 0);
 
-    // **新增：并行写入方法**
+    // 释放批量读取游标（同时解除文件映射）
+    void resetBatchCursor();
+
+    // **并行写入方法**：按 chunkSize 个值分块，多线程 to_chars 格式化，
+    // 与上一轮缓冲的顺序写出重叠进行
     void writeResultsParallel(const std::vector<double>& results,
                               const std::string& filename,
                               size_t chunkSize = 10000);
 
-    // **新增：内存映射读取方法（用于超大文件）**
+    // **二进制结果**：24 字节头部（魔数 "DTRES01"、版本、flags、数量）后接
+    // float64（或 float32）数组，一次顺序写出，无格式化开销
+    bool writeResultsBinary(const std::vector<double>& results,
+                            const std::string& filename,
+                            bool float32 = false);
+    static bool readResultsBinary(const std::string& filename,
+                                  std::vector<double>& results);
+
+    // **内存映射读取方法（用于超大文件）**：readCSV 亦基于此实现
     bool readCSVMemoryMapped(const std::string& filename,
                              std::vector<double>& flattenedFeatures,
                              std::vector<double>& labels,
@@ -57,7 +112,8 @@ public:
 
     FileStats getFileStats(const std::string& filename) const;
 
-    // **新增：流式读取接口（用于超大数据集）**
+    // **新增：流式读取接口（用于超大数据集）**：基于内存映射逐行/逐批前进，
+    // 不会整体驻留特征矩阵；文件无法打开时构造抛出 std::runtime_error
     class CSVReader {
     public:
         explicit CSVReader(const std::string& filename);
@@ -65,6 +121,11 @@ public:
         
         bool hasNext() const;
         bool readNext(std::vector<double>& features, double& label);
+        // 读取至多 maxRows 行（并行解析），返回实际行数；特征数固定为首个数据行的列数 - 1
+        size_t readBatch(std::vector<double>& flattenedFeatures,
+                         std::vector<double>& labels,
+                         size_t maxRows);
+        int numFeatures() const;
         void reset();
         
     private:
@@ -73,4 +134,11 @@ public:
     };
 
     std::unique_ptr<CSVReader> createReader(const std::string& filename);
+
+private:
+    struct BatchCursor;
+    std::shared_ptr<BatchCursor> batchCursor_;
+    bool binaryCacheEnabled_ = defaultBinaryCacheEnabled();
+
+    static bool defaultBinaryCacheEnabled();
 };
\ No newline at end of file
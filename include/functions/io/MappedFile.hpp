@@ -0,0 +1,71 @@
+// =============================================================================
+// include/functions/io/MappedFile.hpp - 只读内存映射文件（RAII）
+// =============================================================================
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <string>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define DATAIO_HAS_MMAP 1
+#endif
+
+/**
+ * 只读内存映射文件：无 mmap 的平台退化为整体读入
+ * sequential = true 时提示内核顺序预读（CSV 解析），否则提示整体预取（二进制缓存）
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& filename, bool sequential = true) {
+#ifdef DATAIO_HAS_MMAP
+        fd_ = ::open(filename.c_str(), O_RDONLY);
+        if (fd_ < 0) return;
+        struct stat st;
+        if (::fstat(fd_, &st) != 0) return;
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ == 0) { open_ = true; return; }
+        void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+        if (p == MAP_FAILED) { size_ = 0; return; }
+        ::madvise(p, size_, sequential ? MADV_SEQUENTIAL : MADV_WILLNEED);
+        data_ = static_cast<const char*>(p);
+        open_ = true;
+#else
+        (void)sequential;
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) return;
+        fallback_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        data_ = fallback_.data();
+        size_ = fallback_.size();
+        open_ = true;
+#endif
+    }
+
+    ~MappedFile() {
+#ifdef DATAIO_HAS_MMAP
+        if (data_) ::munmap(const_cast<char*>(data_), size_);
+        if (fd_ >= 0) ::close(fd_);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isOpen() const { return open_; }
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool open_ = false;
+#ifdef DATAIO_HAS_MMAP
+    int fd_ = -1;
+#else
+    std::string fallback_;
+#endif
+};
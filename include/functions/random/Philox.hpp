@@ -0,0 +1,163 @@
+// =============================================================================
+// include/functions/random/Philox.hpp
+// 计数器型随机数生成器 Philox4x32-10：输出只由 (种子, 流, 位置) 决定
+// =============================================================================
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+/**
+ * Philox4x32-10（Salmon 等, SC'11）：第 i 个 128 位块是 (key, counter = {i, 流号}) 的双射，
+ * 没有需要串行推进的内部状态
+ * - key 为 64 位种子；流号由 (用途, 树, 节点, 特征, 轮次…) 混合得到
+ * - 同一 (种子, 流) 在任何线程数 / 进程数下给出同一序列，各流互不干扰、无需加锁
+ * 满足 UniformRandomBitGenerator，可直接交给标准分布；本仓库采样统一用 below() / uniform()，
+ * 结果不依赖标准库实现
+ */
+class Philox {
+public:
+    using result_type = uint32_t;
+
+    /** 流的用途标签：同一种子下不同采样器的流互不重叠 */
+    enum Domain : uint64_t {
+        Bootstrap = 1,
+        FeatureSubsample,
+        RandomSplit,
+        OOBPermutation,
+        RowSubsample,
+        GOSS,
+        DART,
+        Shuffle
+    };
+
+    explicit Philox(uint64_t seed, uint64_t stream = 0)
+        : seed_(seed), stream_(stream) {}
+
+    /** 流号由若干标识混合，例如 Philox(seed, {Philox::RandomSplit, nodeKey, feature}) */
+    Philox(uint64_t seed, std::initializer_list<uint64_t> ids)
+        : Philox(seed, hashIds(ids)) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return 0xFFFFFFFFu; }
+
+    result_type operator()() {
+        if (pos_ == 4) {
+            block_ = block(seed_, stream_, counter_++);
+            pos_ = 0;
+        }
+        return block_[pos_++];
+    }
+
+    uint64_t next64() {
+        const uint64_t lo = (*this)();
+        return (static_cast<uint64_t>((*this)()) << 32) | lo;
+    }
+
+    /** [0, 1) 上的均匀双精度数（53 位尾数） */
+    double uniform() {
+        return static_cast<double>(next64() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    /** [0, n) 上的无偏均匀整数（拒绝采样），n 必须大于 0 */
+    uint64_t below(uint64_t n) {
+        const uint64_t threshold = (0 - n) % n;
+        uint64_t r;
+        do {
+            r = next64();
+        } while (r < threshold);
+        return r % n;
+    }
+
+    /** 跳到流中第 position 个 32 位输出（随机访问，无需逐个生成） */
+    void seek(uint64_t position) {
+        counter_ = position / 4;
+        block_ = block(seed_, stream_, counter_++);
+        pos_ = static_cast<int>(position % 4);
+    }
+
+    /**
+     * 流中第 blockIndex 个 128 位块：10 轮 Philox 变换
+     * counter = {块号低 32 位, 块号高 32 位, 流号低 32 位, 流号高 32 位}，key = {种子低 32 位, 高 32 位}
+     */
+    static std::array<uint32_t, 4> block(uint64_t seed, uint64_t stream, uint64_t blockIndex) {
+        uint32_t c0 = static_cast<uint32_t>(blockIndex);
+        uint32_t c1 = static_cast<uint32_t>(blockIndex >> 32);
+        uint32_t c2 = static_cast<uint32_t>(stream);
+        uint32_t c3 = static_cast<uint32_t>(stream >> 32);
+        uint32_t k0 = static_cast<uint32_t>(seed);
+        uint32_t k1 = static_cast<uint32_t>(seed >> 32);
+        for (int round = 0; round < 10; ++round) {
+            const uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * c0;
+            const uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * c2;
+            const uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+            const uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+            c1 = static_cast<uint32_t>(p1);
+            c3 = static_cast<uint32_t>(p0);
+            c0 = n0;
+            c2 = n2;
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+        return {c0, c1, c2, c3};
+    }
+
+    /** 把若干 64 位标识混合成一个 64 位值（splitmix64 终混） */
+    static uint64_t hashIds(std::initializer_list<uint64_t> ids) {
+        uint64_t h = 0x6A09E667F3BCC909ULL;
+        for (const uint64_t id : ids) {
+            h = mix64(h ^ id);
+        }
+        return h;
+    }
+
+    /**
+     * 树节点键：只取决于节点的行号集合，与行号排列顺序无关
+     * （串行 / 并行建树的分区顺序不同，同一节点仍得到同一随机流）
+     */
+    static uint64_t nodeKey(const std::vector<int>& indices) {
+        if (indices.empty()) return 0;
+        uint64_t sum = 0;
+        int lo = indices.front(), hi = indices.front();
+        for (const int idx : indices) {
+            sum += mix64(static_cast<uint32_t>(idx));
+            lo = idx < lo ? idx : lo;
+            hi = idx > hi ? idx : hi;
+        }
+        return hashIds({indices.size(), static_cast<uint32_t>(lo), static_cast<uint32_t>(hi), sum});
+    }
+
+    /** 部分 Fisher-Yates：把 [first, last) 的前 k 个位置换成均匀无放回样本 */
+    template <typename It>
+    void partialShuffle(It first, It last, size_t k) {
+        const size_t n = static_cast<size_t>(last - first);
+        if (k > n) k = n;
+        for (size_t i = 0; i < k && i + 1 < n; ++i) {
+            const size_t j = i + static_cast<size_t>(below(n - i));
+            std::swap(first[i], first[j]);
+        }
+    }
+
+    template <typename It>
+    void shuffle(It first, It last) {
+        partialShuffle(first, last, static_cast<size_t>(last - first));
+    }
+
+private:
+    uint64_t seed_;
+    uint64_t stream_;
+    uint64_t counter_ = 0;
+    std::array<uint32_t, 4> block_{};
+    int pos_ = 4;
+
+    static uint64_t mix64(uint64_t z) {
+        z += 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+};
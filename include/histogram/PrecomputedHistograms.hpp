@@ -7,7 +7,9 @@
 #include <string>
 #include <algorithm> 
 #include <memory>
+#include <mutex>
 #include <unordered_map>
+#include "pipeline/ConstSpan.hpp"
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -95,7 +97,7 @@ public:
     /**
      * 预处理阶段：一次性计算所有特征的直方图
      */
-    void precompute(const std::vector<double>& data,
+    void precompute(ConstSpan<double> data,
                     int rowLength,
                     const std::vector<double>& labels,
                     const std::vector<int>& sampleIndices,
@@ -112,14 +114,16 @@ public:
     
     /**
      * 快速分裂查找 - 基于预计算直方图
+     * sampleWeights 非空时按样本行号取权重，桶内累积加权和与权重和（GOSS）
      */
     std::tuple<int, double, double> findBestSplitFast(
-        const std::vector<double>& data,
+        ConstSpan<double> data,
         int rowLength,
         const std::vector<double>& labels,
         const std::vector<int>& nodeIndices,
         double parentMetric,
-        const std::vector<int>& candidateFeatures = {}) const;
+        const std::vector<int>& candidateFeatures = {},
+        const std::vector<double>* sampleWeights = nullptr) const;
     
     /**
      * 子节点直方图快速更新 - 核心优化
@@ -229,4 +233,34 @@ private:
     
     std::string generateKey(const std::vector<int>& nodeIndices, int featureIndex) const;
     void evictOldEntries();
-};
\ No newline at end of file
+};
+
+/**
+ * 分裂查找器持有的预计算结果：以 (特征矩阵, 行长, 训练行集合) 为键
+ * 换数据集或换训练行（如每棵树的 bootstrap）时重新预计算；同一棵树的并发节点共享结果
+ */
+class PrecomputedHistogramCache {
+public:
+    PrecomputedHistogramCache() = default;
+    // 拷贝查找器时不共享缓存，副本首次查找时重新预计算
+    PrecomputedHistogramCache(const PrecomputedHistogramCache&) {}
+    PrecomputedHistogramCache& operator=(const PrecomputedHistogramCache&) { return *this; }
+
+    /** trainingRows 为空表示 labels 中的全部行 */
+    std::shared_ptr<const PrecomputedHistograms> get(
+        ConstSpan<double> data,
+        int rowLength,
+        const std::vector<double>& labels,
+        const std::shared_ptr<const std::vector<int>>& trainingRows,
+        const std::string& binningType,
+        int bins);
+
+private:
+    std::mutex mutex_;
+    std::shared_ptr<const PrecomputedHistograms> histograms_;
+    const double* data_ = nullptr;
+    size_t dataSize_ = 0;
+    int rowLength_ = 0;
+    size_t numLabels_ = 0;
+    std::shared_ptr<const std::vector<int>> rows_;   // 持有引用：缓存期间该地址不会被新的行集合复用
+};
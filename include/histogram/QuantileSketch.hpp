@@ -0,0 +1,76 @@
+// =============================================================================
+// include/histogram/QuantileSketch.hpp - 可合并的加权分位数摘要（GK 风格）
+// =============================================================================
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+/**
+ * 加权分位数摘要：摘要项记录取值及其加权秩的上下界 [rmin, rmax]
+ *   - add：写入缓冲，满后排序成摘要并按层级二进制进位合并、剪枝到 maxEntries
+ *   - merge / mergeSerialized：跨 OpenMP 线程、数据批次、MPI 进程合并
+ * 内存为 O(maxEntries · log(n / maxEntries))，与行数基本无关；
+ * 秩误差约为 O(log(n / maxEntries) / maxEntries) · 总权重
+ */
+class QuantileSketch {
+public:
+    struct Entry {
+        double value;
+        double rmin;        // 严格小于 value 的权重和下界
+        double rmax;        // 不超过 value 的权重和上界
+        double wmin;        // 恰好等于 value 的权重
+
+        double rminNext() const { return rmin + wmin; }
+        double rmaxPrev() const { return rmax - wmin; }
+    };
+    using Summary = std::vector<Entry>;
+
+    explicit QuantileSketch(size_t maxEntries = 1024);
+
+    void add(double value, double weight = 1.0);
+
+    /** 并行构建：按线程分块建摘要后合并 */
+    static QuantileSketch build(const double* values, size_t n, size_t maxEntries = 1024);
+
+    void merge(const QuantileSketch& other);
+
+    /** 扁平序列化（每项 4 个 double），供 MPI 等按字节传输后合并 */
+    void serialize(std::vector<double>& out) const;
+    void mergeSerialized(const double* data, size_t count);
+
+    bool empty() const { return totalWeight_ <= 0.0; }
+    double totalWeight() const { return totalWeight_; }
+    double minValue() const { return min_; }
+    double maxValue() const { return max_; }
+
+    /** 近似 q 分位数（q ∈ [0, 1]），返回值为真实出现过的取值 */
+    double quantile(double q) const;
+
+    /**
+     * 等频分桶的上界切点：升序去重，均严格小于最大值
+     * 桶 b 覆盖 (cut[b-1], cut[b]]，最后一桶为 (cut.back(), max]
+     */
+    std::vector<double> cutPoints(int numBins) const;
+
+    /** 当前占用的摘要项数（缓冲 + 各层） */
+    size_t memoryEntries() const;
+
+private:
+    size_t maxEntries_;
+    std::vector<std::pair<double, double>> buffer_;    // (value, weight)
+    std::vector<Summary> levels_;                      // levels_[l] 为空或一个已剪枝摘要
+    double totalWeight_ = 0.0;
+    double min_ = std::numeric_limits<double>::infinity();
+    double max_ = -std::numeric_limits<double>::infinity();
+
+    void flushBuffer();
+    void pushSummary(Summary summary);
+    Summary finalSummary() const;
+
+    static Summary fromBuffer(std::vector<std::pair<double, double>> buffer);
+    static Summary combine(const Summary& a, const Summary& b);
+    static Summary prune(const Summary& s, size_t maxSize);
+    static double query(const Summary& s, double rank);
+};
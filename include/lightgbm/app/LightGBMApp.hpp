@@ -7,7 +7,9 @@
 
 
 struct LightGBMAppOptions {
-    std::string dataPath = "../data/data_clean/cleaned_data.csv";
+    std::string dataPath = "../data/data_clean/cleaned_data.csv";   // 可为逗号分隔列表或 glob
+    std::string featureColumns;        // 逗号分隔的特征列名，为空则除标签外全部
+    std::string labelColumn;           // 标签列名，为空则最后一列
     std::string objective = "regression";
     
     
@@ -20,12 +22,14 @@ struct LightGBMAppOptions {
     
     double topRate = 0.2;
     double otherRate = 0.1;
+    uint32_t seed = 42;
     
     
     int maxBin = 255;
     double maxConflictRate = 0.0;
     bool enableFeatureBundling = true;
     bool enableGOSS = true;
+    int histPoolSize = 16384;
     
     
     bool verbose = true;
@@ -44,6 +48,16 @@ struct LightGBMAppOptions {
     int maxAdaptiveBins = 128;
     double variabilityThreshold = 0.1;
     bool enableSIMD = true;
+
+    // float32 特征存储：内存中的特征矩阵减半，直接在 float 视图上分桶训练与预测
+    // （需要 histogram_ew / histogram_eq）
+    bool float32 = false;
+
+    // 流式训练（两遍分桶，不驻留 double 特征矩阵；需要 histogram_ew / histogram_eq）
+    bool streaming = false;
+    std::string testDataPath;          // 流式模式下的测试集（同样分批评估）
+    std::string binSpillPath;          // 非空时桶号矩阵溢写到磁盘
+    size_t streamBatchRows = 65536;
 };
 
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 
@@ -14,6 +15,7 @@ struct LightGBMConfig {
     
     double topRate = 0.2;             
     double otherRate = 0.1;           
+    uint32_t seed = 42;               // GOSS 随机流的种子
     
     
     int maxBin = 255;                 
@@ -31,7 +33,7 @@ struct LightGBMConfig {
     
     bool enableFeatureBundling = true; 
     bool enableGOSS = true;           
-    int histPoolSize = 16384;         
+    int histPoolSize = 16384;         // 叶子直方图池槽位上限（<=0 表示仅受 numLeaves 限制）
     
     
     std::string objective = "regression"; 
@@ -26,7 +26,9 @@ public:
         trees_.emplace_back(std::move(tree), weight);
     }
 
-    double predict(const double* sample, int rowLength) const {
+    // 样本元素类型 T 可为 double / float（float32 特征存储），累加始终为 double
+    template <typename T>
+    double predict(const T* sample, int rowLength) const {
         double prediction = baseScore_;
         for (const auto& lgbTree : trees_) {
             prediction += lgbTree.weight * predictSingleTree(lgbTree.tree.get(), sample, rowLength);
@@ -34,13 +36,14 @@ public:
         return prediction;
     }
 
-    std::vector<double> predictBatch(const std::vector<double>& X, int rowLength) const {
+    template <typename T>
+    std::vector<double> predictBatch(const std::vector<T>& X, int rowLength) const {
         size_t n = X.size() / rowLength;
         std::vector<double> predictions(n, baseScore_);
 
         for (const auto& lgbTree : trees_) {
             for (size_t i = 0; i < n; ++i) {
-                const double* sample = &X[i * rowLength];
+                const T* sample = &X[i * rowLength];
                 predictions[i] += lgbTree.weight * predictSingleTree(lgbTree.tree.get(), sample, rowLength);
             }
         }
@@ -48,6 +51,11 @@ public:
     }
 
     size_t getTreeCount() const { return trees_.size(); }
+    void truncate(size_t numTrees) {
+        while (trees_.size() > numTrees) {
+            trees_.pop_back();
+        }
+    }
     void setBaseScore(double score) { baseScore_ = score; }
     double getBaseScore() const { return baseScore_; }
 
@@ -69,10 +77,11 @@ private:
     std::vector<LGBTree> trees_;
     double baseScore_;
 
-    inline double predictSingleTree(const Node* tree, const double* sample, int ) const {
+    template <typename T>
+    inline double predictSingleTree(const Node* tree, const T* sample, int ) const {
         const Node* cur = tree;
         while (cur && !cur->isLeaf) {
-            double value = sample[cur->getFeatureIndex()];
+            const double value = static_cast<double>(sample[cur->getFeatureIndex()]);
             cur = (value <= cur->getThreshold()) ? cur->getLeft() : cur->getRight();
         }
         return cur ? cur->getPrediction() : 0.0;
@@ -5,8 +5,10 @@
 #pragma once
 
 #include <vector>
-#include <random>
+#include "functions/random/Philox.hpp"
 #include <limits>
+#include <utility>
+#include <cstdint>
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -15,11 +17,11 @@
 class GOSSSampler {
 public:
     explicit GOSSSampler(double topRate = 0.2, double otherRate = 0.1, uint32_t seed = 42)
-        : topRate_(topRate), otherRate_(otherRate), gen_(seed) {}
+        : topRate_(topRate), otherRate_(otherRate), seed_(seed) {}
 
     /** 
-     * 执行 GOSS 采样
-     * @param gradients 梯度数组
+     * 执行 GOSS 采样（基于选择而非排序，O(n)，缓冲区跨迭代复用）
+     * @param gradients 梯度数组（可以是原始梯度或 |梯度|）
      * @param sampleIndices 输出：采样后的样本索引
      * @param sampleWeights 输出：采样权重(小梯度样本需要放大权重)
      */
@@ -27,6 +29,9 @@ public:
                 std::vector<int>& sampleIndices,
                 std::vector<double>& sampleWeights) const;
 
+    /** 采样轮次归零：每次训练从第 0 轮的随机流开始，同一种子重训得到同一模型 */
+    void resetRounds() { round_ = 0; }
+
     /** 
      * 带性能监控的 GOSS 采样
      */
@@ -79,17 +84,34 @@ public:
 private:
     double topRate_;      // 大梯度保留比例
     double otherRate_;    // 小梯度采样比例  
-    mutable std::mt19937 gen_;
-
-    /** 大数据集的并行 GOSS 采样 */
-    void sampleParallel(const std::vector<double>& gradients,
-                        std::vector<int>& sampleIndices,
-                        std::vector<double>& sampleWeights) const;
-
-    /** 小数据集的串行 GOSS 采样 */
-    void sampleSerial(const std::vector<double>& gradients,
-                      std::vector<int>& sampleIndices,
-                      std::vector<double>& sampleWeights) const;
+    uint32_t seed_;
+    mutable uint64_t round_ = 0;  // 第几次采样：每次采样使用 (seed, round) 的独立随机流
+
+    /** 阈值选择用的直方图桶数 */
+    static constexpr int kSelectBins = 1024;
+
+    // 跨迭代复用的缓冲区（每轮采样不再分配）
+    mutable std::vector<int> pool_;                          // [0,topNum) 大梯度, 其余为小梯度池
+    mutable std::vector<char> topMask_;                      // 样本是否属于大梯度集合
+    mutable std::vector<std::pair<double, int>> candidates_; // 边界桶内的候选样本
+    mutable std::vector<size_t> threadHist_;                 // 线程局部直方图
+    mutable std::vector<size_t> threadCounts_;               // 线程局部计数/偏移
+
+    /** 按给定比例执行采样（sample / adaptiveSample 共用） */
+    void sampleWithRates(const std::vector<double>& gradients,
+                         double topRate,
+                         double otherRate,
+                         std::vector<int>& sampleIndices,
+                         std::vector<double>& sampleWeights) const;
+
+    /** 大数据集：并行直方图阈值选择，O(n) */
+    void selectTopParallel(const std::vector<double>& gradients, size_t topNum) const;
+
+    /** 小数据集：串行 nth_element 选择，O(n) */
+    void selectTopSerial(const std::vector<double>& gradients, size_t topNum) const;
+
+    /** 从小梯度池中无放回抽取 randNum 个（部分 Fisher-Yates，O(randNum)） */
+    void drawSmallGradients(size_t topNum, size_t randNum) const;
 
     /** 验证采样参数 */
     bool validateParameters() const {
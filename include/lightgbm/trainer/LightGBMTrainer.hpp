@@ -40,9 +40,40 @@ public:
                   double& mse,
                   double& mae) override;
 
+    /**
+     * 在预分桶矩阵上直接 boosting（流式 CSV 分桶或 float32 视图分桶），
+     * 不需要 double 特征矩阵；要求 splitMethod 为 histogram_ew / histogram_eq 且桶数一致
+     */
+    void trainBinned(const BinnedMatrix& bins);
+
+    /**
+     * 数据并行 boosting：train 只接收本进程的行分片，基准分、损失与树构建统计经 reducer 归约，
+     * 各进程得到同一模型；需 histogram_ew / histogram_eq。验证集同样按进程分片，损失全局归约
+     */
+    void setDataParallel(IDataParallelReducer* reducer);
+
     // LightGBM 专用方法
     const LightGBMModel* getLGBModel() const { return &model_; }
     const std::vector<double>& getTrainingLoss() const { return trainingLoss_; }
+    const std::vector<double>& getValidationLoss() const { return validationLoss_; }
+    int getBestIteration() const { return bestIteration_; }
+
+    void setValidationData(const std::vector<double>& X_val,
+                           const std::vector<double>& y_val,
+                           int rowLength) {
+        X_val_ = X_val;
+        y_val_ = y_val;
+        valRowLength_ = rowLength;
+        hasValidation_ = true;
+    }
+
+    // 验证集按 double 保存（只占训练数据的一小部分），float32 视图在此处展开
+    template <typename T>
+    void setValidationData(const BasicDatasetView<T>& validation) {
+        validation.materialize(X_val_, y_val_);
+        valRowLength_ = validation.numFeatures();
+        hasValidation_ = true;
+    }
 
     std::vector<double> getFeatureImportance(int numFeatures) const {
         return calculateFeatureImportance(numFeatures);
@@ -55,15 +86,27 @@ private:
     std::unique_ptr<GOSSSampler> gossSampler_;
     std::unique_ptr<FeatureBundler> featureBundler_;
     std::unique_ptr<LeafwiseTreeBuilder> treeBuilder_;
+    IDataParallelReducer* reducer_ = nullptr;
 
     // 训练时数据结构
     std::vector<double> trainingLoss_;
     std::vector<FeatureBundle> featureBundles_;
 
+    // 验证集（增量维护预测，每轮只累加最新一棵树）
+    std::vector<double> X_val_, y_val_;
+    int valRowLength_ = 0;
+    bool hasValidation_ = false;
+    std::vector<double> valPredictions_;
+    std::vector<double> validationLoss_;
+    double bestValidationLoss_ = 0.0;
+    int bestIteration_ = -1;
+
     // 内存池（预分配，避免重复分配）
     mutable std::vector<double> gradients_;
     mutable std::vector<int> sampleIndices_;
     mutable std::vector<double> sampleWeights_;
+    std::vector<double> absGradients_;
+    std::vector<double> treeOutputs_;
 
     // 私有方法
     void preprocessFeaturesOptimized(const std::vector<double>& data,
@@ -74,11 +117,6 @@ private:
     double computeLossOptimized(const std::vector<double>& labels,
                                const std::vector<double>& predictions) const;
     
-    void computeGradientsOptimized(const std::vector<double>& labels,
-                                  const std::vector<double>& predictions);
-    
-    void computeAbsGradients(std::vector<double>& absGradients) const;
-    
     void normalizeWeights(size_t n);
     
     void prepareFullSample(size_t n);
@@ -89,7 +127,25 @@ private:
                                    std::vector<double>& predictions,
                                    size_t n) const;
     
+    void computeTreeOutputs(const std::vector<double>& data,
+                            int rowLength,
+                            const Node* tree,
+                            size_t n);
+
+    // 训练行以桶上界为代表值遍历树（流式训练）
+    void computeTreeOutputsBinned(const BinnedMatrix& bins,
+                                  const Node* tree,
+                                  size_t n);
+
+    // boosting 主循环；binned 非空时 data 不被读取
+    void runBoosting(const std::vector<double>& data,
+                     int rowLength,
+                     const std::vector<double>& labels,
+                     const BinnedMatrix* binned);
+    
     bool checkEarlyStop(int currentIter) const;
+    bool checkValidationEarlyStop(int currentIter);
+    void rollbackToBestIteration();
     void initializeComponents();
     void preprocessFeatures(const std::vector<double>& data,
                             int rowLength,
@@ -98,6 +154,9 @@ private:
                                   int rowLength,
                                   size_t sampleSize);
     double computeBaseScore(const std::vector<double>& y) const;
+
+    // 本进程 n 行上的平均值 -> 所有进程的加权平均（单进程时原样返回）
+    double globalMean(double localMean, size_t n) const;
     double computeLossSerial(const std::vector<double>& labels,
                              const std::vector<double>& predictions) const;
     void computeGradientsSerial(const std::vector<double>& labels,
@@ -0,0 +1,62 @@
+#pragma once
+#include "lightgbm/trainer/LightGBMTrainer.hpp"
+#include <mpi.h>
+#include <memory>
+#include <vector>
+
+/**
+ * Data-parallel LightGBM over MPI: every process owns a row shard and builds
+ * gradient histograms on it; histograms, leaf sums, bin ranges and losses are
+ * combined with MPI_Allreduce, so every process picks the same split and ends
+ * up with the same model. The full table never has to fit on one process.
+ * Requires splitMethod histogram_ew or histogram_eq.
+ */
+class MPILightGBMTrainer {
+public:
+    explicit MPILightGBMTrainer(const LightGBMConfig& config, MPI_Comm comm = MPI_COMM_WORLD);
+    ~MPILightGBMTrainer();
+
+    // Collective: each process passes its own rows
+    // numFeatures: actual number of features (without label column)
+    void train(const std::vector<double>& localData,
+               int numFeatures,
+               const std::vector<double>& localLabels);
+
+    // Each process passes its own validation rows; the loss is reduced globally
+    void setValidationData(const std::vector<double>& localX,
+                           const std::vector<double>& localY,
+                           int numFeatures) {
+        trainer_->setValidationData(localX, localY, numFeatures);
+    }
+
+    // Local prediction: the model is replicated on every process
+    double predict(const double* sample, int numFeatures) const {
+        return trainer_->predict(sample, numFeatures);
+    }
+
+    // Collective: MSE / MAE over the union of every process's rows
+    void evaluate(const std::vector<double>& localX,
+                  int numFeatures,
+                  const std::vector<double>& localY,
+                  double& mse,
+                  double& mae);
+
+    // Collective: true when every process predicts the same value for rank 0's sample
+    // (other processes may pass nullptr)
+    bool modelsAgree(const double* sample, int numFeatures) const;
+
+    const LightGBMModel* getLGBModel() const { return trainer_->getLGBModel(); }
+    const std::vector<double>& getTrainingLoss() const { return trainer_->getTrainingLoss(); }
+    std::vector<double> getFeatureImportance(int numFeatures) const {
+        return trainer_->getFeatureImportance(numFeatures);
+    }
+
+private:
+    class Reducer;
+
+    MPI_Comm comm_;
+    int mpiRank_;
+    int mpiSize_;
+    std::unique_ptr<Reducer> reducer_;
+    std::unique_ptr<LightGBMTrainer> trainer_;
+};
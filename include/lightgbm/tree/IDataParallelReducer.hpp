@@ -0,0 +1,28 @@
+// =============================================================================
+// include/lightgbm/tree/IDataParallelReducer.hpp
+// 数据并行 boosting 的跨进程归约接口（各进程持有不同的行分片）
+// =============================================================================
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * 数据并行归约：树构建器与训练器只通过该接口交换统计量，不依赖具体通信库
+ * 所有方法都是集合调用，每个进程以相同顺序调用；结果在所有进程上相同，
+ * 因此各进程选出同一分裂、长出同一棵树
+ */
+class IDataParallelReducer {
+public:
+    virtual ~IDataParallelReducer() = default;
+
+    /** 逐元素求和，结果写回 values */
+    virtual void sum(double* values, size_t count) = 0;
+
+    /** 逐元素最小值 / 最大值（全局分桶范围） */
+    virtual void min(double* values, size_t count) = 0;
+    virtual void max(double* values, size_t count) = 0;
+
+    /** 收集各进程的变长数组，按进程序返回（分位数摘要合并） */
+    virtual std::vector<std::vector<double>> allgather(const std::vector<double>& local) = 0;
+};
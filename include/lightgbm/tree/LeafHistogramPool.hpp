@@ -0,0 +1,64 @@
+// =============================================================================
+// include/lightgbm/tree/LeafHistogramPool.hpp
+// 叶子梯度直方图池：固定容量 + LRU 淘汰，未命中时由调用方重建
+// =============================================================================
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+/** 直方图桶：加权梯度和、权重和、样本数 */
+struct GradientHistBin {
+    double sumGradients = 0.0;
+    double sumWeights = 0.0;
+    int count = 0;
+};
+
+/**
+ * 叶子直方图池
+ * 每个槽位保存一个叶子在所有特征上的直方图（numFeatures * maxBins 个桶）。
+ * 槽位按需分配、跨树复用；容量用满后淘汰最久未使用的叶子。
+ */
+class LeafHistogramPool {
+public:
+    /** 重置映射关系（保留已分配槽位），形状变化时释放旧槽位 */
+    void reset(size_t capacity, size_t binsPerHistogram);
+
+    /** 查询叶子直方图，命中时刷新 LRU；未命中返回 nullptr */
+    GradientHistBin* get(int leafId);
+
+    /** 为新叶子分配槽位（可能淘汰 LRU 叶子），内容未初始化 */
+    GradientHistBin* acquire(int leafId);
+
+    /** 槽位改归属（父直方图原地减去小孩子后即为大孩子） */
+    void rename(int fromLeafId, int toLeafId);
+
+    /** 叶子定型后归还槽位 */
+    void release(int leafId);
+
+    size_t capacity() const { return capacity_; }
+    size_t binsPerHistogram() const { return binsPerHistogram_; }
+
+    struct Stats {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t evictions = 0;
+    };
+    const Stats& getStats() const { return stats_; }
+
+private:
+    size_t capacity_ = 0;
+    size_t binsPerHistogram_ = 0;
+
+    std::vector<std::vector<GradientHistBin>> slots_;
+    std::vector<int> slotOwner_;                      // 槽位 -> 叶子 ID（-1 表示空闲）
+    std::vector<std::list<int>::iterator> lruPos_;    // 槽位在 LRU 链表中的位置
+    std::list<int> lru_;                              // 前端为最近使用的槽位
+    std::vector<int> freeSlots_;
+    std::unordered_map<int, int> leafToSlot_;
+    Stats stats_;
+
+    void touch(int slot);
+};
@@ -1,6 +1,6 @@
 // =============================================================================
 // include/lightgbm/tree/LeafwiseTreeBuilder.hpp
-// 深度 OpenMP 并行优化版本（减少锁竞争、提高阈值、预分配缓冲）
+// 深度 OpenMP 并行优化版本（叶子区间 + 直方图池、预分配缓冲）
 // =============================================================================
 #pragma once
 
@@ -10,6 +10,11 @@
 #include "lightgbm/core/LightGBMConfig.hpp"
 #include "lightgbm/sampling/GOSSSampler.hpp"
 #include "lightgbm/feature/FeatureBundler.hpp"
+#include "lightgbm/tree/LeafHistogramPool.hpp"
+#include "lightgbm/tree/IDataParallelReducer.hpp"
+#include "functions/io/BinnedMatrix.hpp"
+#include "histogram/QuantileSketch.hpp"
+#include <cstdint>
 #include <queue>
 #include <memory>
 #include <vector>
@@ -20,10 +25,19 @@
 /** 叶子节点信息（用于优先队列） */
 struct LeafInfo {
     Node* node;
-    std::vector<int> sampleIndices;
+    int begin;                  // 在共享划分索引数组中的区间 [begin, end)
+    int end;
+    long long count;            // 样本数：数据并行时为各进程之和，否则等于 size()
+    int leafId;                 // 直方图池键
+    double sumGradients;        // 加权目标和
+    double sumWeights;          // 权重和
     double splitGain;
     int bestFeature;
     double bestThreshold;
+    int bestBin;                // 直方图路径下的分裂桶（-1 表示按阈值划分）
+
+    int size() const { return end - begin; }
+
     // Comparator: 按 splitGain 大小排序
     bool operator<(const LeafInfo& other) const {
         return splitGain < other.splitGain;
@@ -38,10 +52,8 @@ public:
                         std::unique_ptr<ISplitCriterion> criterion)
         : config_(config), finder_(std::move(finder)), criterion_(std::move(criterion)) {
         tempIndices_.reserve(10000);
-        leftIndices_.reserve(5000);
-        rightIndices_.reserve(5000);
-        leftWeights_.reserve(5000);
-        rightWeights_.reserve(5000);
+        histogramBins_ = parseHistogramBins();
+        equalFrequency_ = config_.splitMethod.rfind("histogram_eq", 0) == 0;
     }
 
     /**
@@ -51,7 +63,7 @@ public:
      * @param labels 原始标签（未使用，仅作兼容）
      * @param targets 残差/梯度
      * @param sampleIndices GOSS 采样的样本索引
-     * @param sampleWeights GOSS 采样的权重
+     * @param sampleWeights GOSS 采样的权重（与 sampleIndices 按位置对应）
      * @param bundles 特征绑定信息
      */
     std::unique_ptr<Node> buildTree(const std::vector<double>& data,
@@ -62,6 +74,26 @@ public:
                                     const std::vector<double>& sampleWeights,
                                     const std::vector<FeatureBundle>& bundles);
 
+    /**
+     * 使用外部（流式构建的）桶号矩阵训练：buildTree 不再读取 data，
+     * 分桶方式与桶数须与 histogram_ew / histogram_eq 配置一致；传 nullptr 恢复内部分桶
+     */
+    void setExternalBins(const BinnedMatrix* bins);
+
+    /**
+     * 数据并行：各进程只持有行分片，分桶范围、叶子统计与直方图经 reducer 全局归约，
+     * 所有进程长出同一棵树；仅支持内部分桶的 histogram_ew / histogram_eq。传 nullptr 恢复单进程
+     */
+    void setReducer(IDataParallelReducer* reducer);
+
+    /**
+     * 丢弃缓存的分桶数据：缓存按数据指针与维度识别，同一地址上的新数据无法区分，
+     * 每次训练开始时必须调用
+     */
+    void invalidateBinnedData();
+
+    const LeafHistogramPool::Stats& getHistogramPoolStats() const { return histPool_.getStats(); }
+
 private:
     const LightGBMConfig& config_;
     std::unique_ptr<ISplitFinder> finder_;
@@ -70,54 +102,74 @@ private:
     // Max-heap: 当前待分裂的叶子
     std::priority_queue<LeafInfo> leafQueue_;
 
-    // 预分配内存池
+    // 共享划分索引数组：每个叶子是其中一段连续区间
+    std::vector<int> order_;
+    std::vector<int> partitionBuffer_;
+    std::vector<size_t> threadLeftCounts_;
+    int nextLeafId_ = 0;
+
+    // 通用 finder 路径的临时索引
     std::vector<int> tempIndices_;
-    std::vector<int> leftIndices_, rightIndices_;
-    std::vector<double> leftWeights_, rightWeights_;
-
-    // 单次分裂局部缓冲，避免并行内多次分配
-    std::vector<LeafInfo> localNewLeafInfos_;
-
-    // 串行版：保留原有接口
-    bool findBestSplitSerial(const std::vector<double>& data,
-                             int rowLength,
-                             const std::vector<double>& targets,
-                             const std::vector<int>& indices,
-                             const std::vector<double>& weights,
-                             LeafInfo& leafInfo);
-
-    void splitLeafSerial(LeafInfo& leafInfo,
-                         const std::vector<double>& data,
-                         int rowLength,
-                         const std::vector<double>& targets,
-                         const std::vector<double>& sampleWeights);
-
-    // 并行版：在需要时调用
-    bool findBestSplitParallel(const std::vector<double>& data,
-                               int rowLength,
-                               const std::vector<double>& targets,
-                               const std::vector<int>& indices,
-                               const std::vector<double>& weights,
-                               LeafInfo& leafInfo);
-
-    void splitLeafParallel(LeafInfo& leafInfo,
-                           const std::vector<double>& data,
-                           int rowLength,
-                           const std::vector<double>& targets,
-                           const std::vector<double>& sampleWeights);
-
-    double computeLeafPredictionSerial(const std::vector<int>& indices,
-                                       const std::vector<double>& targets,
-                                       const std::vector<double>& weights) const;
-
-    double computeLeafPredictionParallel(const std::vector<int>& indices,
-                                         const std::vector<double>& targets,
-                                         const std::vector<double>& weights) const;
-
-    void processRemainingLeavesSerial(const std::vector<double>& targets,
-                                      const std::vector<double>& sampleWeights);
-
-    void processRemainingLeavesParallel(const std::vector<double>& targets,
-                                        const std::vector<double>& sampleWeights);
-};
 
+    // 按样本行号展开的权重（与 targets 同索引），分裂时无需同步搬运
+    std::vector<double> rowWeights_;
+    bool weighted_ = false;
+
+    // **直方图路径**（splitMethod = histogram_ew|histogram_eq[:bins]）：全数据一次分桶，跨树复用
+    int histogramBins_ = 0;                         // 0 表示使用通用 finder
+    bool equalFrequency_ = false;                   // histogram_eq：分位数摘要切点
+    int numFeatures_ = 0;
+    size_t numRows_ = 0;
+    const double* binnedSource_ = nullptr;
+    std::vector<uint16_t> binnedData_;              // 列存：binnedData_[f * numRows_ + row]
+    const BinnedMatrix* externalBins_ = nullptr;    // 流式训练时替代 binnedData_
+    const uint16_t* binBase_ = nullptr;             // 当前使用的列存桶号
+    std::vector<std::vector<double>> binUpperBounds_;  // 桶 b 覆盖 (upper[b-1], upper[b]]
+    std::vector<int> featureBins_;
+    LeafHistogramPool histPool_;
+
+    // 数据并行归约（为空表示单进程）与直方图打包缓冲
+    IDataParallelReducer* reducer_ = nullptr;
+    std::vector<double> reduceBuffer_;
+
+    int parseHistogramBins() const;
+
+    // 数据并行时把本进程的直方图替换为全局直方图
+    void reduceHistogram(GradientHistBin* hist);
+
+    // 各特征的全局分桶：等宽取全局范围，等频合并各进程的分位数摘要
+    void globalBinnings(std::vector<FeatureRangeSketch>& ranges,
+                        std::vector<QuantileSketch>& sketches,
+                        std::vector<FeatureBinning>& binnings);
+
+    void prepareBinnedData(const std::vector<double>& data, int rowLength, size_t numRows);
+
+    void buildLeafHistogram(const LeafInfo& leaf,
+                            const std::vector<double>& targets,
+                            GradientHistBin* hist) const;
+
+    bool findBestSplitFromHistogram(const GradientHistBin* hist, LeafInfo& leaf) const;
+
+    bool findBestSplitWithFinder(const std::vector<double>& data,
+                                 int rowLength,
+                                 const std::vector<double>& targets,
+                                 LeafInfo& leaf);
+
+    // 为新叶子准备直方图（如需要）并寻找最佳分裂
+    bool evaluateLeaf(const std::vector<double>& data,
+                      int rowLength,
+                      const std::vector<double>& targets,
+                      LeafInfo& leaf);
+
+    void computeLeafSums(LeafInfo& leaf, const std::vector<double>& targets);
+
+    // 原地划分 order_[begin, end)，返回左右分界
+    int partitionLeaf(const LeafInfo& leaf, const std::vector<double>& data, int rowLength);
+
+    void splitLeaf(LeafInfo& leaf,
+                   const std::vector<double>& data,
+                   int rowLength,
+                   const std::vector<double>& targets);
+
+    void finalizeLeaf(const LeafInfo& leaf);
+};
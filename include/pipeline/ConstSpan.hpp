@@ -0,0 +1,32 @@
+// =============================================================================
+// include/pipeline/ConstSpan.hpp - 只读连续数组视图（C++17 下的轻量 span）
+// =============================================================================
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * 指针 + 长度的非拥有只读视图：可由 std::vector 隐式构造，也可指向外部内存
+ * （如 MPI 共享内存窗口），使建树代码不依赖特征矩阵的存放方式
+ */
+template <typename T>
+class ConstSpan {
+public:
+    using value_type = T;
+
+    ConstSpan() = default;
+    ConstSpan(const T* data, size_t size) : data_(data), size_(size) {}
+    ConstSpan(const std::vector<T>& v) : data_(v.data()), size_(v.size()) {}  // NOLINT: 隐式转换
+
+    const T& operator[](size_t i) const { return data_[i]; }
+    const T* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+
+private:
+    const T* data_ = nullptr;
+    size_t size_ = 0;
+};
@@ -1,13 +1,17 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <utility>
 #include <vector>
+#include "pipeline/DatasetView.hpp"
 
 struct DataParams {
     std::vector<double> X_train;
     std::vector<double> y_train;
     std::vector<double> X_test;
     std::vector<double> y_test;
-    int rowLength; 
+    int rowLength;
 };
 
 
@@ -15,3 +19,53 @@ bool splitDataset(const std::vector<double>& X,
                   const std::vector<double>& y,
                   int rowLength,
                   DataParams& out);
+
+/** 训练 / 验证 / 测试视图，均共享同一份 X、y（validation 可为空） */
+template <typename T>
+struct BasicDataViews {
+    BasicDatasetView<T> train;
+    BasicDatasetView<T> validation;
+    BasicDatasetView<T> test;
+    int rowLength;              // 特征数
+};
+
+using DataViews = BasicDataViews<double>;
+using DataViewsF32 = BasicDataViews<float>;
+
+/**
+ * 顺序划分：前 trainRatio 为训练集，随后 valRatio 为验证集，其余为测试集
+ * rowLength 与 splitDataset 相同，为 DataIO 给出的 features+1
+ * 以下划分函数对 double / float 特征显式实例化
+ */
+template <typename T>
+BasicDataViews<T> splitViews(const std::vector<T>& X,
+                             const std::vector<double>& y,
+                             int rowLength,
+                             double trainRatio = 0.8,
+                             double valRatio = 0.0);
+
+/** 顺序划分外部内存中的特征矩阵（如 MPI 节点共享窗口），视图不持有 vector */
+DataViews splitViews(ConstSpan<double> X,
+                     const std::vector<double>& y,
+                     int rowLength,
+                     double trainRatio = 0.8,
+                     double valRatio = 0.0);
+
+/** 打乱后划分：只打乱行号，不移动特征数据 */
+template <typename T>
+BasicDataViews<T> shuffledSplitViews(const std::vector<T>& X,
+                                     const std::vector<double>& y,
+                                     int rowLength,
+                                     double trainRatio,
+                                     double valRatio,
+                                     uint32_t seed);
+
+/** k 折交叉验证：返回 k 对 (训练视图, 验证视图)，shuffle 时按 seed 打乱行号 */
+template <typename T>
+std::vector<std::pair<BasicDatasetView<T>, BasicDatasetView<T>>>
+kFoldViews(const std::vector<T>& X,
+           const std::vector<double>& y,
+           int rowLength,
+           int k,
+           bool shuffle = true,
+           uint32_t seed = 42);
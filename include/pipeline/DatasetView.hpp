@@ -0,0 +1,149 @@
+// =============================================================================
+// include/pipeline/DatasetView.hpp - 共享矩阵上的轻量数据视图（不拷贝特征）
+// =============================================================================
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <numeric>
+#include <vector>
+#include "pipeline/ConstSpan.hpp"
+
+/**
+ * 行存矩阵 X（n × numFeatures）与标签 y 上的非拥有视图：
+ *   - 连续行区间 [begin, end)（顺序划分）
+ *   - 共享的行号列表（打乱划分、k 折、子采样）
+ * 视图只保存指针与行号，划分代价为 O(行数) 个索引；底层 X / y 须比视图活得久
+ * X 可以是 std::vector，也可以是外部内存（ConstSpan，如 MPI 节点共享窗口）
+ * T 为特征元素类型（double / float），标签始终为 double
+ */
+template <typename T>
+class BasicDatasetView {
+public:
+    using value_type = T;
+
+    BasicDatasetView() = default;
+
+    /** 整个矩阵 */
+    BasicDatasetView(const std::vector<T>& X, const std::vector<double>& y, int numFeatures)
+        : X_(X), xVec_(&X), y_(&y), numFeatures_(numFeatures), begin_(0), end_(y.size()) {}
+
+    /** 特征位于外部内存：data() 不可用，其余接口与 vector 视图一致 */
+    BasicDatasetView(ConstSpan<T> X, const std::vector<double>& y, int numFeatures)
+        : X_(X), y_(&y), numFeatures_(numFeatures), begin_(0), end_(y.size()) {}
+
+    static BasicDatasetView range(const std::vector<T>& X, const std::vector<double>& y,
+                                  int numFeatures, size_t begin, size_t end) {
+        BasicDatasetView v(X, y, numFeatures);
+        v.begin_ = begin;
+        v.end_ = end;
+        return v;
+    }
+
+    static BasicDatasetView range(ConstSpan<T> X, const std::vector<double>& y,
+                                  int numFeatures, size_t begin, size_t end) {
+        BasicDatasetView v(X, y, numFeatures);
+        v.begin_ = begin;
+        v.end_ = end;
+        return v;
+    }
+
+    /** 无标签视图（仅用于预测），不可调用 label() / labels() */
+    static BasicDatasetView unlabeled(const std::vector<T>& X, int numFeatures) {
+        BasicDatasetView v;
+        v.X_ = X;
+        v.xVec_ = &X;
+        v.numFeatures_ = numFeatures;
+        v.end_ = numFeatures > 0 ? X.size() / numFeatures : 0;
+        return v;
+    }
+
+    static BasicDatasetView indexed(const std::vector<T>& X, const std::vector<double>& y,
+                                    int numFeatures, std::shared_ptr<const std::vector<int>> rows) {
+        BasicDatasetView v(X, y, numFeatures);
+        v.begin_ = 0;
+        v.end_ = rows ? rows->size() : 0;
+        v.rows_ = std::move(rows);
+        return v;
+    }
+
+    static BasicDatasetView indexed(ConstSpan<T> X, const std::vector<double>& y,
+                                    int numFeatures, std::shared_ptr<const std::vector<int>> rows) {
+        BasicDatasetView v(X, y, numFeatures);
+        v.begin_ = 0;
+        v.end_ = rows ? rows->size() : 0;
+        v.rows_ = std::move(rows);
+        return v;
+    }
+
+    size_t size() const { return end_ - begin_; }
+    bool empty() const { return size() == 0; }
+    int numFeatures() const { return numFeatures_; }
+    bool isContiguous() const { return rows_ == nullptr; }
+
+    /** 底层特征存放在 std::vector 中（data() 可用） */
+    bool isVectorBacked() const { return xVec_ != nullptr; }
+
+    /** 视图恰好覆盖整个底层矩阵（可直接把底层 vector 交给旧接口） */
+    bool coversAll() const {
+        return xVec_ && y_ && isContiguous() && begin_ == 0 && end_ == y_->size();
+    }
+
+    /** 视图第 i 行在底层矩阵中的行号 */
+    int rowId(size_t i) const {
+        return rows_ ? (*rows_)[begin_ + i] : static_cast<int>(begin_ + i);
+    }
+    const T* sample(size_t i) const {
+        return X_.data() + static_cast<size_t>(rowId(i)) * numFeatures_;
+    }
+    double label(size_t i) const { return (*y_)[rowId(i)]; }
+
+    const std::vector<T>& data() const { return *xVec_; }
+    ConstSpan<T> features() const { return X_; }
+    const std::vector<double>& labels() const { return *y_; }
+
+    /** 底层行号列表（区间视图按需生成） */
+    std::vector<int> rowIndices() const {
+        if (rows_) return std::vector<int>(rows_->begin() + begin_, rows_->begin() + end_);
+        std::vector<int> ids(size());
+        std::iota(ids.begin(), ids.end(), static_cast<int>(begin_));
+        return ids;
+    }
+
+    /** 视图内 [from, to) 的子视图，仍共享同一行号列表 */
+    BasicDatasetView slice(size_t from, size_t to) const {
+        BasicDatasetView v = *this;
+        v.begin_ = begin_ + from;
+        v.end_ = begin_ + to;
+        return v;
+    }
+
+    /** 拷贝成紧凑矩阵（可转换元素类型）：仅供只接受 vector 的旧接口使用 */
+    template <typename U>
+    void materialize(std::vector<U>& X, std::vector<double>& y) const {
+        const size_t n = size();
+        const size_t d = static_cast<size_t>(numFeatures_);
+        X.resize(n * d);
+        y.resize(n);
+        #pragma omp parallel for schedule(static) if(n * d > 100000)
+        for (size_t i = 0; i < n; ++i) {
+            const T* src = sample(i);
+            std::transform(src, src + d, X.data() + i * d,
+                           [](T v) { return static_cast<U>(v); });
+            y[i] = label(i);
+        }
+    }
+
+private:
+    ConstSpan<T> X_;
+    const std::vector<T>* xVec_ = nullptr;             // 非 vector 存放时为空
+    const std::vector<double>* y_ = nullptr;
+    int numFeatures_ = 0;
+    size_t begin_ = 0;
+    size_t end_ = 0;
+    std::shared_ptr<const std::vector<int>> rows_;     // 为空表示连续区间
+};
+
+using DatasetView = BasicDatasetView<double>;
+using DatasetViewF32 = BasicDatasetView<float>;
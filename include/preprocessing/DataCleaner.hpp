@@ -1,66 +1,119 @@
+// =============================================================================
+// include/preprocessing/DataCleaner.hpp - 列存并行数据清洗（行选择位图 + 流式模式）
+// =============================================================================
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 
 namespace preprocessing {
 
+/** 列存数据表：values[c * rows + i]，首行表头单独保存 */
+struct ColumnTable {
+    std::vector<std::string> headers;
+    size_t rows = 0;
+    size_t columns = 0;
+    std::vector<double> values;
+
+    const double* column(size_t c) const { return values.data() + c * rows; }
+    double* column(size_t c) { return values.data() + c * rows; }
+};
+
+/**
+ * 行选择位图：第 i 位为 1 表示保留该行
+ * 过滤只清除位，不移动或拷贝行；多个过滤器依次作用即为取交集
+ */
+class RowSelection {
+public:
+    RowSelection() = default;
+    explicit RowSelection(size_t rows);
+
+    size_t rows() const { return rows_; }
+    bool test(size_t i) const { return (words_[i >> 6] >> (i & 63)) & 1u; }
+    void reset(size_t i) { words_[i >> 6] &= ~(uint64_t(1) << (i & 63)); }
+
+    /** 保留的行数 */
+    size_t count() const;
+
+    /** 按 64 行一个字访问：并行过滤按字划分，线程之间不写同一个字 */
+    size_t numWords() const { return words_.size(); }
+    uint64_t& word(size_t w) { return words_[w]; }
+
+private:
+    size_t rows_ = 0;
+    std::vector<uint64_t> words_;
+};
+
 class DataCleaner {
 public:
+    /** 流式模式下表示最后一列（列数在读到首个数据行之前未知） */
+    static constexpr size_t kLastColumn = static_cast<size_t>(-1);
+
+    /** 流式清洗结果 */
+    struct CleanStats {
+        size_t rows = 0;
+        size_t kept = 0;
+    };
+
     /**
-     * 读取 CSV 文件，返回数据矩阵（行优先）并输出表头列名
+     * 读取 CSV 文件为列存表（分批并行解析，批内直接转置写入各列）
      * @param filePath 文件路径
-     * @param headers 输出：列名列表
-     * @param data 输出：二维数据矩阵
+     * @param batchRows 每批解析的行数
      */
-    static void readCSV(const std::string& filePath,
-                        std::vector<std::string>& headers,
-                        std::vector<std::vector<double>>& data);
+    static ColumnTable readCSV(const std::string& filePath, size_t batchRows = 65536);
 
     /**
-     * 将数据矩阵写入 CSV 文件，首行为表头
-     * @param filePath 输出文件路径
-     * @param headers 列名列表
-     * @param data 数据矩阵
+     * 将数据表写入 CSV 文件，首行为表头
+     * @param selection 为空时写出全部行，否则只写出被选中的行
      */
     static void writeCSV(const std::string& filePath,
-                         const std::vector<std::string>& headers,
-                         const std::vector<std::vector<double>>& data);
+                         const ColumnTable& table,
+                         const RowSelection* selection = nullptr);
 
     /**
-     * 基于 Z 分数去除指定列的异常值
-     * @param data 输入数据矩阵
-     * @param colIndex 要检测的列索引
-     * @param zThreshold Z 分数阈值
-     * @return 去除异常行后的新矩阵
+     * 基于 Z 分数标记指定列的异常值：清除 keep 中 |z| > zThreshold 的行
+     * 均值与方差为并行归约，标记按位图字并行
      */
-    static std::vector<std::vector<double>> removeOutliers(const std::vector<std::vector<double>>& data,
-                                                            size_t colIndex,
-                                                            double zThreshold = 3.0);
+    static void removeOutliers(const ColumnTable& table,
+                               size_t colIndex,
+                               double zThreshold,
+                               RowSelection& keep);
 
     /**
      * 等频分箱
-     * @param values 输入数值向量
+     * @param values 输入数值
+     * @param n 数值个数
      * @param numBins 分箱数量
      * @return 每个值所属的分箱索引
      */
-    static std::vector<int> equalFrequencyBinning(const std::vector<double>& values,
-                                                   int numBins);
+    static std::vector<int> equalFrequencyBinning(const double* values, size_t n, int numBins);
+    static std::vector<int> equalFrequencyBinning(const std::vector<double>& values, int numBins);
 
     /**
-     * 在两个维度上先分箱再去除异常值
-     * @param data 输入数据矩阵
+     * 在两个维度上先分箱再标记异常值：分箱 b 由 X 或 Y 落在第 b 箱的行组成，
+     * 以最后一列在箱内的 Z 分数判定；行在其所属的任一箱内异常即被清除
      * @param colX 第一个分箱维度列索引
      * @param colY 第二个分箱维度列索引
-     * @param numBins 分箱数
-     * @param zThreshold Z 分数阈值
-     * @return 去除异常后的新矩阵
      */
-    static std::vector<std::vector<double>> removeOutliersByBinning(const std::vector<std::vector<double>>& data,
-                                                                    size_t colX,
-                                                                    size_t colY,
-                                                                    int numBins,
-                                                                    double zThreshold = 3.0);
+    static void removeOutliersByBinning(const ColumnTable& table,
+                                        size_t colX,
+                                        size_t colY,
+                                        int numBins,
+                                        double zThreshold,
+                                        RowSelection& keep);
+
+    /**
+     * 流式 Z 分数清洗（文件可大于内存）：统计预扫描一遍得到均值与方差，
+     * 第二遍分批过滤并直接写出保留行，任意时刻只驻留一个批次
+     * @param colIndex 检测的列索引，kLastColumn 表示最后一列
+     */
+    static CleanStats cleanStreaming(const std::string& inPath,
+                                     const std::string& outPath,
+                                     size_t colIndex,
+                                     double zThreshold,
+                                     size_t batchRows = 65536);
 };
 
-} // namespace preprocessing
\ No newline at end of file
+} // namespace preprocessing
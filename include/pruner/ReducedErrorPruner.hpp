@@ -1,6 +1,7 @@
 #pragma once
 
 #include "tree/IPruner.hpp"
+#include "pipeline/DatasetView.hpp"
 #include <vector>
 
 
@@ -8,12 +9,13 @@ class ReducedErrorPruner : public IPruner {
 public:
     ReducedErrorPruner(const std::vector<double>& X_val, int rowLen,
                        const std::vector<double>& y_val)
-        : Xv_(X_val), D_(rowLen), yv_(y_val) {}
+        : val_(X_val, y_val, rowLen) {}
+    /** 验证集为共享矩阵上的视图（不拷贝） */
+    explicit ReducedErrorPruner(const DatasetView& validation)
+        : val_(validation) {}
     void prune(std::unique_ptr<Node>& root) const override;
 private:
-    const std::vector<double>& Xv_;
-    int D_;
-    const std::vector<double>& yv_;
+    DatasetView val_;
     double validate(Node* node) const;              
     void pruneRec(std::unique_ptr<Node>& node) const;
 };
@@ -9,4 +9,11 @@ public:
     
     virtual double nodeMetric(const std::vector<double>& labels,
                               const std::vector<int>& indices) const = 0;
+
+    /** 加权节点指标（weights 按样本行号索引）；默认忽略权重 */
+    virtual double nodeMetricWeighted(const std::vector<double>& labels,
+                                      const std::vector<double>& /* weights */,
+                                      const std::vector<int>& indices) const {
+        return nodeMetric(labels, indices);
+    }
 };
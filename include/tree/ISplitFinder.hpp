@@ -1,9 +1,15 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <numeric>
 #include <tuple>
 #include <vector>
 #include "Node.hpp"
 #include "ISplitCriterion.hpp"
+#include "pipeline/ConstSpan.hpp"
+#include "functions/random/Philox.hpp"
 
 class ISplitFinder {
 public:
@@ -11,10 +17,74 @@ public:
 
     
     virtual std::tuple<int, double, double>
-    findBestSplit(const std::vector<double>& data,
+    findBestSplit(ConstSpan<double> data,
                   int rowLength,
                   const std::vector<double>& labels,
                   const std::vector<int>& indices,
                   double currentMetric,
                   const ISplitCriterion& criterion) const = 0;
+
+    /**
+     * 加权分裂查找：weights 与 labels 一样按样本行号索引（GOSS 放大权重等）
+     * currentMetric 应为加权节点指标；默认实现忽略权重，退化为无权版本
+     */
+    virtual std::tuple<int, double, double>
+    findBestSplitWeighted(ConstSpan<double> data,
+                          int rowLength,
+                          const std::vector<double>& labels,
+                          const std::vector<double>& /* weights */,
+                          const std::vector<int>& indices,
+                          double currentMetric,
+                          const ISplitCriterion& criterion) const {
+        return findBestSplit(data, rowLength, labels, indices, currentMetric, criterion);
+    }
+
+    /**
+     * 限定训练行：数据视图共享整个矩阵训练时，预计算直方图只应统计这些行
+     * 为空表示 labels 中的全部行
+     */
+    void setTrainingRows(std::shared_ptr<const std::vector<int>> rows) {
+        trainingRows_ = std::move(rows);
+    }
+
+    /** 预计算使用的行号：已限定时为训练行，否则为 0..numRows-1 */
+    std::vector<int> trainingRowsOr(size_t numRows) const {
+        if (trainingRows_) return *trainingRows_;
+        std::vector<int> all(numRows);
+        std::iota(all.begin(), all.end(), 0);
+        return all;
+    }
+
+    /**
+     * 随机森林特征子采样：每次分裂只评估 maxFeatures 个随机候选特征
+     * maxFeatures <= 0 表示评估全部特征（默认）
+     */
+    void setFeatureSubsampling(int maxFeatures, uint64_t seed) {
+        maxFeatures_ = maxFeatures;
+        featureSeed_ = seed;
+    }
+
+    int maxFeatures() const { return maxFeatures_; }
+
+    /**
+     * 本节点评估的特征列表（升序）：未启用子采样时为 0..numFeatures-1
+     * 候选集只由种子与节点样本决定，与线程调度无关，可复现
+     */
+    std::vector<int> candidateFeatures(int numFeatures, const std::vector<int>& indices) const {
+        std::vector<int> features(numFeatures);
+        std::iota(features.begin(), features.end(), 0);
+        if (maxFeatures_ <= 0 || maxFeatures_ >= numFeatures || indices.empty()) return features;
+
+        // **计数器型随机流**：由种子与节点键（节点行号集合）决定
+        Philox rng(featureSeed_, {Philox::FeatureSubsample, Philox::nodeKey(indices)});
+        rng.partialShuffle(features.begin(), features.end(), static_cast<size_t>(maxFeatures_));
+        features.resize(maxFeatures_);
+        std::sort(features.begin(), features.end());
+        return features;
+    }
+
+protected:
+    std::shared_ptr<const std::vector<int>> trainingRows_;
+    int maxFeatures_ = 0;
+    uint64_t featureSeed_ = 0;
 };
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cmath>
 #include <vector>
 #include "Node.hpp"
+#include "pipeline/DatasetView.hpp"
 
 class ITreeTrainer {
 public:
@@ -20,6 +22,38 @@ public:
                           double& mse,
                           double& mae) = 0;
 
+    /**
+     * 在数据视图上训练：默认实现仅在视图不是整个矩阵时拷贝训练行，
+     * 能按行号直接访问共享矩阵的训练器应覆盖为零拷贝版本
+     */
+    virtual void trainOnView(const DatasetView& view) {
+        if (view.coversAll()) {
+            train(view.data(), view.numFeatures(), view.labels());
+            return;
+        }
+        std::vector<double> X, y;
+        view.materialize(X, y);
+        train(X, view.numFeatures(), y);
+    }
+
+    /** 在数据视图上评估：逐行指针预测，不拷贝 */
+    virtual void evaluateOnView(const DatasetView& view, double& mse, double& mae) {
+        const size_t n = view.size();
+        const int d = view.numFeatures();
+        mse = 0.0;
+        mae = 0.0;
+        if (n == 0) return;
+
+        #pragma omp parallel for reduction(+:mse,mae) schedule(static, 256) if(n > 1000)
+        for (size_t i = 0; i < n; ++i) {
+            const double diff = view.label(i) - predict(view.sample(i), d);
+            mse += diff * diff;
+            mae += std::abs(diff);
+        }
+        mse /= n;
+        mae /= n;
+    }
+
     const Node* getRoot() const { return root_.get(); }
 
 protected:
@@ -27,6 +27,9 @@ public:
                int rowLength,
                const std::vector<double>& labels) override;
 
+    /** 按视图行号在共享矩阵上训练（零拷贝） */
+    void trainOnView(const DatasetView& view) override;
+
     double predict(const double* sample,
                    int rowLength) const override;
 
@@ -37,13 +40,19 @@ public:
                   double& mae) override;
 
 private:
+    // 从给定根节点行号开始建树并剪枝（train / trainOnView 共用）
+    void trainFromRoot(ConstSpan<double> data,
+                       int rowLength,
+                       const std::vector<double>& labels,
+                       std::vector<int>&& rootIndices);
+
     // **新增：任务队列驱动的树构建方法**
-    void buildTreeWithTaskQueue(const std::vector<double>& data,
+    void buildTreeWithTaskQueue(ConstSpan<double> data,
                                 int rowLength,
                                 const std::vector<double>& labels,
                                 std::vector<int>&& rootIndices);
     
-    void processTask(const std::vector<double>& data,
+    void processTask(ConstSpan<double> data,
                      int rowLength,
                      const std::vector<double>& labels,
                      std::unique_ptr<SplitTask> task,
@@ -52,21 +61,21 @@ private:
     
     // 原有方法（优化版本）
     void splitNode(Node* node,
-                   const std::vector<double>& data,
+                   ConstSpan<double> data,
                    int rowLength,
                    const std::vector<double>& labels,
                    const std::vector<int>& indices,
                    int depth);
 
     void splitNodeInPlace(Node* node,
-                          const std::vector<double>& data,
+                          ConstSpan<double> data,
                           int rowLength,
                           const std::vector<double>& labels,
                           std::vector<int>& indices,
                           int depth);
 
     void splitNodeInPlaceParallel(Node* node,
-                                  const std::vector<double>& data,
+                                  ConstSpan<double> data,
                                   int rowLength,
                                   const std::vector<double>& labels,
                                   std::vector<int>& indices,
@@ -78,7 +87,7 @@ private:
                             int& leafCount) const;
                             
     void splitNodeOptimized(Node* node,
-                           const std::vector<double>& data,
+                           ConstSpan<double> data,
                            int rowLength,
                            const std::vector<double>& labels,
                            std::vector<int>& indices,
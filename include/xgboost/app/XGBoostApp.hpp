@@ -26,6 +26,7 @@ struct XGBoostAppOptions {
     double gamma = 0.0;
     double subsample = 1.0;
     double colsampleByTree = 1.0;
+    uint32_t seed = 42;
     
     
     bool verbose = true;
@@ -36,6 +37,10 @@ struct XGBoostAppOptions {
     
     bool useApproxSplit = false;
     int maxBins = 256;
+
+    // 列投影：逗号分隔的特征列名（为空则除标签外全部）与标签列名（为空则最后一列）
+    std::string featureColumns;
+    std::string labelColumn;
 };
 
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string> 
 #include <vector> 
 #include <memory> 
@@ -21,6 +22,7 @@ struct XGBoostConfig {
     
     double subsample = 1.0;           
     double colsampleByTree = 1.0;     
+    uint32_t seed = 42;               // 行采样随机流的种子
     
     
     bool verbose = true;              
@@ -11,7 +11,7 @@ public:
         : gamma_(gamma), minChildWeight_(minChildWeight) {}
 
     std::tuple<int, double, double> findBestSplit(
-        const std::vector<double>& data,
+        ConstSpan<double> data,
         int rowLength,
         const std::vector<double>& labels,
         const std::vector<int>& indices,
@@ -26,6 +26,15 @@ public:
         const std::vector<double>& y_pred,
         std::vector<double>& gradients,
         std::vector<double>& hessians) const override;
+    
+    double updatePredictionsAndGradients(
+        const std::vector<double>& y_true,
+        const double* treePred,
+        double learningRate,
+        std::vector<double>& y_pred,
+        std::vector<double>& gradients,
+        std::vector<double>* hessians = nullptr,
+        std::vector<double>* absGradients = nullptr) const override;
 };
 
 
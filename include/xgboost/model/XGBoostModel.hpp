@@ -67,6 +67,11 @@ public:
     
     
     size_t getTreeCount() const { return trees_.size(); }
+    void truncate(size_t numTrees) {
+        if (numTrees < trees_.size()) {
+            trees_.erase(trees_.begin() + numTrees, trees_.end());
+        }
+    }
     void setGlobalBaseScore(double score) { globalBaseScore_ = score; }
     double getGlobalBaseScore() const { return globalBaseScore_; }
     
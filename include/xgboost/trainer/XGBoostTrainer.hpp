@@ -33,6 +33,8 @@ public:
     // XGBoost专用方法
     const XGBoostModel* getXGBModel() const { return &model_; }
     const std::vector<double>& getTrainingLoss() const { return trainingLoss_; }
+    const std::vector<double>& getValidationLoss() const { return validationLoss_; }
+    int getBestIteration() const { return bestIteration_; }
     std::vector<double> getFeatureImportance(int numFeatures) const { return model_.getFeatureImportance(numFeatures); }
 
     void setValidationData(const std::vector<double>& X_val, const std::vector<double>& y_val, int rowLength) {
@@ -42,6 +44,12 @@ public:
         hasValidation_ = true;
     }
 
+    void setValidationData(const DatasetView& validation) {
+        validation.materialize(X_val_, y_val_);
+        valRowLength_ = validation.numFeatures();
+        hasValidation_ = true;
+    }
+
 private:
     XGBoostConfig config_;
     XGBoostModel model_;
@@ -53,6 +61,12 @@ private:
     int valRowLength_ = 0;
     bool hasValidation_ = false;
 
+    // 验证集增量预测：每轮只累加最新一棵树
+    std::vector<double> valPredictions_;
+    std::vector<double> validationLoss_;
+    double bestValidationLoss_ = 0.0;
+    int bestIteration_ = -1;
+
     // 核心优化方法
     std::unique_ptr<Node> trainSingleTree(const ColumnData& columnData, 
                                          const std::vector<double>& gradients, 
@@ -76,6 +90,10 @@ private:
     double computeBaseScore(const std::vector<double>& y) const;
     bool shouldEarlyStop(const std::vector<double>& losses, int patience) const;
     double computeValidationLoss() const;
+    bool checkValidationEarlyStop(int round);
+    void rollbackToBestIteration();
     void updatePredictions(const std::vector<double>& data, int rowLength, 
                           const Node* tree, std::vector<double>& predictions) const;
+    void computeTreeOutputs(const std::vector<double>& data, int rowLength,
+                            const Node* tree, std::vector<double>& outputs) const;
 };
\ No newline at end of file
@@ -26,6 +26,8 @@ int main(int argc, char** argv) {
     if (argc >= 9)  opts.prunerType = argv[8];
     if (argc >= 10) opts.prunerParam = std::stod(argv[9]);
     if (argc >= 11) opts.seed = static_cast<uint32_t>(std::stoi(argv[10]));
+    if (argc >= 12) opts.maxFeatures = argv[11];
+    if (argc >= 13) opts.oobImportance = std::stoi(argv[12]) != 0;
     
     // 3. 输出参数
     std::cout << "=== Bagging Parameters ===" << std::endl;
@@ -38,6 +40,8 @@ int main(int argc, char** argv) {
         std::cout << "(" << opts.prunerParam << ")";
     }
     std::cout << " | Seed: " << opts.seed << std::endl;
+    std::cout << "Max Features: " << opts.maxFeatures
+              << " | OOB Importance: " << (opts.oobImportance ? "on" : "off") << std::endl;
 
     // 4. 运行
     runBaggingApp(opts);
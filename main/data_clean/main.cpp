@@ -1,19 +1,48 @@
 #include "preprocessing/DataCleaner.hpp"
 #include <filesystem>
 #include <iostream>
+#include <string>
 
 namespace fs = std::filesystem;
 
-int main() {
-    const std::string inDir  = "data/data_base";
-    const std::string outDir = "data/data_clean";
+namespace {
+
+void printUsage(const char* programName) {
+    std::cout << "Usage: " << programName << " [options]" << std::endl;
+    std::cout << "  --input DIR        Directory of raw CSV files (default: data/data_base)" << std::endl;
+    std::cout << "  --output DIR       Output directory (default: data/data_clean)" << std::endl;
+    std::cout << "  --z FLOAT          Z-score threshold on the last column (default: 3.0)" << std::endl;
+    std::cout << "  --streaming        Statistics pre-pass + one filtering pass, for files larger than memory" << std::endl;
+    std::cout << "  --batch-rows INT   Rows per parsed batch (default: 65536)" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string inDir  = "data/data_base";
+    std::string outDir = "data/data_clean";
+    double zThreshold = 3.0;
+    bool streaming = false;
+    size_t batchRows = 65536;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") { printUsage(argv[0]); return 0; }
+        else if (arg == "--input" && i + 1 < argc) inDir = argv[++i];
+        else if (arg == "--output" && i + 1 < argc) outDir = argv[++i];
+        else if (arg == "--z" && i + 1 < argc) zThreshold = std::stod(argv[++i]);
+        else if (arg == "--streaming") streaming = true;
+        else if (arg == "--batch-rows" && i + 1 < argc) batchRows = std::stoul(argv[++i]);
+        else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
 
     // 确保输出目录存在
     fs::create_directories(outDir);
 
-    std::vector<std::string> headers;
-    std::vector<std::vector<double>> data, cleaned;
-
     for (auto& entry : fs::directory_iterator(inDir)) {
         if (entry.path().extension() == ".csv") {
             std::string filename = entry.path().filename().string();
@@ -21,16 +50,30 @@ int main() {
             std::string outPath = outDir + "/cleaned_" + filename;
 
             try {
-                // 读 CSV
-                preprocessing::DataCleaner::readCSV(inPath, headers, data);
-
-                // 全局剔除最后一列的异常值（Z 阈值 3.0）
-                cleaned = preprocessing::DataCleaner::removeOutliers(data, headers.size()-1, 3.0);
+                size_t rows = 0, kept = 0;
+                if (streaming) {
+                    // 流式：只驻留一个批次，标签（最后一列）统计由预扫描得到
+                    std::cout << "Streaming " << filename << std::endl;
+                    const auto stats = preprocessing::DataCleaner::cleanStreaming(
+                        inPath, outPath, preprocessing::DataCleaner::kLastColumn, zThreshold, batchRows);
+                    rows = stats.rows;
+                    kept = stats.kept;
+                } else {
+                    // 读入列存表
+                    const auto table = preprocessing::DataCleaner::readCSV(inPath, batchRows);
 
-                // 写入 clean 目录
-                preprocessing::DataCleaner::writeCSV(outPath, headers, cleaned);
+                    // 全局标记最后一列的异常值，只写出保留行
+                    preprocessing::RowSelection keep(table.rows);
+                    if (table.columns > 0) {
+                        preprocessing::DataCleaner::removeOutliers(table, table.columns - 1, zThreshold, keep);
+                    }
+                    preprocessing::DataCleaner::writeCSV(outPath, table, &keep);
+                    rows = table.rows;
+                    kept = keep.count();
+                }
 
-                std::cout << "Cleaned " << filename << " -> " << outPath << std::endl;
+                std::cout << "Cleaned " << filename << " -> " << outPath
+                          << " (" << kept << "/" << rows << " rows kept)" << std::endl;
             } catch (const std::exception& e) {
                 std::cerr << "Error processing " << filename << ": " << e.what() << std::endl;
             }
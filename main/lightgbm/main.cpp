@@ -15,7 +15,11 @@ void printUsage(const char* programName) {
     std::cout << "  " << programName << " [OPTIONS]" << std::endl;
     
     std::cout << "\nREQUIRED:" << std::endl;
-    std::cout << "  --data PATH           Training data CSV file path" << std::endl;
+    std::cout << "  --data PATH           Training data CSV file path (comma list or glob of part files)" << std::endl;
+    
+    std::cout << "\nDATA COLUMNS:" << std::endl;
+    std::cout << "  --features A,B,...    Feature columns by header name (default: all but the label)" << std::endl;
+    std::cout << "  --label NAME          Label column by header name (default: last column)" << std::endl;
     
     std::cout << "\nMODEL PARAMETERS:" << std::endl;
     std::cout << "  --objective STR       Objective (default: regression)" << std::endl;
@@ -29,11 +33,26 @@ void printUsage(const char* programName) {
     std::cout << "  --top-rate FLOAT      Large gradient retain ratio (default: 0.2)" << std::endl;
     std::cout << "  --other-rate FLOAT    Small gradient sample ratio (default: 0.1)" << std::endl;
     std::cout << "  --enable-goss         Enable GOSS sampling (default: true)" << std::endl;
+    std::cout << "  --seed INT            GOSS random seed (default: 42)" << std::endl;
     
     std::cout << "\nEFB PARAMETERS:" << std::endl;
     std::cout << "  --max-bin INT         Max histogram bins (default: 255)" << std::endl;
     std::cout << "  --max-conflict FLOAT  Max feature conflict rate (default: 0.0)" << std::endl;
     std::cout << "  --enable-bundling     Enable feature bundling (default: true)" << std::endl;
+    std::cout << "  --hist-pool-size INT  Max cached leaf histograms, LRU evicted (default: 16384)" << std::endl;
+    
+    std::cout << "\nTRAINING CONTROL:" << std::endl;
+    std::cout << "  --early-stopping INT  Early stopping rounds on validation loss (default: 0)" << std::endl;
+    std::cout << "  --val-split FLOAT     Validation split ratio (default: 0.2)" << std::endl;
+    
+    std::cout << "\nMEMORY:" << std::endl;
+    std::cout << "  --float32             Store features as float32 (half the RAM, histogram_ew / histogram_eq)" << std::endl;
+    
+    std::cout << "\nSTREAMING (out-of-core, histogram_ew / histogram_eq):" << std::endl;
+    std::cout << "  --streaming           Two-pass streamed binning, no in-memory double matrix" << std::endl;
+    std::cout << "  --test-data PATH      Test CSV evaluated in batches after streaming training" << std::endl;
+    std::cout << "  --bin-spill PATH      Spill the bin-index matrix to PATH and mmap it" << std::endl;
+    std::cout << "  --stream-batch INT    Rows per streamed batch (default: 65536)" << std::endl;
     
     std::cout << "\nEXAMPLES:" << std::endl;
     std::cout << "  Basic: " << programName << " --data data.csv" << std::endl;
@@ -54,10 +73,13 @@ bool parseArguments(int argc, char** argv, LightGBMAppOptions& opts) {
         else if (arg == "--min-data-in-leaf" && i + 1 < argc) opts.minDataInLeaf = std::stoi(argv[++i]);
         else if (arg == "--top-rate" && i + 1 < argc) opts.topRate = std::stod(argv[++i]);
         else if (arg == "--other-rate" && i + 1 < argc) opts.otherRate = std::stod(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc) opts.seed = static_cast<uint32_t>(std::stoul(argv[++i]));
         else if (arg == "--max-bin" && i + 1 < argc) opts.maxBin = std::stoi(argv[++i]);
         else if (arg == "--max-conflict" && i + 1 < argc) opts.maxConflictRate = std::stod(argv[++i]);
         else if (arg == "--lambda" && i + 1 < argc) opts.lambda = std::stod(argv[++i]);
         else if (arg == "--min-split-gain" && i + 1 < argc) opts.minSplitGain = std::stod(argv[++i]);
+        else if (arg == "--early-stopping" && i + 1 < argc) opts.earlyStoppingRounds = std::stoi(argv[++i]);
+        else if (arg == "--val-split" && i + 1 < argc) opts.valSplit = std::stod(argv[++i]);
         else if (arg == "--enable-goss") opts.enableGOSS = true;
         else if (arg == "--disable-goss") opts.enableGOSS = false;
         else if (arg == "--enable-bundling") opts.enableFeatureBundling = true;
@@ -67,10 +89,18 @@ bool parseArguments(int argc, char** argv, LightGBMAppOptions& opts) {
         
         else if (arg == "--split-method" && i + 1 < argc) opts.splitMethod = argv[++i];
         else if (arg == "--histogram-bins" && i + 1 < argc) opts.histogramBins = std::stoi(argv[++i]);
+        else if (arg == "--hist-pool-size" && i + 1 < argc) opts.histPoolSize = std::stoi(argv[++i]);
         else if (arg == "--adaptive-rule" && i + 1 < argc) opts.adaptiveRule = argv[++i];
         else if (arg == "--min-samples-per-bin" && i + 1 < argc) opts.minSamplesPerBin = std::stoi(argv[++i]);
         else if (arg == "--max-adaptive-bins" && i + 1 < argc) opts.maxAdaptiveBins = std::stoi(argv[++i]);
         else if (arg == "--variability-threshold" && i + 1 < argc) opts.variabilityThreshold = std::stod(argv[++i]);
+        else if (arg == "--features" && i + 1 < argc) opts.featureColumns = argv[++i];
+        else if (arg == "--label" && i + 1 < argc) opts.labelColumn = argv[++i];
+        else if (arg == "--float32") opts.float32 = true;
+        else if (arg == "--streaming") opts.streaming = true;
+        else if (arg == "--test-data" && i + 1 < argc) opts.testDataPath = argv[++i];
+        else if (arg == "--bin-spill" && i + 1 < argc) opts.binSpillPath = argv[++i];
+        else if (arg == "--stream-batch" && i + 1 < argc) opts.streamBatchRows = std::stoul(argv[++i]);
         else if (arg == "--enable-simd") opts.enableSIMD = true;
         else if (arg == "--disable-simd") opts.enableSIMD = false;
         else {
@@ -95,6 +125,7 @@ int main(int argc, char** argv) {
     opts.minDataInLeaf = 20;
     opts.topRate = 0.2;
     opts.otherRate = 0.1;
+    opts.seed = 42;
     opts.maxBin = 255;
     opts.maxConflictRate = 0.0;
     opts.enableGOSS = true;
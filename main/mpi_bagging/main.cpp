@@ -1,5 +1,5 @@
 #include "ensemble/MPIBaggingTrainer.hpp"
-#include "functions/io/DataIO.hpp"
+#include "ensemble/MPIDataLoader.hpp"
 #include "pipeline/DataSplit.hpp"
 #include <mpi.h>
 #include <iostream>
@@ -19,6 +19,10 @@ struct MPIBaggingOptions {
     std::string prunerType;
     double prunerParam;
     uint32_t seed;
+    std::string maxFeatures = "all";
+    bool oobImportance = false;
+    bool sharedWindow = true;
+    std::string schedule = "dynamic";
 };
 
 void printUsage(const char* programName) {
@@ -34,6 +38,11 @@ void printUsage(const char* programName) {
     std::cout << "  <prunerType>     - Pruner type (default: none)" << std::endl;
     std::cout << "  <prunerParam>    - Pruner parameter (default: 0.01)" << std::endl;
     std::cout << "  <seed>           - Random seed (default: 42)" << std::endl;
+    std::cout << "  <maxFeatures>    - Candidate features per split: all, sqrt, log2, fraction or count (default: all)" << std::endl;
+    std::cout << "  <oobImportance>  - 1 to compute OOB permutation importance while training (default: 0)" << std::endl;
+    std::cout << "  <sharedWindow>   - 1 to keep one copy of the features per node in an MPI shared-memory window," << std::endl;
+    std::cout << "                     0 for a private copy per process (default: 1)" << std::endl;
+    std::cout << "  <schedule>       - Tree scheduling: dynamic (claim tree ids on demand) or static (default: dynamic)" << std::endl;
     std::cout << "\nExample:" << std::endl;
     std::cout << "  mpirun -np 4 " << programName << " data.csv 100 1.0" << std::endl;
 }
@@ -56,8 +65,10 @@ public:
 };
 
 int main(int argc, char** argv) {
-    // Initialize MPI
-    MPI_Init(&argc, &argv);
+    // Initialize MPI: dynamic tree scheduling claims ids from whichever OpenMP
+    // thread runs out of work, one thread at a time
+    int threadSupport = MPI_THREAD_SINGLE;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_SERIALIZED, &threadSupport);
     
     int mpiRank, mpiSize;
     MPI_Comm_rank(MPI_COMM_WORLD, &mpiRank);
@@ -93,6 +104,10 @@ int main(int argc, char** argv) {
         if (argc >= 9) opts.prunerType = argv[8];
         if (argc >= 10) opts.prunerParam = std::stod(argv[9]);
         if (argc >= 11) opts.seed = static_cast<uint32_t>(std::stoi(argv[10]));
+        if (argc >= 12) opts.maxFeatures = argv[11];
+        if (argc >= 13) opts.oobImportance = std::stoi(argv[12]) != 0;
+        if (argc >= 14) opts.sharedWindow = std::stoi(argv[13]) != 0;
+        if (argc >= 15) opts.schedule = argv[14];
     }
     
     // Validate parameters
@@ -129,77 +144,62 @@ int main(int argc, char** argv) {
         }
         std::cout << std::endl;
         std::cout << "Seed: " << opts.seed << std::endl;
+        std::cout << "Max Features: " << opts.maxFeatures << std::endl;
+        std::cout << "OOB Importance: " << (opts.oobImportance ? "on" : "off") << std::endl;
+        std::cout << "Feature Memory: " << (opts.sharedWindow ? "node-shared window" : "private per process") << std::endl;
+        std::cout << "Tree Scheduling: " << opts.schedule << std::endl;
         std::cout << "==============================" << std::endl;
     }
     
     try {
-        // Unified data dimension management
-        std::vector<double> trainX, trainY;
-        std::vector<double> testX, testY;
-        int numFeatures = 0;  // Actual number of features (excluding label)
-        
-        // Only master process loads and splits data
+        // Sharded loading: every process parses its own byte range of the file
+        // (or row range of a binary dataset) in parallel. With the shared window
+        // the feature matrix is assembled once per node in MPI-3 shared memory and
+        // trainers read it in place; otherwise every process all-gathers a private
+        // copy. Either way every process derives the same train/test views locally.
+        auto loadStart = std::chrono::high_resolution_clock::now();
         if (mpiRank == 0) {
-            std::cout << "Loading data from: " << opts.dataPath << std::endl;
-            
-            DataIO io;
-            int rawRowLength = 0;
-            auto [X, y] = io.readCSV(opts.dataPath, rawRowLength);
-            
-            if (X.empty() || y.empty()) {
-                std::cerr << "Error: Failed to load data from " << opts.dataPath << std::endl;
-                MPI_Abort(MPI_COMM_WORLD, 1);
-            }
-            
-            // Calculate actual number of features
-            numFeatures = rawRowLength - 1;  // CSV rowLength includes label column
-            
-            // Split dataset
-            DataParams dp;
-            if (!splitDataset(X, y, rawRowLength, dp)) {
-                std::cerr << "Failed to split dataset" << std::endl;
-                MPI_Abort(MPI_COMM_WORLD, 1);
-            }
-            
-            std::cout << "Dataset loaded: " << y.size() << " samples, " 
-                      << numFeatures << " features" << std::endl;
-            std::cout << "Train: " << dp.y_train.size() << " samples" << std::endl;
-            std::cout << "Test: " << dp.y_test.size() << " samples" << std::endl;
-            
-            trainX = std::move(dp.X_train);
-            trainY = std::move(dp.y_train);
-            testX = std::move(dp.X_test);
-            testY = std::move(dp.y_test);
+            std::cout << "Loading data from: " << opts.dataPath
+                      << " (" << mpiSize << " shards)" << std::endl;
         }
         
-        // Broadcast number of features to all processes
-        MPI_Bcast(&numFeatures, 1, MPI_INT, 0, MPI_COMM_WORLD);
-        
-        // Validate number of features
-        if (numFeatures <= 0) {
-            if (mpiRank == 0) {
-                std::cerr << "Error: Invalid number of features: " << numFeatures << std::endl;
-            }
-            MPI_Abort(MPI_COMM_WORLD, 1);
+        mpi_data::SharedDataset sharedData;
+        mpi_data::ShardedDataset privateData;
+        ConstSpan<double> X;
+        int rowLength = 0;
+        int nodeRanks = 1;
+        if (opts.sharedWindow) {
+            sharedData = mpi_data::loadShardedShared(opts.dataPath, MPI_COMM_WORLD);
+            X = sharedData.features();
+            rowLength = sharedData.rowLength;
+            nodeRanks = sharedData.X.nodeRanks();
+        } else {
+            privateData = mpi_data::loadSharded(opts.dataPath, MPI_COMM_WORLD);
+            X = privateData.X;
+            rowLength = privateData.rowLength;
         }
+        const std::vector<double>& y = opts.sharedWindow ? sharedData.y : privateData.y;
+        const int numFeatures = rowLength - 1;  // CSV rowLength includes label column
         
-        // Distribute training data
-        int trainSize = 0;
-        if (mpiRank == 0) {
-            trainSize = static_cast<int>(trainY.size());
-        }
-        MPI_Bcast(&trainSize, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        // Split dataset (views only, no copies)
+        DataViews dv = splitViews(X, y, rowLength, 0.8);
+        auto loadEnd = std::chrono::high_resolution_clock::now();
         
-        // Allocate training data space
-        if (mpiRank != 0) {
-            trainX.resize(trainSize * numFeatures);
-            trainY.resize(trainSize);
+        if (mpiRank == 0) {
+            std::cout << "Dataset loaded: " << y.size() << " samples, " 
+                      << numFeatures << " features in "
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(loadEnd - loadStart).count()
+                      << "ms" << std::endl;
+            std::ostringstream megabytes;
+            megabytes << std::fixed << std::setprecision(1)
+                      << X.size() * sizeof(double) / (1024.0 * 1024.0);
+            std::cout << "Feature matrix: " << megabytes.str() << " MB per "
+                      << (opts.sharedWindow ? "node (" + std::to_string(nodeRanks) + " processes share it)"
+                                            : std::string("process")) << std::endl;
+            std::cout << "Train: " << dv.train.size() << " samples" << std::endl;
+            std::cout << "Test: " << dv.test.size() << " samples" << std::endl;
         }
         
-        // Broadcast training data
-        MPI_Bcast(trainX.data(), trainSize * numFeatures, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-        MPI_Bcast(trainY.data(), trainSize, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-        
         // Create MPI Bagging trainer
         MPIBaggingTrainer trainer(
             opts.numTrees,
@@ -212,6 +212,9 @@ int main(int argc, char** argv) {
             opts.prunerParam,
             opts.seed
         );
+        trainer.setMaxFeatures(opts.maxFeatures);
+        trainer.setOOBImportance(opts.oobImportance);
+        trainer.setDynamicScheduling(opts.schedule != "static");
         
         // **关键修改**: 隐藏训练过程中的详细输出
         OutputRedirector redirector;
@@ -230,7 +233,7 @@ int main(int argc, char** argv) {
             masterSilenced = true;
         }
         
-        trainer.train(trainX, numFeatures, trainY);
+        trainer.trainOnView(dv.train);
         auto trainEnd = std::chrono::high_resolution_clock::now();
         
         // 恢复主进程输出
@@ -245,51 +248,57 @@ int main(int argc, char** argv) {
         auto localTrainTime = std::chrono::duration_cast<std::chrono::milliseconds>(trainEnd - trainStart).count();
         long maxTrainTime;
         MPI_Reduce(&localTrainTime, &maxTrainTime, 1, MPI_LONG, MPI_MAX, 0, MPI_COMM_WORLD);
+        long minTrainTime;
+        MPI_Reduce(&localTrainTime, &minTrainTime, 1, MPI_LONG, MPI_MIN, 0, MPI_COMM_WORLD);
+        int localTrees = trainer.getLocalNumTrees();
+        int minTrees = 0, maxTrees = 0;
+        MPI_Reduce(&localTrees, &minTrees, 1, MPI_INT, MPI_MIN, 0, MPI_COMM_WORLD);
+        MPI_Reduce(&localTrees, &maxTrees, 1, MPI_INT, MPI_MAX, 0, MPI_COMM_WORLD);
         
         if (mpiRank == 0) {
             auto totalTime = std::chrono::duration_cast<std::chrono::milliseconds>(trainEnd - trainStart);
-            std::cout << "Max training time across processes: " << maxTrainTime << "ms" << std::endl;
+            std::cout << "Max training time across processes: " << maxTrainTime << "ms"
+                      << " (min " << minTrainTime << "ms)" << std::endl;
+            std::cout << "Trees per process: " << minTrees << "-" << maxTrees << std::endl;
             std::cout << "Total time (including communication): " << totalTime.count() << "ms" << std::endl;
         }
         
-        // Distribute test data
-        int testSize = 0;
-        if (mpiRank == 0) {
-            testSize = static_cast<int>(testY.size());
-            std::cout << "Preparing test data: " << testSize << " samples with " 
-                      << numFeatures << " features" << std::endl;
-        }
-        
-        MPI_Bcast(&testSize, 1, MPI_INT, 0, MPI_COMM_WORLD);
-        
-        if (testSize <= 0) {
+        if (dv.test.empty()) {
             if (mpiRank == 0) {
                 std::cerr << "Error: No test data!" << std::endl;
             }
             MPI_Abort(MPI_COMM_WORLD, 1);
         }
         
-        // Allocate test data space
-        if (mpiRank != 0) {
-            testX.resize(testSize * numFeatures);
-            testY.resize(testSize);
-        }
-        
-        // Broadcast test data
-        MPI_Bcast(testX.data(), testSize * numFeatures, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-        MPI_Bcast(testY.data(), testSize, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-        
         // Evaluation
         if (mpiRank == 0) {
             std::cout << "Evaluating model..." << std::endl;
         }
         
         double mse = 0.0, mae = 0.0;
-        trainer.evaluate(testX, numFeatures, testY, mse, mae);
+        trainer.evaluateOnView(dv.test, mse, mae);
         
-        // Feature importance calculation
-        MPI_Barrier(MPI_COMM_WORLD);
+        // Serving: gather all trees on the master so row-at-a-time scoring needs no collectives
+        trainer.gatherForest(0);
+        double servingMSE = 0.0;
+        double servingMicros = 0.0;
+        if (mpiRank == 0) {
+            auto serveStart = std::chrono::high_resolution_clock::now();
+            for (size_t i = 0; i < dv.test.size(); ++i) {
+                const double diff = dv.test.label(i) - trainer.predict(dv.test.sample(i), numFeatures);
+                servingMSE += diff * diff;
+            }
+            auto serveEnd = std::chrono::high_resolution_clock::now();
+            servingMSE /= static_cast<double>(dv.test.size());
+            servingMicros = std::chrono::duration<double, std::micro>(serveEnd - serveStart).count()
+                          / static_cast<double>(dv.test.size());
+        }
         
+        // OOB error: per-process statistics from training, reduced once (collective)
+        const double oobError = trainer.getOOBError(dv.train);
+        const auto oobImportance = trainer.getOOBPermutationImportance(numFeatures);
+        
+        // Feature importance calculation
         if (mpiRank == 0) {
             std::cout << "Computing feature importance..." << std::endl;
         }
@@ -318,14 +327,32 @@ int main(int argc, char** argv) {
                               << importanceWithIndex[i].first << std::endl;
                 }
                 
+                if (!oobImportance.empty()) {
+                    std::vector<std::pair<double, int>> oobRanked;
+                    for (int i = 0; i < static_cast<int>(oobImportance.size()); ++i) {
+                        oobRanked.emplace_back(oobImportance[i], i);
+                    }
+                    std::sort(oobRanked.begin(), oobRanked.end(),
+                              std::greater<std::pair<double, int>>());
+                    
+                    std::cout << "\nTop 10 OOB Permutation Importances (MSE increase):" << std::endl;
+                    for (int i = 0; i < std::min(10, static_cast<int>(oobRanked.size())); ++i) {
+                        std::cout << "Feature " << oobRanked[i].second
+                                  << ": " << std::fixed << std::setprecision(4)
+                                  << oobRanked[i].first << std::endl;
+                    }
+                }
+                
                 // Timing summary
                 auto trainTime = std::chrono::duration_cast<std::chrono::milliseconds>(trainEnd - trainStart);
                 std::cout << "\nTiming Summary:" << std::endl;
                 std::cout << "Training time: " << trainTime.count() << "ms" << std::endl;
-                std::cout << "Trees per process: ~" << opts.numTrees / mpiSize << std::endl;
                 std::cout << "\n=== MPI+OpenMP Bagging Results ===" << std::endl;
                 std::cout << "Final MSE: " << std::fixed << std::setprecision(6) << mse << std::endl;
                 std::cout << "Final MAE: " << std::fixed << std::setprecision(6) << mae << std::endl;
+                std::cout << "OOB MSE: " << std::fixed << std::setprecision(6) << oobError << std::endl;
+                std::cout << "Single-row serving on master: MSE " << servingMSE
+                          << ", " << std::setprecision(2) << servingMicros << " us/row" << std::endl;
                 std::cout << "Total Trees: " << opts.numTrees << " (distributed across " << mpiSize << " processes)" << std::endl;
                 std::cout << "Features: " << numFeatures << std::endl;
                 std::cout << "MPI+OpenMP Bagging completed successfully!" << std::endl;
@@ -12,7 +12,9 @@ void printUsage(const char* programName) {
     std::cout << "\nSingle Tree Options:" << std::endl;
     std::cout << "  " << programName << " single [dataPath] [maxDepth] [minSamplesLeaf] [criterion] [splitMethod] [prunerType] [prunerParam] [valSplit]" << std::endl;
     std::cout << "\nBagging Options:" << std::endl;
-    std::cout << "  " << programName << " bagging [dataPath] [numTrees] [sampleRatio] [maxDepth] [minSamplesLeaf] [criterion] [splitMethod] [prunerType] [prunerParam] [seed]" << std::endl;
+    std::cout << "  " << programName << " bagging [dataPath] [numTrees] [sampleRatio] [maxDepth] [minSamplesLeaf] [criterion] [splitMethod] [prunerType] [prunerParam] [seed] [maxFeatures] [oobImportance]" << std::endl;
+    std::cout << "  maxFeatures: all (default) | sqrt | log2 | fraction (e.g. 0.3) | count" << std::endl;
+    std::cout << "  oobImportance: 1 to compute OOB permutation importance while training (default 0)" << std::endl;
     std::cout << "\nExamples:" << std::endl;
     std::cout << "  " << programName << " single ../data/data_clean/cleaned_data.csv 10 2 mse exhaustive none" << std::endl;
     std::cout << "  " << programName << " bagging ../data/data_clean/cleaned_data.csv 50 1.0 10 2 mse random none" << std::endl;
@@ -87,6 +89,8 @@ int main(int argc, char** argv) {
         if (argc >= 10) opts.prunerType = argv[9];
         if (argc >= 11) opts.prunerParam = std::stod(argv[10]);
         if (argc >= 12) opts.seed = static_cast<uint32_t>(std::stoi(argv[11]));
+        if (argc >= 13) opts.maxFeatures = argv[12];
+        if (argc >= 14) opts.oobImportance = std::stoi(argv[13]) != 0;
         
         std::cout << "=== Bagging Mode ===" << std::endl;
         std::cout << "Data: " << opts.dataPath << std::endl;
@@ -98,6 +102,8 @@ int main(int argc, char** argv) {
             std::cout << "(" << opts.prunerParam << ")";
         }
         std::cout << " | Seed: " << opts.seed << std::endl;
+        std::cout << "Max Features: " << opts.maxFeatures
+                  << " | OOB Importance: " << (opts.oobImportance ? "on" : "off") << std::endl;
 
         runBaggingApp(opts);
     }
@@ -19,7 +19,11 @@ void printUsage(const char* programName) {
     std::cout << "  " << programName << " [OPTIONS]" << std::endl;
     
     std::cout << "\nREQUIRED PARAMETERS:" << std::endl;
-    std::cout << "  --data PATH           Training data CSV file path" << std::endl;
+    std::cout << "  --data PATH           Training data CSV file path (comma list or glob of part files)" << std::endl;
+    
+    std::cout << "\nDATA COLUMNS:" << std::endl;
+    std::cout << "  --features A,B,...    Feature columns by header name (default: all but the label)" << std::endl;
+    std::cout << "  --label NAME          Label column by header name (default: last column)" << std::endl;
     
     std::cout << "\nMODEL PARAMETERS:" << std::endl;
     std::cout << "  --objective STR       Objective function (default: reg:squarederror)" << std::endl;
@@ -37,6 +41,7 @@ void printUsage(const char* programName) {
     std::cout << "\nSAMPLING PARAMETERS:" << std::endl;
     std::cout << "  --subsample FLOAT     Subsample ratio of training instances (default: 1.0)" << std::endl;
     std::cout << "  --colsample-bytree FLOAT Subsample ratio of columns by tree (default: 1.0)" << std::endl;
+    std::cout << "  --seed INT            Random seed for row subsampling (default: 42)" << std::endl;
     
     std::cout << "\nTRAINING CONTROL:" << std::endl;
     std::cout << "  --early-stopping INT  Early stopping rounds (default: 0, disabled)" << std::endl;
@@ -233,6 +238,18 @@ bool parseArguments(int argc, char** argv, XGBoostAppOptions& opts) {
                 return false;
             }
         }
+        else if (arg == "--seed") {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: --seed requires a value" << std::endl;
+                return false;
+            }
+            try {
+                opts.seed = static_cast<uint32_t>(std::stoul(argv[++i]));
+            } catch (const std::exception&) {
+                std::cerr << "Error: Invalid value for --seed" << std::endl;
+                return false;
+            }
+        }
         else if (arg == "--early-stopping") {
             if (i + 1 >= argc) {
                 std::cerr << "Error: --early-stopping requires a value" << std::endl;
@@ -306,6 +323,12 @@ bool parseArguments(int argc, char** argv, XGBoostAppOptions& opts) {
         else if (arg == "--approx-split") {
             opts.useApproxSplit = true;
         }
+        else if (arg == "--features" && i + 1 < argc) {
+            opts.featureColumns = argv[++i];
+        }
+        else if (arg == "--label" && i + 1 < argc) {
+            opts.labelColumn = argv[++i];
+        }
         else {
             std::cerr << "Error: Unknown argument '" << arg << "'" << std::endl;
             return false;
@@ -419,6 +442,7 @@ int main(int argc, char** argv) {
     opts.gamma = 0.0;
     opts.subsample = 1.0;
     opts.colsampleByTree = 1.0;
+    opts.seed = 42;
     opts.verbose = true;
     opts.earlyStoppingRounds = 0;
     opts.tolerance = 1e-7;
@@ -9,20 +9,37 @@
 #include <iomanip>
 #include <algorithm>
 
+namespace {
+
+void printTopImportances(const char* title, const std::vector<double>& importance) {
+    std::cout << "\n" << title << std::endl;
+    std::vector<std::pair<double, int>> importanceWithIndex;
+    for (int i = 0; i < static_cast<int>(importance.size()); ++i) {
+        importanceWithIndex.emplace_back(importance[i], i);
+    }
+    
+    std::sort(importanceWithIndex.begin(), importanceWithIndex.end(), 
+              std::greater<std::pair<double, int>>());
+    
+    for (int i = 0; i < std::min(10, static_cast<int>(importanceWithIndex.size())); ++i) {
+        std::cout << "Feature " << importanceWithIndex[i].second 
+                  << ": " << std::fixed << std::setprecision(4) 
+                  << importanceWithIndex[i].first << std::endl;
+    }
+}
+
+} // namespace
+
 void runBaggingApp(const BaggingOptions& opts) {
     auto totalStart = std::chrono::high_resolution_clock::now();
     
     // 1. 读 CSV
     int rowLength;
     DataIO io;
-    auto [X, y] = io.readCSV(opts.dataPath, rowLength);
+    auto [X, y] = io.readDataset(opts.dataPath, rowLength);
 
-    // 2. 划分数据集 (80/20)
-    DataParams dp;
-    if (!splitDataset(X, y, rowLength, dp)) {
-        std::cerr << "Failed to split dataset" << std::endl;
-        return;
-    }
+    // 2. 划分数据集 (80/20)：训练 / 测试视图共享 X、y
+    const DataViews dv = splitViews(X, y, rowLength, 0.8);
 
     // 3. 创建Bagging训练器
     BaggingTrainer trainer(
@@ -36,21 +53,23 @@ void runBaggingApp(const BaggingOptions& opts) {
         opts.prunerParam,
         opts.seed
     );
+    trainer.setMaxFeatures(opts.maxFeatures);
+    trainer.setOOBImportance(opts.oobImportance);
 
     // 4. 训练（测量时间）
     auto trainStart = std::chrono::high_resolution_clock::now();
-    trainer.train(dp.X_train, dp.rowLength, dp.y_train);
+    trainer.trainOnView(dv.train);
     auto trainEnd = std::chrono::high_resolution_clock::now();
 
     // 5. 评估
     double mse, mae;
-    trainer.evaluate(dp.X_test, dp.rowLength, dp.y_test, mse, mae);
+    trainer.evaluateOnView(dv.test, mse, mae);
     
     // 6. 计算OOB误差
-    double oobError = trainer.getOOBError(dp.X_train, dp.rowLength, dp.y_train);
+    double oobError = trainer.getOOBError(dv.train);
     
     // 7. 计算特征重要性
-    auto featureImportance = trainer.getFeatureImportance(dp.rowLength);
+    auto featureImportance = trainer.getFeatureImportance(dv.rowLength);
     
     auto totalEnd = std::chrono::high_resolution_clock::now();
     
@@ -63,7 +82,8 @@ void runBaggingApp(const BaggingOptions& opts) {
     std::cout << "Trees: " << opts.numTrees 
               << " | Sample Ratio: " << std::fixed << std::setprecision(2) << opts.sampleRatio
               << " | Criterion: " << opts.criterion 
-              << " | Split: " << opts.splitMethod << std::endl;
+              << " | Split: " << opts.splitMethod
+              << " | Max Features: " << opts.maxFeatures << std::endl;
     
     std::cout << "Test MSE: " << std::fixed << std::setprecision(6) << mse 
               << " | Test MAE: " << mae << std::endl;
@@ -74,18 +94,9 @@ void runBaggingApp(const BaggingOptions& opts) {
               << " | Total Time: " << totalTime.count() << "ms" << std::endl;
     
     // 10. 输出特征重要性（前10个最重要的特征）
-    std::cout << "\nTop 10 Feature Importances:" << std::endl;
-    std::vector<std::pair<double, int>> importanceWithIndex;
-    for (int i = 0; i < static_cast<int>(featureImportance.size()); ++i) {
-        importanceWithIndex.emplace_back(featureImportance[i], i);
-    }
-    
-    std::sort(importanceWithIndex.begin(), importanceWithIndex.end(), 
-              std::greater<std::pair<double, int>>());
-    
-    for (int i = 0; i < std::min(10, static_cast<int>(importanceWithIndex.size())); ++i) {
-        std::cout << "Feature " << importanceWithIndex[i].second 
-                  << ": " << std::fixed << std::setprecision(4) 
-                  << importanceWithIndex[i].first << std::endl;
+    printTopImportances("Top 10 Feature Importances:", featureImportance);
+    if (opts.oobImportance) {
+        printTopImportances("Top 10 OOB Permutation Importances (MSE increase):",
+                            trainer.getOOBPermutationImportance());
     }
-}
\ No newline at end of file
+}
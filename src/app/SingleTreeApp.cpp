@@ -31,53 +31,6 @@
 #include <chrono>
 #include <iomanip>
 
-// 数据分割结构（扩展支持验证集）
-struct ExtendedDataParams {
-    std::vector<double> X_train;
-    std::vector<double> y_train;
-    std::vector<double> X_val;     // 验证集
-    std::vector<double> y_val;
-    std::vector<double> X_test;
-    std::vector<double> y_test;
-    int rowLength;
-};
-
-bool splitDatasetWithValidation(const std::vector<double>& X,
-                                const std::vector<double>& y,
-                                int rowLength,
-                                double valSplit,
-                                ExtendedDataParams& out) {
-    int feat = rowLength - 1;
-    size_t totalRows = y.size();
-    
-    if (valSplit > 0) {
-        // 三分：训练集、验证集、测试集
-        size_t trainRows = static_cast<size_t>(totalRows * 0.7);
-        size_t valRows = static_cast<size_t>(totalRows * valSplit);
-        
-        out.rowLength = feat;
-        out.X_train.assign(X.begin(), X.begin() + trainRows * feat);
-        out.y_train.assign(y.begin(), y.begin() + trainRows);
-        
-        out.X_val.assign(X.begin() + trainRows * feat, 
-                        X.begin() + (trainRows + valRows) * feat);
-        out.y_val.assign(y.begin() + trainRows, y.begin() + trainRows + valRows);
-        
-        out.X_test.assign(X.begin() + (trainRows + valRows) * feat, X.end());
-        out.y_test.assign(y.begin() + trainRows + valRows, y.end());
-    } else {
-        // 二分：训练集、测试集
-        size_t trainRows = static_cast<size_t>(totalRows * 0.8);
-        
-        out.rowLength = feat;
-        out.X_train.assign(X.begin(), X.begin() + trainRows * feat);
-        out.y_train.assign(y.begin(), y.begin() + trainRows);
-        out.X_test.assign(X.begin() + trainRows * feat, X.end());
-        out.y_test.assign(y.begin() + trainRows, y.end());
-    }
-    return true;
-}
-
 std::unique_ptr<ISplitFinder> createSplitFinder(const std::string& method) {
     if (method == "exhaustive" || method == "exact") {
         return std::make_unique<ExhaustiveSplitFinder>();
@@ -127,9 +80,7 @@ std::unique_ptr<ISplitFinder> createSplitFinder(const std::string& method) {
 
 std::unique_ptr<IPruner> createPruner(const std::string& type, 
                                      double param,
-                                     const std::vector<double>& X_val,
-                                     int rowLength,
-                                     const std::vector<double>& y_val) {
+                                     const DatasetView& validation) {
     if (type == "mingain") {
         return std::make_unique<MinGainPrePruner>(param);
     }
@@ -137,11 +88,11 @@ std::unique_ptr<IPruner> createPruner(const std::string& type,
         return std::make_unique<CostComplexityPruner>(param);
     }
     else if (type == "reduced_error") {
-        if (X_val.empty() || y_val.empty()) {
+        if (validation.empty()) {
             std::cerr << "Warning: No validation data for reduced_error pruner, using NoPruner" << std::endl;
             return std::make_unique<NoPruner>();
         }
-        return std::make_unique<ReducedErrorPruner>(X_val, rowLength, y_val);
+        return std::make_unique<ReducedErrorPruner>(validation);
     }
     else {
         return std::make_unique<NoPruner>();
@@ -154,12 +105,12 @@ void runSingleTreeApp(const ProgramOptions& opts) {
     // 1. 读 CSV
     int rowLength;
     DataIO io;
-    auto [X, y] = io.readCSV(opts.dataPath, rowLength);
+    auto [X, y] = io.readDataset(opts.dataPath, rowLength);
 
-    // 2. 划分数据（根据是否需要验证集）
-    ExtendedDataParams dp;
-    double valSplit = (opts.prunerType == "reduced_error") ? opts.valSplit : 0.0;
-    splitDatasetWithValidation(X, y, rowLength, valSplit, dp);
+    // 2. 划分数据（根据是否需要验证集）：视图共享 X / y，只记录行区间
+    const double valSplit = (opts.prunerType == "reduced_error") ? opts.valSplit : 0.0;
+    const DataViews dv = valSplit > 0 ? splitViews(X, y, rowLength, 0.7, valSplit)
+                                      : splitViews(X, y, rowLength, 0.8);
 
     // 3. 构造分割器
     auto finder = createSplitFinder(opts.splitMethod);
@@ -187,8 +138,7 @@ void runSingleTreeApp(const ProgramOptions& opts) {
         criterion = std::make_unique<MSECriterion>();
 
     // 5. 构造剪枝器
-    auto pruner = createPruner(opts.prunerType, opts.prunerParam, 
-                              dp.X_val, dp.rowLength, dp.y_val);
+    auto pruner = createPruner(opts.prunerType, opts.prunerParam, dv.validation);
 
     SingleTreeTrainer trainer(std::move(finder),
                               std::move(criterion),
@@ -198,12 +148,12 @@ void runSingleTreeApp(const ProgramOptions& opts) {
 
     // 6. 训练（测量时间）
     auto trainStart = std::chrono::high_resolution_clock::now();
-    trainer.train(dp.X_train, dp.rowLength, dp.y_train);
+    trainer.trainOnView(dv.train);
     auto trainEnd = std::chrono::high_resolution_clock::now();
 
     // 7. 评估
     double mse, mae;
-    trainer.evaluate(dp.X_test, dp.rowLength, dp.y_test, mse, mae);
+    trainer.evaluateOnView(dv.test, mse, mae);
     
     auto totalEnd = std::chrono::high_resolution_clock::now();
     
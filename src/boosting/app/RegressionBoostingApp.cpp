@@ -18,35 +18,48 @@ void runRegressionBoostingApp(const RegressionBoostingOptions& opts) {
     // 读取数据
     int rowLength;
     DataIO io;
-    auto [X, y] = io.readCSV(opts.dataPath, rowLength);
+    auto [X, y] = io.readDataset(opts.dataPath, rowLength);
     
     if (opts.verbose) {
         std::cout << "Loaded data: " << y.size() << " samples, " 
                   << (rowLength - 1) << " features" << std::endl;
     }
     
-    // 划分数据集
-    DataParams dp;
-    splitDataset(X, y, rowLength, dp);
+    // 划分数据集：训练 / 测试视图共享 X、y
+    DataViews dv = splitViews(X, y, rowLength, 0.8);
     
     // 创建训练器
     auto trainer = createRegressionBoostingTrainer(opts);
     
+    // 设置验证集（如果需要早停）
+    if (opts.earlyStoppingRounds > 0 && opts.valSplit > 0) {
+        // 从训练集尾部再分出验证集（仅调整视图区间）
+        size_t trainSize = dv.train.size();
+        size_t valSize = static_cast<size_t>(trainSize * opts.valSplit);
+        
+        if (valSize > 0) {
+            dv.validation = dv.train.slice(trainSize - valSize, trainSize);
+            dv.train = dv.train.slice(0, trainSize - valSize);
+            
+            trainer->setValidationData(dv.validation);
+        }
+    }
+    
     // 训练模型
     if (opts.verbose) {
         std::cout << "\n=== Training GBRT ===" << std::endl;
     }
     
     auto trainStart = std::chrono::high_resolution_clock::now();
-    trainer->train(dp.X_train, dp.rowLength, dp.y_train);
+    trainer->trainOnView(dv.train);
     auto trainEnd = std::chrono::high_resolution_clock::now();
     
     // 评估模型
     double trainLoss, trainMSE, trainMAE;
-    trainer->evaluate(dp.X_train, dp.rowLength, dp.y_train, trainLoss, trainMSE, trainMAE);
+    trainer->evaluateOnView(dv.train, trainLoss, trainMSE, trainMAE);
     
     double testLoss, testMSE, testMAE;
-    trainer->evaluate(dp.X_test, dp.rowLength, dp.y_test, testLoss, testMSE, testMAE);
+    trainer->evaluateOnView(dv.test, testLoss, testMSE, testMAE);
     
     auto totalEnd = std::chrono::high_resolution_clock::now();
     
@@ -87,6 +100,8 @@ std::unique_ptr<GBRTTrainer> createRegressionBoostingTrainer(const RegressionBoo
     config.splitMethod = opts.splitMethod;
     config.verbose = opts.verbose;
     config.subsample = opts.subsample;
+    config.earlyStoppingRounds = opts.earlyStoppingRounds;
+    config.tolerance = opts.tolerance;
     
     // === 传递DART配置 ===
     config.enableDart = opts.enableDart;
@@ -127,6 +142,8 @@ RegressionBoostingOptions parseRegressionCommandLine(int argc, char** argv) {
         std::string skipDropStr = argv[13];
         opts.dartSkipDropForPrediction = (skipDropStr == "true" || skipDropStr == "1");
     }
+    if (argc >= 15) opts.earlyStoppingRounds = std::stoi(argv[14]);
+    if (argc >= 16) opts.valSplit = std::stod(argv[15]);
     
     return opts;
 }
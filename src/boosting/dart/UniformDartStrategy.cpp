@@ -3,16 +3,15 @@
 // =============================================================================
 #include "boosting/dart/UniformDartStrategy.hpp"
 #include <algorithm>
-#include <random>
+#include <numeric>
 #include <iostream>
 #include <cmath>
-#include <execution>  // C++17并行算法
 #ifdef _OPENMP
 #include <omp.h>
 #endif
 
 std::vector<int> UniformDartStrategy::selectDroppedTrees(
-    int totalTrees, double dropRate, std::mt19937& gen) const {
+    int totalTrees, double dropRate, Philox& rng) const {
     
     if (totalTrees <= 0 || dropRate <= 0.0 || dropRate >= 1.0) {
         return {};
@@ -24,11 +23,10 @@ std::vector<int> UniformDartStrategy::selectDroppedTrees(
     
     // **优化1: 批量随机数生成**
     std::vector<double> randomValues(totalTrees);
-    std::uniform_real_distribution<double> dist(0.0, 1.0);
     
     // 批量生成随机数（更高效）
     for (int i = 0; i < totalTrees; ++i) {
-        randomValues[i] = dist(gen);
+        randomValues[i] = rng.uniform();
     }
     
     // **优化2: 向量化的选择过程**
@@ -41,8 +39,7 @@ std::vector<int> UniformDartStrategy::selectDroppedTrees(
     // **优化3: 确保至少丢弃一些树（如果期望值>=1）**
     if (droppedTrees.empty() && expectedDrops >= 1 && totalTrees > 0) {
         // 强制丢弃一棵随机树
-        std::uniform_int_distribution<int> treeDist(0, totalTrees - 1);
-        droppedTrees.push_back(treeDist(gen));
+        droppedTrees.push_back(static_cast<int>(rng.below(static_cast<uint64_t>(totalTrees))));
     }
     
     return droppedTrees;
@@ -310,7 +307,7 @@ void UniformDartStrategy::computeDropoutPredictionsBatch(
 std::vector<int> UniformDartStrategy::selectDroppedTreesAdaptive(
     const std::vector<RegressionBoostingModel::RegressionTree>& trees,
     double dropRate,
-    std::mt19937& gen) const {
+    Philox& rng) const {
     
     const int totalTrees = static_cast<int>(trees.size());
     if (totalTrees <= 0 || dropRate <= 0.0) {
@@ -323,8 +320,13 @@ std::vector<int> UniformDartStrategy::selectDroppedTreesAdaptive(
         treeWeights[i] = std::abs(trees[i].weight * trees[i].learningRate);
     }
     
-    // **创建加权分布**
-    std::discrete_distribution<int> dist(treeWeights.begin(), treeWeights.end());
+    // **创建加权分布**：累积权重上二分查找
+    std::vector<double> cumulative(totalTrees);
+    std::partial_sum(treeWeights.begin(), treeWeights.end(), cumulative.begin());
+    const double totalWeight = cumulative.back();
+    if (totalWeight <= 0.0) {
+        return {};
+    }
     
     const int numToDrop = static_cast<int>(std::ceil(totalTrees * dropRate));
     std::vector<int> droppedTrees;
@@ -332,7 +334,9 @@ std::vector<int> UniformDartStrategy::selectDroppedTreesAdaptive(
     
     // **按权重随机选择要丢弃的树**
     for (int i = 0; i < numToDrop && droppedTrees.size() < static_cast<size_t>(totalTrees); ++i) {
-        int candidate = dist(gen);
+        const double u = rng.uniform() * totalWeight;
+        const int candidate = std::min(totalTrees - 1, static_cast<int>(
+            std::upper_bound(cumulative.begin(), cumulative.end(), u) - cumulative.begin()));
         if (!alreadyDropped[candidate]) {
             droppedTrees.push_back(candidate);
             alreadyDropped[candidate] = true;
@@ -2,6 +2,7 @@
 // src/boosting/loss/IRegressionLoss.cpp - OpenMP并行优化版本
 // =============================================================================
 #include "boosting/loss/IRegressionLoss.hpp"
+#include <cmath>
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -83,6 +84,49 @@ void IRegressionLoss::computeGradientsVectorized(
     }
 }
 
+// =============================================
+// 新增：融合的预测更新 + 损失 + 梯度/Hessian 内核
+// =============================================
+
+double IRegressionLoss::updatePredictionsAndGradients(
+    const std::vector<double>& y_true,
+    const double* treePred,
+    double learningRate,
+    std::vector<double>& y_pred,
+    std::vector<double>& gradients,
+    std::vector<double>* hessians,
+    std::vector<double>* absGradients) const {
+    
+    const size_t n = y_true.size();
+    gradients.resize(n);
+    if (hessians) hessians->resize(n);
+    if (absGradients) absGradients->resize(n);
+    
+    double* pred = y_pred.data();
+    double* grad = gradients.data();
+    double* hess = hessians ? hessians->data() : nullptr;
+    double* absGrad = absGradients ? absGradients->data() : nullptr;
+    double totalLoss = 0.0;
+    
+    // **并行优化5: 单个并行区域内完成原来 3~4 次独立遍历**
+    #pragma omp parallel for reduction(+:totalLoss) schedule(static, 4096) if(n > 2000)
+    for (size_t i = 0; i < n; ++i) {
+        double p = pred[i];
+        if (treePred) {
+            p += learningRate * treePred[i];
+            pred[i] = p;
+        }
+        const double yt = y_true[i];
+        const double g = gradient(yt, p);
+        totalLoss += loss(yt, p);
+        grad[i] = g;
+        if (hess) hess[i] = hessian(yt, p);
+        if (absGrad) absGrad[i] = std::abs(g);
+    }
+    
+    return n > 0 ? totalLoss / n : 0.0;
+}
+
 // =============================================
 // 新增：性能监控版本
 // =============================================
@@ -12,14 +12,14 @@
 #include <chrono>
 #include <iomanip>
 #include <memory>
-#include <execution>  // C++17并行算法
+#include <functional>
 #ifdef _OPENMP
 #include <omp.h>
 #endif
 
 GBRTTrainer::GBRTTrainer(const GBRTConfig& config,
                         std::unique_ptr<GradientRegressionStrategy> strategy)
-    : config_(config), strategy_(std::move(strategy)), dartGen_(config.dartSeed) {
+    : config_(config), strategy_(std::move(strategy)) {
     
     if (config_.enableDart) {
         dartStrategy_ = createDartStrategy();
@@ -51,6 +51,7 @@ void GBRTTrainer::train(const std::vector<double>& X,
     } else {
         trainStandardOptimized(X, rowLength, y);
     }
+    rollbackToBestIteration();
     
     auto totalEnd = std::chrono::high_resolution_clock::now();
     auto totalTime = std::chrono::duration_cast<std::chrono::milliseconds>(totalEnd - totalStart);
@@ -88,6 +89,7 @@ void GBRTTrainer::trainStandardOptimized(const std::vector<double>& X,
     std::vector<double> currentPred(n, baseScore);
     std::vector<double> residuals(n);
     std::vector<double> treePred(n);
+    initValidationPredictions(baseScore);
     
     // **线程局部缓冲区池**
     std::vector<std::vector<double>> threadLocalPreds(numThreads);
@@ -97,17 +99,19 @@ void GBRTTrainer::trainStandardOptimized(const std::vector<double>& X,
     
     trainingLoss_.reserve(config_.numIterations);
     
+    // **融合内核: 损失与残差在同一次遍历中得到，后续每轮与预测更新合并**
+    const IRegressionLoss* lossFunc = strategy_->getLossFunction();
+    double nextLoss = lossFunc->updatePredictionsAndGradients(
+        y, nullptr, 0.0, currentPred, residuals);
+    
     // **核心训练循环 - 高度优化版本**
     for (int iter = 0; iter < config_.numIterations; ++iter) {
         auto iterStart = std::chrono::high_resolution_clock::now();
         
-        // **步骤1: 并行损失计算**
-        double currentLoss = computeTotalLossParallel(y, currentPred);
+        // **步骤1-2: 损失与残差已由上一轮融合内核给出**
+        const double currentLoss = nextLoss;
         trainingLoss_.push_back(currentLoss);
         
-        // **步骤2: 超高效并行残差计算**
-        computeResidualsParallel(y, currentPred, residuals);
-        
         // **步骤3: 训练新树（内部已并行）**
         auto treeTrainer = createTreeTrainer();
         treeTrainer->train(X, rowLength, residuals);
@@ -118,13 +122,19 @@ void GBRTTrainer::trainStandardOptimized(const std::vector<double>& X,
         // **步骤5: 计算学习率（如果启用线搜索）**
         double lr = strategy_->computeLearningRate(iter, y, currentPred, treePred);
         
-        // **步骤6: 向量化预测更新**
-        updatePredictionsVectorized(treePred, lr, currentPred);
+        // **步骤6: 融合内核 - 预测更新 + 下一轮损失 + 残差，一次遍历**
+        nextLoss = lossFunc->updatePredictionsAndGradients(
+            y, treePred.data(), lr, currentPred, residuals);
         
         // **步骤7: 添加树到模型**
         auto rootCopy = cloneTreeOptimized(treeTrainer->getRoot());
         model_.addTree(std::move(rootCopy), 1.0, lr);
         
+        // **步骤8: 验证集增量更新（只累加新树）**
+        if (hasValidation_) {
+            updateValidationPredictions(treeTrainer->getRoot(), lr);
+        }
+        
         auto iterEnd = std::chrono::high_resolution_clock::now();
         auto iterTime = std::chrono::duration_cast<std::chrono::milliseconds>(iterEnd - iterStart);
         
@@ -135,9 +145,17 @@ void GBRTTrainer::trainStandardOptimized(const std::vector<double>& X,
                       << " | Time: " << iterTime.count() << "ms" << std::endl;
         }
         
-        // **早停检查**
-        if (config_.earlyStoppingRounds > 0 && 
-            shouldEarlyStop(trainingLoss_, config_.earlyStoppingRounds)) {
+        // **早停检查: 有验证集时以验证损失为准**
+        if (hasValidation_) {
+            if (checkValidationEarlyStop(iter)) {
+                if (config_.verbose) {
+                    std::cout << "Early stopping at iteration " << iter
+                              << ", best iteration: " << bestIteration_ << std::endl;
+                }
+                break;
+            }
+        } else if (config_.earlyStoppingRounds > 0 && 
+                   shouldEarlyStop(trainingLoss_, config_.earlyStoppingRounds)) {
             if (config_.verbose) {
                 std::cout << "Early stopping at iteration " << iter << std::endl;
             }
@@ -165,6 +183,7 @@ void GBRTTrainer::trainWithDartOptimized(const std::vector<double>& X,
     std::vector<double> currentPred(n, baseScore);
     std::vector<double> residuals(n);
     std::vector<double> treePred(n);
+    initValidationPredictions(baseScore);
     
     // **DART专用缓冲区**
     std::vector<double> predBeforeDrop(n);
@@ -179,10 +198,12 @@ void GBRTTrainer::trainWithDartOptimized(const std::vector<double>& X,
         // **步骤1: 选择要丢弃的树**
         std::vector<int> droppedTrees;
         if (model_.getTreeCount() > 0) {
+            // 每轮独立的计数器型随机流：只由 dartSeed 与迭代序号决定
+            Philox dartRng(config_.dartSeed, {Philox::DART, static_cast<uint64_t>(iter)});
             droppedTrees = dartStrategy_->selectDroppedTrees(
                 static_cast<int>(model_.getTreeCount()), 
                 config_.dartDropRate, 
-                dartGen_);
+                dartRng);
         }
         
         if (config_.verbose && iter % 10 == 0 && !droppedTrees.empty()) {
@@ -195,13 +216,11 @@ void GBRTTrainer::trainWithDartOptimized(const std::vector<double>& X,
             computeDartPredictionsParallel(X, rowLength, droppedTrees, currentPred);
         }
         
-        // **步骤3: 计算当前损失**
-        double currentLoss = computeTotalLossParallel(y, currentPred);
+        // **步骤3-4: 融合计算当前损失与残差**
+        const double currentLoss = strategy_->getLossFunction()->updatePredictionsAndGradients(
+            y, nullptr, 0.0, currentPred, residuals);
         trainingLoss_.push_back(currentLoss);
         
-        // **步骤4: 计算残差**
-        computeResidualsParallel(y, currentPred, residuals);
-        
         // **步骤5: 训练新树**
         auto treeTrainer = createTreeTrainer();
         treeTrainer->train(X, rowLength, residuals);
@@ -216,13 +235,35 @@ void GBRTTrainer::trainWithDartOptimized(const std::vector<double>& X,
         auto rootCopy = cloneTreeOptimized(treeTrainer->getRoot());
         model_.addTree(std::move(rootCopy), 1.0, lr);
         
-        // **步骤9: DART权重更新**
+        // **步骤9: DART权重更新**（有验证集时先记下被丢弃树的旧权重）
         int newTreeIndex = static_cast<int>(model_.getTreeCount()) - 1;
+        std::vector<double> droppedWeightsBefore;
+        if (hasValidation_) {
+            for (int treeIdx : droppedTrees) {
+                droppedWeightsBefore.push_back(model_.getTrees()[treeIdx].weight);
+            }
+        }
         dartStrategy_->updateTreeWeights(model_.getTrees(), droppedTrees, newTreeIndex, lr);
         
         // **步骤10: 完整预测重计算（并行优化版）**
         recomputeFullPredictionsParallel(X, rowLength, currentPred);
         
+        // **步骤11: 验证集增量更新**：加入新树（按调整后的权重），
+        // 并补上被丢弃树的权重变化（ORIGINAL 等策略会缩放被丢弃的树）
+        if (hasValidation_) {
+            const auto& trees = model_.getTrees();
+            for (size_t k = 0; k < droppedTrees.size(); ++k) {
+                const auto& dropped = trees[droppedTrees[k]];
+                const double delta = dropped.weight - droppedWeightsBefore[k];
+                if (delta != 0.0) {
+                    updateValidationPredictions(dropped.tree.get(), dropped.learningRate * delta);
+                }
+            }
+            const auto& newTree = trees[newTreeIndex];
+            updateValidationPredictions(newTree.tree.get(),
+                                        newTree.learningRate * newTree.weight);
+        }
+        
         auto iterEnd = std::chrono::high_resolution_clock::now();
         auto iterTime = std::chrono::duration_cast<std::chrono::milliseconds>(iterEnd - iterStart);
         
@@ -233,9 +274,17 @@ void GBRTTrainer::trainWithDartOptimized(const std::vector<double>& X,
                       << " | Time: " << iterTime.count() << "ms" << std::endl;
         }
         
-        // **早停检查**
-        if (config_.earlyStoppingRounds > 0 && 
-            shouldEarlyStop(trainingLoss_, config_.earlyStoppingRounds)) {
+        // **早停检查: 有验证集时以验证损失为准**
+        if (hasValidation_) {
+            if (checkValidationEarlyStop(iter)) {
+                if (config_.verbose) {
+                    std::cout << "DART early stopping at iteration " << iter
+                              << ", best iteration: " << bestIteration_ << std::endl;
+                }
+                break;
+            }
+        } else if (config_.earlyStoppingRounds > 0 && 
+                   shouldEarlyStop(trainingLoss_, config_.earlyStoppingRounds)) {
             if (config_.verbose) {
                 std::cout << "DART early stopping at iteration " << iter << std::endl;
             }
@@ -259,34 +308,6 @@ double GBRTTrainer::computeBaseScoreParallel(const std::vector<double>& y) const
     return sum / n;
 }
 
-// **超高效并行损失计算**
-double GBRTTrainer::computeTotalLossParallel(const std::vector<double>& y,
-                                            const std::vector<double>& pred) const {
-    const size_t n = y.size();
-    double totalLoss = 0.0;
-    
-    // **使用更大的chunk size和static调度**
-    #pragma omp parallel for reduction(+:totalLoss) schedule(static, 4096) if(n > 2000)
-    for (size_t i = 0; i < n; ++i) {
-        totalLoss += strategy_->getLossFunction()->loss(y[i], pred[i]);
-    }
-    
-    return totalLoss / n;
-}
-
-// **超高效并行残差计算**
-void GBRTTrainer::computeResidualsParallel(const std::vector<double>& y,
-                                          const std::vector<double>& pred,
-                                          std::vector<double>& residuals) const {
-    const size_t n = y.size();
-    
-    // **向量化友好的并行计算**
-    #pragma omp parallel for schedule(static, 4096) if(n > 2000)
-    for (size_t i = 0; i < n; ++i) {
-        residuals[i] = strategy_->getLossFunction()->gradient(y[i], pred[i]);
-    }
-}
-
 // **优化的批量树预测**
 void GBRTTrainer::batchTreePredictOptimized(const SingleTreeTrainer* trainer,
                                            const std::vector<double>& X,
@@ -301,19 +322,6 @@ void GBRTTrainer::batchTreePredictOptimized(const SingleTreeTrainer* trainer,
     }
 }
 
-// **向量化预测更新**
-void GBRTTrainer::updatePredictionsVectorized(const std::vector<double>& treePred,
-                                              double lr,
-                                              std::vector<double>& predictions) const {
-    const size_t n = predictions.size();
-    
-    // **SIMD友好的向量化更新**
-    #pragma omp parallel for schedule(static, 4096) if(n > 2000)
-    for (size_t i = 0; i < n; ++i) {
-        predictions[i] += lr * treePred[i];
-    }
-}
-
 // **DART专用: 高效并行DART预测重计算**
 void GBRTTrainer::computeDartPredictionsParallel(const std::vector<double>& X,
                                                  int rowLength,
@@ -453,6 +461,45 @@ void GBRTTrainer::evaluate(const std::vector<double>& X,
     mae /= n;
 }
 
+void GBRTTrainer::trainOnView(const DatasetView& view) {
+    if (view.coversAll()) {
+        train(view.data(), view.numFeatures(), view.labels());
+        return;
+    }
+    std::vector<double> X, y;
+    view.materialize(X, y);
+    train(X, view.numFeatures(), y);
+}
+
+void GBRTTrainer::evaluateOnView(const DatasetView& view,
+                                 double& loss,
+                                 double& mse,
+                                 double& mae) {
+    const size_t n = view.size();
+    const int rowLength = view.numFeatures();
+    std::vector<double> y(n), predictions(n);
+    
+    #pragma omp parallel for schedule(static, 512) if(n > 1000)
+    for (size_t i = 0; i < n; ++i) {
+        y[i] = view.label(i);
+        predictions[i] = predict(view.sample(i), rowLength);
+    }
+    
+    loss = strategy_->computeTotalLoss(y, predictions);
+    mse = 0.0;
+    mae = 0.0;
+    
+    #pragma omp parallel for reduction(+:mse,mae) schedule(static, 2048) if(n > 2000)
+    for (size_t i = 0; i < n; ++i) {
+        double diff = y[i] - predictions[i];
+        mse += diff * diff;
+        mae += std::abs(diff);
+    }
+    
+    mse /= n;
+    mae /= n;
+}
+
 // **优化的早停检查**
 bool GBRTTrainer::shouldEarlyStop(const std::vector<double>& losses, int patience) const {
     if (static_cast<int>(losses.size()) < patience + 1) return false;
@@ -466,6 +513,71 @@ bool GBRTTrainer::shouldEarlyStop(const std::vector<double>& losses, int patienc
     return currentLoss >= bestLoss - config_.tolerance;
 }
 
+// **验证集预测初始化: 训练开始时只做一次**
+void GBRTTrainer::initValidationPredictions(double baseScore) {
+    validationLoss_.clear();
+    bestTreeWeights_.clear();
+    bestIteration_ = -1;
+    if (!hasValidation_) return;
+    
+    valPredictions_.assign(y_val_.size(), baseScore);
+    validationLoss_.reserve(config_.numIterations);
+}
+
+// **验证集增量更新: 只遍历最新的一棵树**
+void GBRTTrainer::updateValidationPredictions(const Node* tree, double factor) {
+    const size_t n = valPredictions_.size();
+    const int rowLength = valRowLength_;
+    
+    #pragma omp parallel for schedule(static, 1024) if(n > 1000)
+    for (size_t i = 0; i < n; ++i) {
+        valPredictions_[i] += factor * predictSingleTreeFast(tree, &X_val_[i * rowLength]);
+    }
+}
+
+// **记录验证损失，连续earlyStoppingRounds轮无改善时停止**
+bool GBRTTrainer::checkValidationEarlyStop(int iter) {
+    const double valLoss = computeValidationLoss(valPredictions_);
+    validationLoss_.push_back(valLoss);
+    
+    if (bestIteration_ < 0 || valLoss < bestValidationLoss_ - config_.tolerance) {
+        bestValidationLoss_ = valLoss;
+        bestIteration_ = iter;
+        // DART 之后的迭代会缩放已有树的权重：记下最佳迭代时的权重，回滚时恢复
+        if (dartStrategy_) {
+            const auto& trees = model_.getTrees();
+            bestTreeWeights_.resize(trees.size());
+            for (size_t t = 0; t < trees.size(); ++t) bestTreeWeights_[t] = trees[t].weight;
+        }
+        return false;
+    }
+    
+    return config_.earlyStoppingRounds > 0 && 
+           iter - bestIteration_ >= config_.earlyStoppingRounds;
+}
+
+// **回滚到最佳迭代**：无论是否提前停止，有验证集时最终模型都是验证损失最低的那一版
+void GBRTTrainer::rollbackToBestIteration() {
+    if (!hasValidation_ || bestIteration_ < 0) return;
+    
+    const size_t keep = static_cast<size_t>(bestIteration_) + 1;
+    const bool rolledBack = model_.getTreeCount() > keep;
+    model_.truncate(keep);
+    if (dartStrategy_ && bestTreeWeights_.size() == keep) {
+        auto& trees = model_.getTrees();
+        for (size_t t = 0; t < keep; ++t) trees[t].weight = bestTreeWeights_[t];
+    }
+    if (config_.verbose && rolledBack) {
+        std::cout << "Rolled back to best iteration " << bestIteration_
+                  << " (validation loss " << std::fixed << std::setprecision(6)
+                  << bestValidationLoss_ << ", " << keep << " trees)" << std::endl;
+    }
+}
+
+double GBRTTrainer::computeValidationLoss(const std::vector<double>& predictions) const {
+    return strategy_->getLossFunction()->computeBatchLoss(y_val_, predictions);
+}
+
 // **保留原有接口的简化实现**
 std::unique_ptr<SingleTreeTrainer> GBRTTrainer::createTreeTrainer() const {
     auto criterion = std::make_unique<MSECriterion>();
@@ -479,9 +591,22 @@ std::unique_ptr<SingleTreeTrainer> GBRTTrainer::createTreeTrainer() const {
 
 std::unique_ptr<IDartStrategy> GBRTTrainer::createDartStrategy() const {
     if (config_.dartStrategy == "uniform") {
+        DartWeightStrategy weightStrategy;
+        if (config_.dartWeightStrategy == "none") {
+            weightStrategy = DartWeightStrategy::NONE;
+        } else if (config_.dartWeightStrategy == "mild") {
+            weightStrategy = DartWeightStrategy::MILD;
+        } else if (config_.dartWeightStrategy == "original") {
+            weightStrategy = DartWeightStrategy::ORIGINAL;
+        } else if (config_.dartWeightStrategy == "experimental") {
+            weightStrategy = DartWeightStrategy::EXPERIMENTAL;
+        } else {
+            throw std::invalid_argument("Unsupported DART weight strategy: " + config_.dartWeightStrategy);
+        }
         return std::make_unique<UniformDartStrategy>(
             config_.dartNormalize, 
-            config_.dartSkipDropForPrediction);
+            config_.dartSkipDropForPrediction,
+            weightStrategy);
     } else {
         throw std::invalid_argument("Unsupported DART strategy: " + config_.dartStrategy);
     }
@@ -0,0 +1,299 @@
+// =============================================================================
+// src/functions/io/BinaryDataset.cpp - 二进制列存数据集缓存
+// =============================================================================
+#include "functions/io/BinaryDataset.hpp"
+#include "functions/io/MappedFile.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <sys/stat.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+
+constexpr char kMagic[8] = {'D', 'T', 'B', 'I', 'N', '0', '1', '\0'};
+constexpr uint64_t kAlignment = 64;
+
+inline uint64_t alignUp(uint64_t offset) {
+    return (offset + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+// 写到对齐位置（补零）
+void padTo(std::ofstream& out, uint64_t& written, uint64_t target) {
+    static const char zeros[kAlignment] = {};
+    while (written < target) {
+        const uint64_t n = std::min<uint64_t>(kAlignment, target - written);
+        out.write(zeros, static_cast<std::streamsize>(n));
+        written += n;
+    }
+}
+
+// FNV-1a 64 位
+uint64_t fnv1a(const char* data, size_t n, uint64_t hash) {
+    for (size_t i = 0; i < n; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+int64_t mtimeNanoseconds(const struct stat& st) {
+#if defined(__APPLE__)
+    return static_cast<int64_t>(st.st_mtimespec.tv_sec) * 1000000000LL + st.st_mtimespec.tv_nsec;
+#elif defined(__unix__)
+    return static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+#else
+    return static_cast<int64_t>(st.st_mtime) * 1000000000LL;
+#endif
+}
+
+} // namespace
+
+bool BinaryDataset::sourceSignature(const std::string& path, SourceSignature& signature) {
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0) return false;
+    signature.size = static_cast<uint64_t>(st.st_size);
+    signature.mtimeNs = mtimeNanoseconds(st);
+
+    // **内容哈希**：只读首尾两页，开销与文件大小无关
+    constexpr uint64_t kPage = 4096;
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return false;
+    char page[kPage];
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    const uint64_t head = std::min(kPage, signature.size);
+    in.read(page, static_cast<std::streamsize>(head));
+    hash = fnv1a(page, static_cast<size_t>(in.gcount()), hash);
+    if (signature.size > kPage) {
+        const uint64_t tailBegin = std::max(kPage, signature.size - kPage);
+        in.seekg(static_cast<std::streamoff>(tailBegin));
+        in.read(page, static_cast<std::streamsize>(signature.size - tailBegin));
+        hash = fnv1a(page, static_cast<size_t>(in.gcount()), hash);
+    }
+    signature.contentHash = hash;
+    return true;
+}
+
+BinaryDataset::~BinaryDataset() = default;
+
+std::unique_ptr<BinaryDataset> BinaryDataset::open(const std::string& path) {
+    auto file = std::make_unique<MappedFile>(path, /*sequential=*/false);
+    if (!file->isOpen() || file->size() < sizeof(BinaryDatasetHeader)) return nullptr;
+
+    std::unique_ptr<BinaryDataset> ds(new BinaryDataset());
+    std::memcpy(&ds->header_, file->data(), sizeof(BinaryDatasetHeader));
+    const auto& h = ds->header_;
+
+    // **完整性校验**：魔数、版本、各段范围都必须落在文件内
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || h.version != kVersion ||
+        h.fileSize != file->size()) {
+        return nullptr;
+    }
+    const uint64_t valueBytes = (h.flags & kFloat32) ? sizeof(float) : sizeof(double);
+    auto fits = [&](uint64_t offset, uint64_t bytes) {
+        return offset % kAlignment == 0 && offset <= h.fileSize && bytes <= h.fileSize - offset;
+    };
+    if (!fits(h.featuresOffset, h.rows * h.features * valueBytes) ||
+        !fits(h.labelsOffset, h.rows * sizeof(double)) ||
+        ((h.flags & kHasWeights) && !fits(h.weightsOffset, h.rows * sizeof(double))) ||
+        ((h.flags & kHasBins) && !fits(h.binsOffset, h.rows * h.features * sizeof(uint16_t)))) {
+        return nullptr;
+    }
+
+    ds->base_ = file->data();
+    ds->file_ = std::move(file);
+    return ds;
+}
+
+const double* BinaryDataset::featureColumn(size_t f) const {
+    if (isFloat32()) return nullptr;
+    return reinterpret_cast<const double*>(base_ + header_.featuresOffset) + f * header_.rows;
+}
+
+const float* BinaryDataset::featureColumnF32(size_t f) const {
+    if (!isFloat32()) return nullptr;
+    return reinterpret_cast<const float*>(base_ + header_.featuresOffset) + f * header_.rows;
+}
+
+const double* BinaryDataset::labels() const {
+    return reinterpret_cast<const double*>(base_ + header_.labelsOffset);
+}
+
+const double* BinaryDataset::weights() const {
+    return hasWeights() ? reinterpret_cast<const double*>(base_ + header_.weightsOffset) : nullptr;
+}
+
+const uint16_t* BinaryDataset::binColumn(size_t f) const {
+    if (!hasBins()) return nullptr;
+    return reinterpret_cast<const uint16_t*>(base_ + header_.binsOffset) + f * header_.rows;
+}
+
+namespace {
+
+// 行存 → 列存写出；T 为内存中的特征类型，文件中的精度由 options.float32 决定
+template <typename T>
+bool writeDataset(const std::string& path,
+                  const std::vector<T>& X,
+                  const std::vector<double>& y,
+                  size_t numFeatures,
+                  const BinaryDataset::WriteOptions& options) {
+    const uint64_t n = y.size();
+    const uint64_t d = numFeatures;
+    if (X.size() != n * d) return false;
+    if (options.weights && options.weights->size() != n) return false;
+    if (options.bins && options.bins->size() != n * d) return false;
+
+    BinaryDatasetHeader h{};
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = BinaryDataset::kVersion;
+    h.flags = (options.float32 ? BinaryDataset::kFloat32 : 0u) |
+              (options.weights ? BinaryDataset::kHasWeights : 0u) |
+              (options.bins ? BinaryDataset::kHasBins : 0u);
+    h.rows = n;
+    h.features = d;
+    h.sourceSize = options.source.size;
+    h.sourceMtime = options.source.mtimeNs;
+    h.sourceHash = options.source.contentHash;
+    h.numBins = options.bins ? options.numBins : 0;
+
+    const uint64_t valueBytes = options.float32 ? sizeof(float) : sizeof(double);
+    h.featuresOffset = alignUp(sizeof(BinaryDatasetHeader));
+    h.labelsOffset = alignUp(h.featuresOffset + n * d * valueBytes);
+    // 只对各段起点对齐，文件在最后一段末尾结束（不补尾部填充）
+    uint64_t end = h.labelsOffset + n * sizeof(double);
+    if (options.weights) {
+        h.weightsOffset = alignUp(end);
+        end = h.weightsOffset + n * sizeof(double);
+    }
+    if (options.bins) {
+        h.binsOffset = alignUp(end);
+        end = h.binsOffset + n * d * sizeof(uint16_t);
+    }
+    h.fileSize = end;
+
+#ifdef DATAIO_HAS_MMAP
+    const std::string tmpPath = path + ".tmp." + std::to_string(::getpid());
+#else
+    const std::string tmpPath = path + ".tmp";
+#endif
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) return false;
+
+    uint64_t written = 0;
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    written += sizeof(h);
+
+    // 特征按列分段写出（行存 → 列存），缓冲固定大小
+    padTo(out, written, h.featuresOffset);
+    constexpr size_t kChunk = 1 << 16;
+    std::vector<double> colBuf;
+    std::vector<float> colBufF32;
+    for (uint64_t f = 0; f < d; ++f) {
+        for (uint64_t lo = 0; lo < n; lo += kChunk) {
+            const uint64_t hi = std::min<uint64_t>(n, lo + kChunk);
+            if (options.float32) {
+                colBufF32.resize(hi - lo);
+                for (uint64_t i = lo; i < hi; ++i) colBufF32[i - lo] = static_cast<float>(X[i * d + f]);
+                out.write(reinterpret_cast<const char*>(colBufF32.data()),
+                          static_cast<std::streamsize>(colBufF32.size() * sizeof(float)));
+            } else {
+                colBuf.resize(hi - lo);
+                for (uint64_t i = lo; i < hi; ++i) colBuf[i - lo] = static_cast<double>(X[i * d + f]);
+                out.write(reinterpret_cast<const char*>(colBuf.data()),
+                          static_cast<std::streamsize>(colBuf.size() * sizeof(double)));
+            }
+        }
+    }
+    written += n * d * valueBytes;
+
+    padTo(out, written, h.labelsOffset);
+    out.write(reinterpret_cast<const char*>(y.data()), static_cast<std::streamsize>(n * sizeof(double)));
+    written += n * sizeof(double);
+
+    if (options.weights) {
+        padTo(out, written, h.weightsOffset);
+        out.write(reinterpret_cast<const char*>(options.weights->data()),
+                  static_cast<std::streamsize>(n * sizeof(double)));
+        written += n * sizeof(double);
+    }
+    if (options.bins) {
+        padTo(out, written, h.binsOffset);
+        out.write(reinterpret_cast<const char*>(options.bins->data()),
+                  static_cast<std::streamsize>(n * d * sizeof(uint16_t)));
+        written += n * d * sizeof(uint16_t);
+    }
+
+    out.close();
+    if (!out || written != h.fileSize) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+// 分块转置行 [rowBegin, rowEnd)：每块行在各列上连续读取，写入保持在缓存内
+template <typename T>
+void transposeToRowMajor(const BinaryDataset& ds, std::vector<T>& X,
+                         size_t rowBegin, size_t rowEnd) {
+    const size_t n = rowEnd - rowBegin;
+    const size_t d = ds.features();
+    X.resize(n * d);
+
+    constexpr size_t kBlock = 256;
+    const size_t numBlocks = (n + kBlock - 1) / kBlock;
+    const bool f32 = ds.isFloat32();
+
+    #pragma omp parallel for schedule(static) if(n * d > 100000)
+    for (size_t blk = 0; blk < numBlocks; ++blk) {
+        const size_t lo = blk * kBlock;
+        const size_t hi = std::min(n, lo + kBlock);
+        for (size_t f = 0; f < d; ++f) {
+            if (f32) {
+                const float* col = ds.featureColumnF32(f) + rowBegin;
+                for (size_t i = lo; i < hi; ++i) X[i * d + f] = static_cast<T>(col[i]);
+            } else {
+                const double* col = ds.featureColumn(f) + rowBegin;
+                for (size_t i = lo; i < hi; ++i) X[i * d + f] = static_cast<T>(col[i]);
+            }
+        }
+    }
+}
+
+} // namespace
+
+void BinaryDataset::toRowMajor(std::vector<double>& X) const {
+    transposeToRowMajor(*this, X, 0, rows());
+}
+
+void BinaryDataset::toRowMajor(std::vector<float>& X) const {
+    transposeToRowMajor(*this, X, 0, rows());
+}
+
+void BinaryDataset::toRowMajor(std::vector<double>& X, size_t rowBegin, size_t rowEnd) const {
+    transposeToRowMajor(*this, X, rowBegin, std::max(rowBegin, std::min(rowEnd, rows())));
+}
+
+bool BinaryDataset::write(const std::string& path,
+                          const std::vector<double>& X,
+                          const std::vector<double>& y,
+                          size_t numFeatures,
+                          const WriteOptions& options) {
+    return writeDataset(path, X, y, numFeatures, options);
+}
+
+bool BinaryDataset::write(const std::string& path,
+                          const std::vector<float>& X,
+                          const std::vector<double>& y,
+                          size_t numFeatures,
+                          const WriteOptions& options) {
+    return writeDataset(path, X, y, numFeatures, options);
+}
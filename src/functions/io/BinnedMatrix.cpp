@@ -0,0 +1,213 @@
+// =============================================================================
+// src/functions/io/BinnedMatrix.cpp - 流式分桶矩阵（两遍扫描 + 可选磁盘溢写）
+// =============================================================================
+#include "functions/io/BinnedMatrix.hpp"
+#include "functions/io/DataIO.hpp"
+#include "functions/io/MappedFile.hpp"
+#include "histogram/QuantileSketch.hpp"
+#include "pipeline/DatasetView.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+void FeatureBinning::initEqualWidth(double minValue, double maxValue, int maxBins) {
+    constexpr double EPS = 1e-12;
+    vMin = minValue;
+    upper.clear();
+    // 无数据或常数特征：单桶
+    if (!(maxValue - minValue >= EPS)) {
+        width = 0.0;
+        bins = 1;
+        return;
+    }
+    bins = maxBins;
+    width = (maxValue - minValue) / bins;
+    upper.resize(bins);
+    for (int b = 0; b < bins - 1; ++b) upper[b] = minValue + (b + 1) * width;
+    upper[bins - 1] = maxValue;
+}
+
+void FeatureBinning::initFromCuts(const std::vector<double>& cuts, double minValue, double maxValue) {
+    vMin = minValue;
+    width = 0.0;
+    upper.clear();
+    // 切点为空（常数或几乎全部相同的特征）时单桶
+    if (cuts.empty() || !(maxValue > minValue)) {
+        bins = 1;
+        return;
+    }
+    upper = cuts;
+    upper.push_back(maxValue);
+    bins = static_cast<int>(upper.size());
+}
+
+BinnedMatrix::~BinnedMatrix() {
+    if (spill_) {
+        spill_.reset();
+        std::remove(spillPath_.c_str());
+    }
+}
+
+std::unique_ptr<BinnedMatrix> BinnedMatrix::fromCSV(const std::string& filename,
+                                                    int maxBins,
+                                                    size_t batchRows,
+                                                    const std::string& spillPath,
+                                                    bool equalFrequency) {
+    DataIO::CSVReader reader(filename);
+    const int d = reader.numFeatures();
+    if (d <= 0) return nullptr;
+    batchRows = std::max<size_t>(batchRows, 1);
+
+    std::unique_ptr<BinnedMatrix> m(new BinnedMatrix());
+    m->features_ = d;
+    m->maxBins_ = std::clamp(maxBins, 2, 65535);     // 桶号以 uint16_t 存储
+    m->equalFrequency_ = equalFrequency;
+
+    std::vector<double> X, y;
+
+    // **第 1 遍**：各批并行统计特征摘要，再合并到全局摘要
+    std::vector<FeatureRangeSketch> ranges(d);
+    std::vector<QuantileSketch> quantiles;
+    if (equalFrequency) quantiles.assign(d, QuantileSketch());
+    size_t n = 0;
+    while (size_t rows = reader.readBatch(X, y, batchRows)) {
+        #pragma omp parallel for schedule(static) if(d > 1 && rows > 2000)
+        for (int f = 0; f < d; ++f) {
+            FeatureRangeSketch local;
+            for (size_t i = 0; i < rows; ++i) local.add(X[i * d + f]);
+            ranges[f].merge(local);
+            if (equalFrequency) {
+                for (size_t i = 0; i < rows; ++i) quantiles[f].add(X[i * d + f]);
+            }
+        }
+        n += rows;
+    }
+    if (n == 0) return nullptr;
+
+    m->rows_ = n;
+    m->binnings_.resize(d);
+    for (int f = 0; f < d; ++f) {
+        if (equalFrequency) {
+            m->binnings_[f].initFromCuts(quantiles[f].cutPoints(m->maxBins_), ranges[f].min, ranges[f].max);
+        } else {
+            m->binnings_[f].initEqualWidth(ranges[f].min, ranges[f].max, m->maxBins_);
+        }
+    }
+    quantiles.clear();
+
+    // **第 2 遍**：分桶后按列段写入内存矩阵或溢写文件
+    const bool spill = !spillPath.empty();
+    std::ofstream out;
+    std::vector<uint16_t> batchBins;
+    if (spill) {
+        out.open(spillPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            throw std::runtime_error("Unable to open spill file: " + spillPath);
+        }
+        batchBins.resize(static_cast<size_t>(d) * batchRows);
+    } else {
+        m->memoryBins_.resize(static_cast<size_t>(d) * n);
+    }
+    m->labels_.reserve(n);
+
+    reader.reset();
+    size_t rowStart = 0;
+    while (size_t rows = reader.readBatch(X, y, batchRows)) {
+        rows = std::min(rows, n - rowStart);     // 两遍之间文件被追加时以第 1 遍为准
+        m->labels_.insert(m->labels_.end(), y.begin(), y.begin() + rows);
+
+        #pragma omp parallel for schedule(static) if(d > 1 && rows > 2000)
+        for (int f = 0; f < d; ++f) {
+            const FeatureBinning& binning = m->binnings_[f];
+            uint16_t* dst = spill ? &batchBins[static_cast<size_t>(f) * rows]
+                                  : &m->memoryBins_[static_cast<size_t>(f) * n + rowStart];
+            for (size_t i = 0; i < rows; ++i) dst[i] = binning.index(X[i * d + f]);
+        }
+
+        if (spill) {
+            for (int f = 0; f < d; ++f) {
+                out.seekp(static_cast<std::streamoff>((static_cast<size_t>(f) * n + rowStart) * sizeof(uint16_t)));
+                out.write(reinterpret_cast<const char*>(&batchBins[static_cast<size_t>(f) * rows]),
+                          static_cast<std::streamsize>(rows * sizeof(uint16_t)));
+            }
+        }
+        rowStart += rows;
+        if (rowStart == n) break;
+    }
+    if (rowStart != n) {
+        if (spill) std::remove(spillPath.c_str());
+        throw std::runtime_error("File changed while streaming: " + filename);
+    }
+
+    if (spill) {
+        out.close();
+        if (!out) {
+            std::remove(spillPath.c_str());
+            throw std::runtime_error("Failed to write spill file: " + spillPath);
+        }
+        m->spillPath_ = spillPath;
+        m->spill_ = std::make_unique<MappedFile>(spillPath, /*sequential=*/false);
+        if (!m->spill_->isOpen() || m->spill_->size() != static_cast<size_t>(d) * n * sizeof(uint16_t)) {
+            throw std::runtime_error("Unable to map spill file: " + spillPath);
+        }
+        m->base_ = reinterpret_cast<const uint16_t*>(m->spill_->data());
+    } else {
+        m->base_ = m->memoryBins_.data();
+    }
+
+    std::cout << "Streamed " << n << " samples with " << d << " features into "
+              << m->maxBins_ << "-bin " << (equalFrequency ? "equal-frequency" : "equal-width")
+              << " matrix ("
+              << (spill ? "disk: " + spillPath : std::string("memory")) << ")" << std::endl;
+    return m;
+}
+
+template <typename T>
+std::unique_ptr<BinnedMatrix> BinnedMatrix::fromView(const BasicDatasetView<T>& view,
+                                                     int maxBins,
+                                                     bool equalFrequency) {
+    const int d = view.numFeatures();
+    const size_t n = view.size();
+    if (d <= 0 || n == 0) return nullptr;
+
+    std::unique_ptr<BinnedMatrix> m(new BinnedMatrix());
+    m->features_ = d;
+    m->rows_ = n;
+    m->maxBins_ = std::clamp(maxBins, 2, 65535);
+    m->equalFrequency_ = equalFrequency;
+    m->binnings_.resize(d);
+    m->memoryBins_.resize(static_cast<size_t>(d) * n);
+
+    // 每个特征独立：统计摘要 → 分桶 → 写入本列，列间无共享状态
+    #pragma omp parallel for schedule(dynamic) if(d > 1 && n > 2000)
+    for (int f = 0; f < d; ++f) {
+        FeatureRangeSketch range;
+        for (size_t i = 0; i < n; ++i) range.add(static_cast<double>(view.sample(i)[f]));
+
+        FeatureBinning& binning = m->binnings_[f];
+        if (equalFrequency) {
+            QuantileSketch sketch;
+            for (size_t i = 0; i < n; ++i) sketch.add(static_cast<double>(view.sample(i)[f]));
+            binning.initFromCuts(sketch.cutPoints(m->maxBins_), range.min, range.max);
+        } else {
+            binning.initEqualWidth(range.min, range.max, m->maxBins_);
+        }
+
+        uint16_t* dst = &m->memoryBins_[static_cast<size_t>(f) * n];
+        for (size_t i = 0; i < n; ++i) dst[i] = binning.index(static_cast<double>(view.sample(i)[f]));
+    }
+
+    m->labels_.resize(n);
+    for (size_t i = 0; i < n; ++i) m->labels_[i] = view.label(i);
+    m->base_ = m->memoryBins_.data();
+    return m;
+}
+
+// 显式实例化：double 与 float 特征
+template std::unique_ptr<BinnedMatrix> BinnedMatrix::fromView(const BasicDatasetView<double>&, int, bool);
+template std::unique_ptr<BinnedMatrix> BinnedMatrix::fromView(const BasicDatasetView<float>&, int, bool);
@@ -1,125 +1,654 @@
 // =============================================================================
-// src/functions/io/DataIO.cpp - 优化版本（避免不必要的vector拷贝）
+// src/functions/io/DataIO.cpp - 优化版本（内存映射 + 并行 from_chars 解析）
 // =============================================================================
 #include "functions/io/DataIO.hpp"
+#include "functions/io/MappedFile.hpp"
+#include "functions/io/BinaryDataset.hpp"
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <algorithm>
 #include <memory>
 #include <cmath>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <system_error>
 #include <utility>
 #include <iomanip>
 #include <stdexcept>    
 #include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#ifdef DATAIO_HAS_MMAP
+#include <glob.h>
+#endif
 
+namespace {
+
+// 下一行起始位置（跳过 '\n'），无换行时返回 end
+inline const char* nextLine(const char* p, const char* end) {
+    const void* nl = std::memchr(p, '\n', static_cast<size_t>(end - p));
+    return nl ? static_cast<const char*>(nl) + 1 : end;
+}
+
+// 逐行遍历 [begin, end)，去掉行尾 '\r'，跳过空行
+template <typename Fn>
+inline void forEachLine(const char* begin, const char* end, Fn&& fn) {
+    while (begin < end) {
+        const void* nl = std::memchr(begin, '\n', static_cast<size_t>(end - begin));
+        const char* lineEnd = nl ? static_cast<const char*>(nl) : end;
+        const char* next = nl ? lineEnd + 1 : end;
+        if (lineEnd > begin && lineEnd[-1] == '\r') --lineEnd;
+        if (lineEnd > begin) fn(begin, lineEnd);
+        begin = next;
+    }
+}
+
+// 跳过 count 个非空行，返回之后的位置
+inline const char* skipLines(const char* p, const char* end, size_t count) {
+    while (count > 0 && p < end) {
+        const void* nl = std::memchr(p, '\n', static_cast<size_t>(end - p));
+        const char* lineEnd = nl ? static_cast<const char*>(nl) : end;
+        const char* next = nl ? lineEnd + 1 : end;
+        if (lineEnd > p && lineEnd[-1] == '\r') --lineEnd;
+        if (lineEnd > p) --count;
+        p = next;
+    }
+    return p;
+}
+
+// 解析单个数值：与 std::stod 一样跳过前导空白与 '+'，解析失败告警并取 0.0
+inline double parseValue(const char* begin, const char* end, std::vector<std::string>& warnings) {
+    const char* p = begin;
+    while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    if (p + 1 < end && *p == '+' && p[1] != '-') ++p;
+
+    double value = 0.0;
+    const auto [ptr, ec] = std::from_chars(p, end, value);
+    if (ec == std::errc()) return value;
+
+    // 告警文本与原 std::stod 路径一致（libstdc++ 两类异常的 what() 均为 "stod"）
+    std::ostringstream msg;
+    msg << "Warning: Failed to parse value '" << std::string(begin, end)
+        << "' as double: stod";
+    warnings.push_back(msg.str());
+    return 0.0;
+}
+
+// 按逗号切分一行（末尾逗号不产生空字段，与 std::getline 行为一致）
+inline void parseLine(const char* begin, const char* end,
+                      std::vector<double>& row, std::vector<std::string>& warnings) {
+    row.clear();
+    const char* p = begin;
+    while (p < end) {
+        const void* comma = std::memchr(p, ',', static_cast<size_t>(end - p));
+        const char* fieldEnd = comma ? static_cast<const char*>(comma) : end;
+        row.push_back(parseValue(p, fieldEnd, warnings));
+        p = comma ? fieldEnd + 1 : end;
+    }
+}
+
+// 统计字段数（用于确定列数）
+inline size_t countFields(const char* begin, const char* end) {
+    size_t fields = 0;
+    const char* p = begin;
+    while (p < end) {
+        const void* comma = std::memchr(p, ',', static_cast<size_t>(end - p));
+        ++fields;
+        p = comma ? static_cast<const char*>(comma) + 1 : end;
+    }
+    return fields;
+}
+
+// 行缓冲写入扁平数组：最后一列为标签，缺失特征补 0；T 为特征存储类型
+template <typename T>
+inline void storeRow(const std::vector<double>& row, size_t featuresPerRow,
+                     T* featureDst, double* labelDst) {
+    *labelDst = row.back();
+    const size_t available = std::min(row.size() - 1, featuresPerRow);
+    std::transform(row.begin(), row.begin() + available, featureDst,
+                   [](double v) { return static_cast<T>(v); });
+    std::fill(featureDst + available, featureDst + featuresPerRow, T(0));
+}
+
+// 换行对齐的分块边界（每块至少约 1MB，块数不超过线程数 × 4），返回块数 + 1 个边界
+std::vector<const char*> chunkBounds(const char* begin, const char* end) {
+    const size_t bytes = static_cast<size_t>(end - begin);
+#ifdef _OPENMP
+    const size_t maxChunks = static_cast<size_t>(omp_get_max_threads()) * 4;
+#else
+    const size_t maxChunks = 1;
+#endif
+    const size_t numChunks = std::max<size_t>(1, std::min(maxChunks, bytes >> 20));
+    std::vector<const char*> bounds(numChunks + 1, end);
+    bounds[0] = begin;
+    for (size_t k = 1; k < numChunks; ++k) {
+        const char* guess = begin + bytes * k / numChunks;
+        bounds[k] = std::max(bounds[k - 1], nextLine(guess - 1, end));
+    }
+    return bounds;
+}
+
+// 投影解析一行：slot[j] 为第 j 个字段的去向（>= 0 特征列，kLabelSlot 标签，kSkipSlot 跳过）
+// 跳过的字段只定位逗号，不做数值转换；缺失的所选字段保持 0
+constexpr int kSkipSlot = -1;
+constexpr int kLabelSlot = -2;
+
+inline size_t parseProjectedLine(const char* begin, const char* end,
+                                 const std::vector<int>& slot,
+                                 double* featureDst, double* labelDst,
+                                 std::vector<std::string>& warnings) {
+    size_t field = 0;
+    const char* p = begin;
+    while (p < end) {
+        const void* comma = std::memchr(p, ',', static_cast<size_t>(end - p));
+        const char* fieldEnd = comma ? static_cast<const char*>(comma) : end;
+        const int target = field < slot.size() ? slot[field] : kSkipSlot;
+        if (target >= 0) {
+            featureDst[target] = parseValue(p, fieldEnd, warnings);
+        } else if (target == kLabelSlot) {
+            *labelDst = parseValue(p, fieldEnd, warnings);
+        }
+        ++field;
+        p = comma ? fieldEnd + 1 : end;
+    }
+    return field;
+}
+
+// 表头列名（去掉行尾 '\r' 与各名首尾空白）
+std::vector<std::string> parseHeader(const char* begin, const char* end) {
+    const char* lineEnd = nextLine(begin, end);
+    if (lineEnd > begin && lineEnd[-1] == '\n') --lineEnd;
+    if (lineEnd > begin && lineEnd[-1] == '\r') --lineEnd;
+    std::vector<std::string> names;
+    const char* p = begin;
+    while (p < lineEnd) {
+        const void* comma = std::memchr(p, ',', static_cast<size_t>(lineEnd - p));
+        const char* fieldEnd = comma ? static_cast<const char*>(comma) : lineEnd;
+        const char* b = p;
+        const char* e = fieldEnd;
+        while (b < e && (*b == ' ' || *b == '\t')) ++b;
+        while (e > b && (e[-1] == ' ' || e[-1] == '\t')) --e;
+        names.emplace_back(b, e);
+        p = comma ? fieldEnd + 1 : lineEnd;
+    }
+    return names;
+}
+
+// **并行解析 [begin, end) 的 CSV 正文**：按换行对齐分块，先计数再就地解析
+template <typename T>
+size_t parseCSVBody(const char* begin, const char* end,
+                    std::vector<T>& flattenedFeatures,
+                    std::vector<double>& labels,
+                    size_t& featuresPerRow) {
+    flattenedFeatures.clear();
+    labels.clear();
+    featuresPerRow = 0;
+
+    // 首个非空行确定列数
+    size_t columns = 0;
+    forEachLine(begin, end, [&](const char* lb, const char* le) {
+        if (columns == 0) columns = countFields(lb, le);
+    });
+    if (columns == 0) return 0;
+    featuresPerRow = columns - 1;
+
+    const std::vector<const char*> bounds = chunkBounds(begin, end);
+    const size_t numChunks = bounds.size() - 1;
+
+    // 阶段1：各块行数 → 前缀和得到行偏移
+    std::vector<size_t> rowOffset(numChunks + 1, 0);
+    #pragma omp parallel for schedule(dynamic) if(numChunks > 1)
+    for (size_t k = 0; k < numChunks; ++k) {
+        size_t rows = 0;
+        forEachLine(bounds[k], bounds[k + 1], [&](const char*, const char*) { ++rows; });
+        rowOffset[k + 1] = rows;
+    }
+    for (size_t k = 0; k < numChunks; ++k) rowOffset[k + 1] += rowOffset[k];
+    const size_t totalRows = rowOffset[numChunks];
+
+    flattenedFeatures.resize(totalRows * featuresPerRow);
+    labels.resize(totalRows);
+
+    // 阶段2：各块直接写入预分配数组，告警按块收集后顺序输出
+    std::vector<std::vector<std::string>> chunkWarnings(numChunks);
+    #pragma omp parallel if(numChunks > 1)
+    {
+        std::vector<double> row;
+        row.reserve(columns);
+
+        #pragma omp for schedule(dynamic)
+        for (size_t k = 0; k < numChunks; ++k) {
+            size_t r = rowOffset[k];
+            auto& warnings = chunkWarnings[k];
+            forEachLine(bounds[k], bounds[k + 1], [&](const char* lb, const char* le) {
+                parseLine(lb, le, row, warnings);
+                if (row.size() != columns) {
+                    warnings.push_back("Warning: Row " + std::to_string(r + 1) + " has " +
+                                       std::to_string(row.size()) + " values, expected " +
+                                       std::to_string(columns));
+                }
+                storeRow(row, featuresPerRow, &flattenedFeatures[r * featuresPerRow], &labels[r]);
+                ++r;
+            });
+        }
+    }
+
+    for (const auto& warnings : chunkWarnings) {
+        for (const auto& w : warnings) std::cerr << w << std::endl;
+    }
+    return totalRows;
+}
+
+// 结果文本格式：定点 10 位小数（与 std::fixed + precision(10) 相同）
+constexpr int kResultPrecision = 10;
+
+// 格式化一块结果到 buf（每值一行）
+void formatFixedChunk(const double* values, size_t count, std::string& buf) {
+    buf.clear();
+    buf.reserve(count * 16);
+    char tmp[384];              // 定点格式下 double 最长约 309 位整数 + 小数部分
+    for (size_t i = 0; i < count; ++i) {
+        const auto res = std::to_chars(tmp, tmp + sizeof(tmp), values[i],
+                                       std::chars_format::fixed, kResultPrecision);
+        buf.append(tmp, res.ptr);
+        buf.push_back('\n');
+    }
+}
+
+// 二进制结果文件：头部 + float64 / float32[count]
+constexpr char kResultsMagic[8] = {'D', 'T', 'R', 'E', 'S', '0', '1', '\0'};
+constexpr uint32_t kResultsVersion = 1;
+constexpr uint32_t kResultsFloat32 = 1u << 0;
+
+struct ResultsHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t count;
+};
+
+// 路径以 .dtbin 结尾：直接给出的二进制数据集（而非 CSV）
+inline bool isBinaryDatasetPath(const std::string& filename) {
+    const std::string suffix = ".dtbin";
+    return filename.size() > suffix.size() &&
+           filename.compare(filename.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // namespace
 
 std::pair<std::vector<double>, std::vector<double>>
 DataIO::readCSV(const std::string& filename, int& rowLength) {
     std::vector<double> flattenedFeatures;
     std::vector<double> labels;
-    
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Unable to open file: " << filename << std::endl;
+
+    // **直接给出 .dtbin**：与 readCSVShard 一致，映射后整体转置
+    if (isBinaryDatasetPath(filename)) {
+        auto binary = BinaryDataset::open(filename);
+        if (!binary) {
+            std::cerr << "Unable to open binary dataset: " << filename << std::endl;
+            rowLength = 0;
+            return {};
+        }
+        binary->toRowMajor(flattenedFeatures);
+        labels.assign(binary->labels(), binary->labels() + binary->rows());
+        rowLength = labels.empty() ? 0 : static_cast<int>(binary->features()) + 1; // +1 for label
+        std::cout << "Loaded " << labels.size() << " samples with "
+                  << (rowLength - 1) << " features each (binary dataset)" << std::endl;
+        return {std::move(flattenedFeatures), std::move(labels)};
+    }
+
+    // **二进制缓存**：源 CSV 未变化时直接映射列存矩阵，跳过文本解析
+    SourceSignature source;
+    const bool cacheable = binaryCacheEnabled_ && BinaryDataset::sourceSignature(filename, source);
+    const std::string cachePath = binaryCachePath(filename);
+
+    if (cacheable) {
+        auto cached = BinaryDataset::open(cachePath);
+        if (cached && cached->matchesSource(source) && cached->rows() > 0) {
+            cached->toRowMajor(flattenedFeatures);
+            labels.assign(cached->labels(), cached->labels() + cached->rows());
+            rowLength = static_cast<int>(cached->features()) + 1; // +1 for label
+            std::cout << "Loaded " << labels.size() << " samples with "
+                      << (rowLength - 1) << " features each (binary cache)" << std::endl;
+            return {std::move(flattenedFeatures), std::move(labels)};
+        }
+    }
+
+    readCSVMemoryMapped(filename, flattenedFeatures, labels, rowLength);
+
+    // 首次解析后写出缓存；写失败（如只读目录）不影响本次加载
+    if (cacheable && !labels.empty() && rowLength > 1) {
+        BinaryDataset::WriteOptions options;
+        options.source = source;
+        BinaryDataset::write(cachePath, flattenedFeatures, labels,
+                             static_cast<size_t>(rowLength - 1), options);
+    }
+    return {std::move(flattenedFeatures), std::move(labels)};
+}
+
+std::pair<std::vector<double>, std::vector<double>>
+DataIO::readCSVShard(const std::string& filename, int shard, int numShards, int& rowLength) {
+    std::vector<double> flattenedFeatures;
+    std::vector<double> labels;
+    rowLength = 0;
+    if (numShards <= 0 || shard < 0 || shard >= numShards) return {};
+
+    // **二进制数据集**：直接给出 .dtbin，或源 CSV 旁有有效缓存时按行切片
+    std::unique_ptr<BinaryDataset> binary;
+    if (isBinaryDatasetPath(filename)) {
+        binary = BinaryDataset::open(filename);
+        if (!binary) {
+            std::cerr << "Unable to open binary dataset: " << filename << std::endl;
+            return {};
+        }
+    } else if (binaryCacheEnabled_) {
+        SourceSignature source;
+        if (BinaryDataset::sourceSignature(filename, source)) {
+            binary = BinaryDataset::open(binaryCachePath(filename));
+            if (binary && !binary->matchesSource(source)) binary.reset();
+        }
+    }
+    if (binary) {
+        const size_t n = binary->rows();
+        const size_t lo = n * shard / numShards;
+        const size_t hi = n * (shard + 1) / numShards;
+        binary->toRowMajor(flattenedFeatures, lo, hi);
+        labels.assign(binary->labels() + lo, binary->labels() + hi);
+        if (!labels.empty()) rowLength = static_cast<int>(binary->features()) + 1; // +1 for label
         return {std::move(flattenedFeatures), std::move(labels)};
     }
 
-    std::string line;
-    bool headerSkipped = false;
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+        std::cerr << "Unable to open file: " << filename << std::endl;
+        return {};
+    }
+    const char* begin = file.data();
+    const char* end = begin + file.size();
+    if (!begin) return {};
+    begin = nextLine(begin, end);  // 跳过表头
+
+    // 字节区间对齐到行首：p 不在正文开头时前移到 p-1 之后的第一个行首
+    const size_t bodySize = static_cast<size_t>(end - begin);
+    const auto alignToLine = [&](size_t offset) {
+        const char* p = begin + offset;
+        return (p == begin || p >= end) ? p : nextLine(p - 1, end);
+    };
+    const char* lo = alignToLine(bodySize * shard / numShards);
+    const char* hi = alignToLine(bodySize * (shard + 1) / numShards);
+
+    size_t featuresPerRow = 0;
+    const size_t rows = lo < hi ? parseCSVBody(lo, hi, flattenedFeatures, labels, featuresPerRow) : 0;
+    if (rows > 0 && featuresPerRow > 0) {
+        rowLength = static_cast<int>(featuresPerRow) + 1; // +1 for label
+    }
+    return {std::move(flattenedFeatures), std::move(labels)};
+}
+
+std::pair<std::vector<float>, std::vector<double>>
+DataIO::readCSVFloat(const std::string& filename, int& rowLength) {
+    std::vector<float> flattenedFeatures;
+    std::vector<double> labels;
     rowLength = 0;
 
-    // **优化1: 预分配容器大小估算**
-    // 先快速扫描文件获取行数估算
-    const auto initialPos = file.tellg();
-    size_t estimatedRows = 0;
-    while (std::getline(file, line)) {
-        ++estimatedRows;
+    SourceSignature source;
+    const bool cacheable = binaryCacheEnabled_ && BinaryDataset::sourceSignature(filename, source);
+    const std::string cachePath = binaryCachePathF32(filename);
+
+    // **缓存优先级**：float32 缓存 → float64 缓存（逐值收窄）→ 解析 CSV
+    if (cacheable) {
+        for (const std::string& path : {cachePath, binaryCachePath(filename)}) {
+            auto cached = BinaryDataset::open(path);
+            if (cached && cached->matchesSource(source) && cached->rows() > 0) {
+                cached->toRowMajor(flattenedFeatures);
+                labels.assign(cached->labels(), cached->labels() + cached->rows());
+                rowLength = static_cast<int>(cached->features()) + 1; // +1 for label
+                std::cout << "Loaded " << labels.size() << " samples with "
+                          << (rowLength - 1) << " float32 features each (binary cache)" << std::endl;
+                return {std::move(flattenedFeatures), std::move(labels)};
+            }
+        }
     }
-    file.clear();
-    file.seekg(initialPos);
-    
-    if (estimatedRows > 1) { // 减去头部行
-        --estimatedRows;
-        labels.reserve(estimatedRows);
-        // 特征数量在读取第一行后确定
+
+    // 直接解析为 float：不经过完整的 double 矩阵
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+        std::cerr << "Unable to open file: " << filename << std::endl;
+        return {std::move(flattenedFeatures), std::move(labels)};
     }
+    const char* begin = file.data();
+    const char* end = begin + file.size();
+    if (begin) begin = nextLine(begin, end);
 
-    while (std::getline(file, line)) {
-        if (!headerSkipped) {
-            headerSkipped = true;
-            continue;
+    size_t featuresPerRow = 0;
+    const size_t rows = begin ? parseCSVBody(begin, end, flattenedFeatures, labels, featuresPerRow) : 0;
+    if (rows > 0 && featuresPerRow > 0) {
+        rowLength = static_cast<int>(featuresPerRow) + 1; // +1 for label
+    }
+    std::cout << "Loaded " << labels.size() << " samples with "
+              << (rowLength - 1) << " float32 features each" << std::endl;
+
+    // float32 缓存与 readCSV 的 float64 缓存分开存放，双精度路径不会读到收窄后的值
+    if (cacheable && !labels.empty() && rowLength > 1) {
+        BinaryDataset::WriteOptions options;
+        options.float32 = true;
+        options.source = source;
+        BinaryDataset::write(cachePath, flattenedFeatures, labels,
+                             static_cast<size_t>(rowLength - 1), options);
+    }
+    return {std::move(flattenedFeatures), std::move(labels)};
+}
+
+std::pair<std::vector<double>, std::vector<double>>
+DataIO::readCSVFiles(const std::vector<std::string>& paths, int& rowLength,
+                     const ColumnSelection& selection) {
+    std::vector<double> flattenedFeatures;
+    std::vector<double> labels;
+    rowLength = 0;
+
+    // 各分片：映射、表头、字段 → 输出列映射
+    struct Part {
+        std::unique_ptr<MappedFile> file;
+        const char* body = nullptr;
+        const char* end = nullptr;
+        std::vector<int> slot;
+        size_t columns = 0;
+    };
+    std::vector<Part> parts;
+    parts.reserve(paths.size());
+    std::vector<std::string> featureNames = selection.features;
+    std::string labelName = selection.label;
+
+    for (const auto& path : paths) {
+        Part part;
+        part.file = std::make_unique<MappedFile>(path);
+        if (!part.file->isOpen()) {
+            throw std::runtime_error("Unable to open file: " + path);
         }
-        
-        // **优化2: 使用高效的字符串解析**
-        std::vector<double> row;
-        row.reserve(50); // 预分配常见的特征数量
-        
-        std::stringstream ss(line);
-        std::string value;
-        
-        while (std::getline(ss, value, ',')) {
-            try {
-                row.push_back(std::stod(value));
-            } catch (const std::exception& e) {
-                std::cerr << "Warning: Failed to parse value '" << value 
-                          << "' as double: " << e.what() << std::endl;
-                row.push_back(0.0); // 默认值
+        if (!part.file->data()) continue;           // 空文件
+        const char* begin = part.file->data();
+        part.end = begin + part.file->size();
+        part.body = nextLine(begin, part.end);
+        const std::vector<std::string> header = parseHeader(begin, part.end);
+        if (header.empty()) continue;
+        part.columns = header.size();
+
+        // 输出模式由首个非空文件确定：默认最后一列为标签，其余为特征
+        if (labelName.empty()) labelName = header.back();
+        if (featureNames.empty()) {
+            for (const auto& name : header) {
+                if (name != labelName) featureNames.push_back(name);
             }
         }
-        
-        if (!row.empty()) {
-            // **优化3: 避免每次都push_back label，批量操作**
-            labels.push_back(row.back());
-            row.pop_back();
-            
-            // **优化4: 预分配feature vector并批量插入**
-            if (flattenedFeatures.empty() && !row.empty()) {
-                // 第一行确定特征数量，预分配总空间
-                const size_t featuresPerRow = row.size();
-                flattenedFeatures.reserve(estimatedRows * featuresPerRow);
-                rowLength = static_cast<int>(featuresPerRow) + 1; // +1 for label
+
+        // 同名列取第一次出现；所选列在每个分片中都必须存在
+        auto column = [&](const std::string& name) {
+            const auto it = std::find(header.begin(), header.end(), name);
+            if (it == header.end()) {
+                throw std::runtime_error("Column '" + name + "' not found in " + path);
             }
-            
-            // **使用move语义和批量插入**
-            flattenedFeatures.insert(flattenedFeatures.end(),
-                                   std::make_move_iterator(row.begin()),
-                                   std::make_move_iterator(row.end()));
+            return static_cast<size_t>(it - header.begin());
+        };
+        part.slot.assign(header.size(), kSkipSlot);
+        for (size_t k = 0; k < featureNames.size(); ++k) {
+            part.slot[column(featureNames[k])] = static_cast<int>(k);
         }
+        const size_t labelColumn = column(labelName);
+        if (part.slot[labelColumn] != kSkipSlot) {
+            throw std::runtime_error("Label column '" + labelName + "' is also selected as a feature");
+        }
+        part.slot[labelColumn] = kLabelSlot;
+        parts.push_back(std::move(part));
+    }
+    if (parts.empty()) {
+        std::cerr << "No data files to load" << std::endl;
+        return {std::move(flattenedFeatures), std::move(labels)};
     }
+    const size_t d = featureNames.size();
 
-    file.close();
-    
-    // **优化5: 最终的内存整理**
-    flattenedFeatures.shrink_to_fit();
-    labels.shrink_to_fit();
-    
-    std::cout << "Loaded " << labels.size() << " samples with " 
-              << (rowLength - 1) << " features each" << std::endl;
-    
+    // 所有分片的换行对齐块组成一个任务表，跨文件负载均衡
+    struct Task {
+        size_t part;
+        const char* begin;
+        const char* end;
+    };
+    std::vector<Task> tasks;
+    for (size_t p = 0; p < parts.size(); ++p) {
+        const auto bounds = chunkBounds(parts[p].body, parts[p].end);
+        for (size_t k = 0; k + 1 < bounds.size(); ++k) {
+            if (bounds[k] < bounds[k + 1]) tasks.push_back({p, bounds[k], bounds[k + 1]});
+        }
+    }
+
+    // 阶段1：各块行数 → 前缀和得到行偏移
+    std::vector<size_t> rowOffset(tasks.size() + 1, 0);
+    #pragma omp parallel for schedule(dynamic) if(tasks.size() > 1)
+    for (size_t t = 0; t < tasks.size(); ++t) {
+        size_t rows = 0;
+        forEachLine(tasks[t].begin, tasks[t].end, [&](const char*, const char*) { ++rows; });
+        rowOffset[t + 1] = rows;
+    }
+    for (size_t t = 0; t < tasks.size(); ++t) rowOffset[t + 1] += rowOffset[t];
+    const size_t totalRows = rowOffset[tasks.size()];
+
+    // 只为所选列分配：n × d 特征 + n 个标签
+    flattenedFeatures.assign(totalRows * d, 0.0);
+    labels.assign(totalRows, 0.0);
+
+    // 阶段2：各块直接写入预分配矩阵
+    std::vector<std::vector<std::string>> taskWarnings(tasks.size());
+    #pragma omp parallel for schedule(dynamic) if(tasks.size() > 1)
+    for (size_t t = 0; t < tasks.size(); ++t) {
+        const Part& part = parts[tasks[t].part];
+        auto& warnings = taskWarnings[t];
+        size_t r = rowOffset[t];
+        forEachLine(tasks[t].begin, tasks[t].end, [&](const char* lb, const char* le) {
+            const size_t fields = parseProjectedLine(lb, le, part.slot,
+                                                     &flattenedFeatures[r * d], &labels[r], warnings);
+            if (fields != part.columns) {
+                warnings.push_back("Warning: " + paths[tasks[t].part] + " row has " +
+                                   std::to_string(fields) + " values, expected " +
+                                   std::to_string(part.columns));
+            }
+            ++r;
+        });
+    }
+    for (const auto& warnings : taskWarnings) {
+        for (const auto& w : warnings) std::cerr << w << std::endl;
+    }
+
+    rowLength = static_cast<int>(d) + 1; // +1 for label
+    std::cout << "Loaded " << labels.size() << " samples with " << d
+              << " features each from " << parts.size() << " file(s)" << std::endl;
     return {std::move(flattenedFeatures), std::move(labels)};
 }
 
-void DataIO::writeResults(const std::vector<double>& results,
-                          const std::string& filename) {
-    std::ofstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Unable to open file: " << filename << std::endl;
-        return;
+std::pair<std::vector<double>, std::vector<double>>
+DataIO::readDataset(const std::string& spec, int& rowLength, const ColumnSelection& selection) {
+    const std::vector<std::string> paths = expandPaths(spec);
+    if (paths.size() == 1 && selection.empty()) {
+        return readCSV(paths.front(), rowLength);
     }
-    
-    // **优化: 使用缓冲写入提高性能**
-    file.precision(10); // 设置精度
-    file << std::fixed;
-    
-    for (const auto& r : results) {
-        file << r << '\n';
+    if (paths.empty()) {
+        std::cerr << "No files match: " << spec << std::endl;
+        rowLength = 0;
+        return {};
     }
-    
-    file.close();
+    return readCSVFiles(paths, rowLength, selection);
+}
+
+std::vector<std::string> DataIO::splitList(const std::string& list, char sep) {
+    std::vector<std::string> items;
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t stop = list.find(sep, start);
+        if (stop == std::string::npos) stop = list.size();
+        size_t b = start, e = stop;
+        while (b < e && std::isspace(static_cast<unsigned char>(list[b]))) ++b;
+        while (e > b && std::isspace(static_cast<unsigned char>(list[e - 1]))) --e;
+        if (e > b) items.push_back(list.substr(b, e - b));
+        start = stop + 1;
+    }
+    return items;
+}
+
+std::vector<std::string> DataIO::expandPaths(const std::string& spec) {
+    std::vector<std::string> paths;
+    for (const auto& item : splitList(spec)) {
+#ifdef DATAIO_HAS_MMAP
+        if (item.find_first_of("*?[") != std::string::npos) {
+            glob_t matches{};
+            if (::glob(item.c_str(), 0, nullptr, &matches) == 0) {
+                for (size_t i = 0; i < matches.gl_pathc; ++i) paths.emplace_back(matches.gl_pathv[i]);
+            }
+            ::globfree(&matches);
+            continue;
+        }
+#endif
+        paths.push_back(item);
+    }
+    return paths;
 }
 
-// **新增方法：批量读取CSV（用于大文件）**
+std::string DataIO::binaryCachePath(const std::string& filename) {
+    return filename + ".dtbin";
+}
+
+std::string DataIO::binaryCachePathF32(const std::string& filename) {
+    return filename + ".f32.dtbin";
+}
+
+bool DataIO::defaultBinaryCacheEnabled() {
+    // 环境变量 DT_BINARY_CACHE=0 可全局关闭缓存（如只读数据目录）
+    const char* env = std::getenv("DT_BINARY_CACHE");
+    return !(env && std::string(env) == "0");
+}
+
+void DataIO::writeResults(const std::vector<double>& results,
+                          const std::string& filename) {
+    writeResultsParallel(results, filename);
+}
+
+// 批量读取游标：保持映射与字节偏移，连续批次无需从头重新跳行
+struct DataIO::BatchCursor {
+    std::string filename;
+    std::unique_ptr<MappedFile> file;
+    const char* bodyBegin = nullptr;    // 头部行之后
+    const char* end = nullptr;
+    const char* pos = nullptr;          // 下一批的起始字节
+    size_t nextRow = 0;                 // pos 对应的数据行号
+};
+
+void DataIO::resetBatchCursor() {
+    batchCursor_.reset();
+}
+
+// **批量读取CSV（用于大文件）**：连续调用从上次的字节偏移继续，整体线性
 bool DataIO::readCSVBatch(const std::string& filename, 
                           std::vector<double>& flattenedFeatures,
                           std::vector<double>& labels,
@@ -127,112 +656,206 @@ bool DataIO::readCSVBatch(const std::string& filename,
                           size_t batchSize,
                           size_t skipRows) {
     
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Unable to open file: " << filename << std::endl;
-        return false;
+    if (!batchCursor_ || batchCursor_->filename != filename) {
+        auto cursor = std::make_shared<BatchCursor>();
+        cursor->file = std::make_unique<MappedFile>(filename);
+        if (!cursor->file->isOpen()) {
+            std::cerr << "Unable to open file: " << filename << std::endl;
+            return false;
+        }
+        const char* begin = cursor->file->data();
+        if (!begin) {
+            std::cerr << "Empty file: " << filename << std::endl;
+            return false;
+        }
+        cursor->filename = filename;
+        cursor->end = begin + cursor->file->size();
+        cursor->bodyBegin = nextLine(begin, cursor->end);   // 跳过头部
+        cursor->pos = cursor->bodyBegin;
+        batchCursor_ = std::move(cursor);
     }
+    BatchCursor& cursor = *batchCursor_;
 
-    std::string line;
-    
-    // 跳过头部
-    if (!std::getline(file, line)) {
-        std::cerr << "Empty file: " << filename << std::endl;
-        return false;
+    // 请求位置在游标之前时回到正文开头，否则只向前跳过差值
+    if (skipRows < cursor.nextRow) {
+        cursor.pos = cursor.bodyBegin;
+        cursor.nextRow = 0;
     }
-    
-    // 跳过指定行数
-    for (size_t i = 0; i < skipRows; ++i) {
-        if (!std::getline(file, line)) {
-            return false; // 文件结束
-        }
-    }
-    
-    // 清空输出容器
-    flattenedFeatures.clear();
-    labels.clear();
-    flattenedFeatures.reserve(batchSize * 50); // 估算特征数
-    labels.reserve(batchSize);
-    
-    size_t rowsRead = 0;
-    while (rowsRead < batchSize && std::getline(file, line)) {
-        std::vector<double> row;
-        std::stringstream ss(line);
-        std::string value;
-        
-        while (std::getline(ss, value, ',')) {
-            try {
-                row.push_back(std::stod(value));
-            } catch (const std::exception&) {
-                row.push_back(0.0);
-            }
-        }
-        
-        if (!row.empty()) {
-            labels.push_back(row.back());
-            row.pop_back();
-            
-            if (rowsRead == 0) {
-                rowLength = static_cast<int>(row.size()) + 1;
-            }
-            
-            flattenedFeatures.insert(flattenedFeatures.end(),
-                                   row.begin(), row.end());
-            ++rowsRead;
-        }
+    cursor.pos = skipLines(cursor.pos, cursor.end, skipRows - cursor.nextRow);
+    cursor.nextRow = skipRows;
+
+    // 本批字节区间，直接从映射内存解析
+    const char* batchBegin = cursor.pos;
+    const char* batchEnd = skipLines(batchBegin, cursor.end, batchSize);
+
+    size_t featuresPerRow = 0;
+    const size_t rowsRead = parseCSVBody(batchBegin, batchEnd, flattenedFeatures, labels, featuresPerRow);
+    if (rowsRead > 0) {
+        rowLength = static_cast<int>(featuresPerRow) + 1;
     }
-    
-    file.close();
+
+    cursor.pos = batchEnd;
+    cursor.nextRow += rowsRead;
     return rowsRead > 0;
 }
 
-// **新增方法：并行CSV写入（用于大结果集）**
+// **并行文本写入**：各块由一个线程用 to_chars 格式化到自己的缓冲，
+// 本轮格式化的同时由一个线程顺序写出上一轮的缓冲，输出顺序与 results 一致
 void DataIO::writeResultsParallel(const std::vector<double>& results,
                                   const std::string& filename,
                                   size_t chunkSize) {
-    
-    std::ofstream file(filename);
+    std::ofstream file(filename, std::ios::binary);
     if (!file.is_open()) {
         std::cerr << "Unable to open file: " << filename << std::endl;
         return;
     }
-    
-    file.precision(10);
-    file << std::fixed;
-    
-    // **对于大数据集，使用缓冲区批量写入**
-    if (results.size() > chunkSize) {
-        std::string buffer;
-        buffer.reserve(chunkSize * 20); // 预分配缓冲区
-        
-        for (size_t i = 0; i < results.size(); ++i) {
-            buffer += std::to_string(results[i]) + '\n';
-            
-            if ((i + 1) % chunkSize == 0 || i == results.size() - 1) {
-                file << buffer;
-                buffer.clear();
+
+    chunkSize = std::max<size_t>(chunkSize, 1);
+    const size_t n = results.size();
+    const size_t numChunks = (n + chunkSize - 1) / chunkSize;
+#ifdef _OPENMP
+    const size_t chunksPerRound = static_cast<size_t>(omp_get_max_threads()) * 4;
+#else
+    const size_t chunksPerRound = 1;
+#endif
+    // 两组缓冲轮换：一组格式化，另一组写出
+    std::vector<std::string> buffers[2];
+    buffers[0].resize(std::min(numChunks, chunksPerRound));
+    buffers[1].resize(buffers[0].size());
+
+    auto writeRound = [&](const std::vector<std::string>& round, size_t count) {
+        for (size_t k = 0; k < count; ++k) {
+            file.write(round[k].data(), static_cast<std::streamsize>(round[k].size()));
+        }
+    };
+
+    size_t pending = 0;         // 上一轮待写出的块数
+    int current = 0;
+    for (size_t first = 0; first < numChunks; first += chunksPerRound) {
+        const size_t last = std::min(numChunks, first + chunksPerRound);
+        auto& round = buffers[current];
+        const auto& previous = buffers[current ^ 1];
+
+        #pragma omp parallel if(last - first > 1 || pending > 0)
+        {
+            #pragma omp single nowait
+            writeRound(previous, pending);
+
+            #pragma omp for schedule(dynamic)
+            for (size_t k = first; k < last; ++k) {
+                formatFixedChunk(results.data() + k * chunkSize,
+                                 std::min(n, (k + 1) * chunkSize) - k * chunkSize,
+                                 round[k - first]);
             }
         }
+        pending = last - first;
+        current ^= 1;
+    }
+    writeRound(buffers[current ^ 1], pending);
+
+    file.close();
+    if (!file) {
+        std::cerr << "Failed to write results: " << filename << std::endl;
+    }
+}
+
+bool DataIO::writeResultsBinary(const std::vector<double>& results,
+                                const std::string& filename,
+                                bool float32) {
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Unable to open file: " << filename << std::endl;
+        return false;
+    }
+
+    ResultsHeader header{};
+    std::memcpy(header.magic, kResultsMagic, sizeof(kResultsMagic));
+    header.version = kResultsVersion;
+    header.flags = float32 ? kResultsFloat32 : 0u;
+    header.count = results.size();
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    if (!float32) {
+        file.write(reinterpret_cast<const char*>(results.data()),
+                   static_cast<std::streamsize>(results.size() * sizeof(double)));
     } else {
-        // 小数据集直接写入
-        for (const auto& r : results) {
-            file << r << '\n';
+        // 分段收窄，缓冲固定大小
+        constexpr size_t kChunk = 1 << 16;
+        std::vector<float> buf;
+        for (size_t lo = 0; lo < results.size(); lo += kChunk) {
+            const size_t hi = std::min(results.size(), lo + kChunk);
+            buf.resize(hi - lo);
+            std::transform(results.begin() + lo, results.begin() + hi, buf.begin(),
+                           [](double v) { return static_cast<float>(v); });
+            file.write(reinterpret_cast<const char*>(buf.data()),
+                       static_cast<std::streamsize>(buf.size() * sizeof(float)));
         }
     }
-    
+
     file.close();
+    if (!file) {
+        std::cerr << "Failed to write results: " << filename << std::endl;
+        return false;
+    }
+    return true;
 }
 
-// **新增方法：内存映射读取（用于超大文件）**
+bool DataIO::readResultsBinary(const std::string& filename, std::vector<double>& results) {
+    results.clear();
+    MappedFile file(filename);
+    if (!file.isOpen() || file.size() < sizeof(ResultsHeader)) return false;
+
+    ResultsHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, kResultsMagic, sizeof(kResultsMagic)) != 0 ||
+        header.version != kResultsVersion) {
+        return false;
+    }
+    const bool f32 = (header.flags & kResultsFloat32) != 0;
+    const size_t valueBytes = f32 ? sizeof(float) : sizeof(double);
+    if ((file.size() - sizeof(header)) / valueBytes < header.count) return false;
+
+    results.resize(header.count);
+    const char* body = file.data() + sizeof(header);
+    if (f32) {
+        std::vector<float> buf(header.count);
+        std::memcpy(buf.data(), body, header.count * sizeof(float));
+        std::copy(buf.begin(), buf.end(), results.begin());
+    } else {
+        std::memcpy(results.data(), body, header.count * sizeof(double));
+    }
+    return true;
+}
+
+// **内存映射读取（用于超大文件）**：换行对齐分块 + 并行 from_chars，直接写入调用方数组
 bool DataIO::readCSVMemoryMapped(const std::string& filename,
                                  std::vector<double>& flattenedFeatures,
                                  std::vector<double>& labels,
                                  int& rowLength) {
-    // 这里可以实现内存映射文件读取
-    // 暂时使用标准方法的优化版本
-    auto result = readCSV(filename, rowLength);
-    flattenedFeatures = std::move(result.first);
-    labels = std::move(result.second);
+    flattenedFeatures.clear();
+    labels.clear();
+    rowLength = 0;
+
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+        std::cerr << "Unable to open file: " << filename << std::endl;
+        return false;
+    }
+
+    // 跳过头部行
+    const char* begin = file.data();
+    const char* end = begin + file.size();
+    if (begin) begin = nextLine(begin, end);
+
+    size_t featuresPerRow = 0;
+    const size_t rows = begin ? parseCSVBody(begin, end, flattenedFeatures, labels, featuresPerRow) : 0;
+    if (rows > 0 && featuresPerRow > 0) {
+        rowLength = static_cast<int>(featuresPerRow) + 1; // +1 for label
+    }
+    
+    std::cout << "Loaded " << labels.size() << " samples with " 
+              << (rowLength - 1) << " features each" << std::endl;
+    
     return !flattenedFeatures.empty();
 }
 
@@ -269,4 +892,132 @@ bool DataIO::validateData(const std::vector<double>& flattenedFeatures,
     }
     
     return true;
-}
\ No newline at end of file
+}
+// **文件统计**：映射后只数行，不解析数值
+DataIO::FileStats DataIO::getFileStats(const std::string& filename) const {
+    FileStats stats{0, 0, 0, true};
+    MappedFile file(filename);
+    if (!file.isOpen() || !file.data()) return stats;
+
+    const char* end = file.data() + file.size();
+    const char* body = nextLine(file.data(), end);
+    forEachLine(body, end, [&](const char* lb, const char* le) {
+        if (stats.totalRows++ == 0) stats.totalFeatures = countFields(lb, le) - 1;
+    });
+    stats.estimatedMemoryMB = stats.totalRows * (stats.totalFeatures + 1) * sizeof(double) >> 20;
+    return stats;
+}
+
+// =============================================================================
+// CSVReader - 流式读取（映射 + 字节游标）
+// =============================================================================
+class DataIO::CSVReader::Impl {
+public:
+    explicit Impl(const std::string& filename) : file(filename) {
+        if (!file.isOpen()) {
+            throw std::runtime_error("Unable to open file: " + filename);
+        }
+        end = file.data() ? file.data() + file.size() : nullptr;
+        bodyBegin = file.data() ? nextLine(file.data(), end) : nullptr;   // 跳过头部
+        pos = bodyBegin;
+        // 首个非空数据行确定列数（只看这一行，不扫描全文件）
+        const char* first = skipBlank(bodyBegin);
+        if (first < end) {
+            const char* le = nextLine(first, end);
+            if (le > first && le[-1] == '\n') --le;
+            if (le > first && le[-1] == '\r') --le;
+            columns = countFields(first, le);
+        }
+    }
+
+    // 跳过空行，返回下一数据行起点
+    const char* skipBlank(const char* p) const {
+        while (p < end) {
+            const char* lineEnd = static_cast<const char*>(
+                std::memchr(p, '\n', static_cast<size_t>(end - p)));
+            if (!lineEnd) lineEnd = end;
+            const char* content = lineEnd;
+            if (content > p && content[-1] == '\r') --content;
+            if (content > p) break;
+            p = lineEnd < end ? lineEnd + 1 : end;
+        }
+        return p;
+    }
+
+    MappedFile file;
+    const char* bodyBegin = nullptr;
+    const char* end = nullptr;
+    const char* pos = nullptr;
+    size_t columns = 0;
+    std::vector<double> row;
+    std::vector<std::string> warnings;
+};
+
+DataIO::CSVReader::CSVReader(const std::string& filename)
+    : pImpl_(std::make_unique<Impl>(filename)) {}
+
+DataIO::CSVReader::~CSVReader() = default;
+
+bool DataIO::CSVReader::hasNext() const {
+    return pImpl_->columns > 0 && pImpl_->skipBlank(pImpl_->pos) < pImpl_->end;
+}
+
+int DataIO::CSVReader::numFeatures() const {
+    return pImpl_->columns > 0 ? static_cast<int>(pImpl_->columns) - 1 : 0;
+}
+
+bool DataIO::CSVReader::readNext(std::vector<double>& features, double& label) {
+    Impl& impl = *pImpl_;
+    if (!hasNext()) return false;
+
+    const char* lineBegin = impl.skipBlank(impl.pos);
+    const char* next = nextLine(lineBegin, impl.end);
+    const char* lineEnd = (next > lineBegin && next[-1] == '\n') ? next - 1 : next;
+    if (lineEnd > lineBegin && lineEnd[-1] == '\r') --lineEnd;
+
+    impl.warnings.clear();
+    parseLine(lineBegin, lineEnd, impl.row, impl.warnings);
+    for (const auto& w : impl.warnings) std::cerr << w << std::endl;
+
+    const size_t featuresPerRow = impl.columns - 1;
+    features.resize(featuresPerRow);
+    storeRow(impl.row, featuresPerRow, features.data(), &label);
+    impl.pos = next;
+    return true;
+}
+
+size_t DataIO::CSVReader::readBatch(std::vector<double>& flattenedFeatures,
+                                    std::vector<double>& labels,
+                                    size_t maxRows) {
+    Impl& impl = *pImpl_;
+    flattenedFeatures.clear();
+    labels.clear();
+    if (!hasNext() || maxRows == 0) return 0;
+
+    const char* batchBegin = impl.pos;
+    const char* batchEnd = skipLines(batchBegin, impl.end, maxRows);
+
+    size_t batchFeatures = 0;
+    const size_t rows = parseCSVBody(batchBegin, batchEnd, flattenedFeatures, labels, batchFeatures);
+    impl.pos = batchEnd;
+
+    // 批内首行列数与文件首行不一致时按文件列数补齐/截断，保证各批形状一致
+    const size_t featuresPerRow = impl.columns - 1;
+    if (rows > 0 && batchFeatures != featuresPerRow) {
+        std::vector<double> reshaped(rows * featuresPerRow, 0.0);
+        const size_t keep = std::min(batchFeatures, featuresPerRow);
+        for (size_t i = 0; i < rows; ++i) {
+            std::copy_n(&flattenedFeatures[i * batchFeatures], keep, &reshaped[i * featuresPerRow]);
+        }
+        flattenedFeatures.swap(reshaped);
+    }
+    return rows;
+}
+
+void DataIO::CSVReader::reset() {
+    pImpl_->pos = pImpl_->bodyBegin;
+}
+
+std::unique_ptr<DataIO::CSVReader> DataIO::createReader(const std::string& filename) {
+    return std::make_unique<CSVReader>(filename);
+}
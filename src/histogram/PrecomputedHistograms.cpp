@@ -2,6 +2,7 @@
 // src/histogram/PrecomputedHistograms.cpp - 预计算直方图优化实现
 // =============================================================================
 #include "histogram/PrecomputedHistograms.hpp"
+#include "histogram/QuantileSketch.hpp"
 #include <algorithm>
 #include <cmath>
 #include <limits>
@@ -13,7 +14,7 @@
 #include <omp.h>
 #endif
 
-void PrecomputedHistograms::precompute(const std::vector<double>& data,
+void PrecomputedHistograms::precompute(ConstSpan<double> data,
                                       int rowLength,
                                       const std::vector<double>& labels,
                                       const std::vector<int>& sampleIndices,
@@ -120,44 +121,32 @@ void PrecomputedHistograms::computeEqualFrequencyBins(int featureIndex,
     
     if (featureValues.empty()) return;
     
-    // 创建值-索引对并排序
-    std::vector<std::pair<double, int>> valueIndexPairs;
-    valueIndexPairs.reserve(featureValues.size());
-    for (size_t i = 0; i < featureValues.size(); ++i) {
-        valueIndexPairs.emplace_back(featureValues[i], indices[i]);
+    // **分位数摘要取切点**：内存与行数无关，无需整列排序
+    const QuantileSketch sketch = QuantileSketch::build(featureValues.data(), featureValues.size());
+    const std::vector<double> cuts = sketch.cutPoints(std::max(numBins, 1));
+    const double minVal = sketch.minValue();
+    const double maxVal = sketch.maxValue();
+    
+    // 桶 b 覆盖 (cut[b-1], cut[b]]：起始边界取切点的下一个可表示值，
+    // 使 findBin 的 upper_bound 与分裂阈值 value <= binEnd 一致
+    const int actualBins = static_cast<int>(cuts.size()) + 1;
+    hist.bins.resize(actualBins);
+    hist.binBoundaries.reserve(actualBins + 1);
+    hist.binBoundaries.push_back(minVal);
+    for (double c : cuts) {
+        hist.binBoundaries.push_back(std::nextafter(c, std::numeric_limits<double>::infinity()));
     }
+    hist.binBoundaries.push_back(maxVal);
     
-    std::sort(valueIndexPairs.begin(), valueIndexPairs.end());
-    
-    int samplesPerBin = static_cast<int>(valueIndexPairs.size()) / numBins;
-    int remainder = static_cast<int>(valueIndexPairs.size()) % numBins;
-    
-    hist.bins.resize(numBins);
-    hist.binBoundaries.push_back(valueIndexPairs.front().first);
+    for (int b = 0; b < actualBins; ++b) {
+        hist.bins[b].binStart = hist.binBoundaries[b];
+        hist.bins[b].binEnd = (b < actualBins - 1) ? cuts[b] : maxVal;
+    }
     
-    int currentPos = 0;
-    for (int binIdx = 0; binIdx < numBins; ++binIdx) {
-        int binSize = samplesPerBin + (binIdx < remainder ? 1 : 0);
-        int startPos = currentPos;
-        int endPos = currentPos + binSize;
-        
-        hist.bins[binIdx].binStart = valueIndexPairs[startPos].first;
-        
-        // 分配样本到当前桶
-        for (int pos = startPos; pos < endPos && pos < static_cast<int>(valueIndexPairs.size()); ++pos) {
-            int sampleIdx = valueIndexPairs[pos].second;
-            hist.bins[binIdx].addSample(sampleIdx, labels[sampleIdx]);
-        }
-        
-        if (endPos < static_cast<int>(valueIndexPairs.size())) {
-            hist.bins[binIdx].binEnd = valueIndexPairs[endPos - 1].first;
-            hist.binBoundaries.push_back(valueIndexPairs[endPos].first);
-        } else {
-            hist.bins[binIdx].binEnd = valueIndexPairs.back().first;
-            hist.binBoundaries.push_back(valueIndexPairs.back().first);
-        }
-        
-        currentPos = endPos;
+    // 按切点二分定位样本所在桶
+    for (size_t i = 0; i < featureValues.size(); ++i) {
+        const int b = findBin(hist, featureValues[i]);
+        hist.bins[b].addSample(indices[i], labels[indices[i]]);
     }
 }
 
@@ -177,14 +166,14 @@ void PrecomputedHistograms::computeAdaptiveEWBins(int featureIndex,
     } else if (rule == "sqrt") {
         numBins = static_cast<int>(std::ceil(std::sqrt(n)));
     } else if (rule == "freedman_diaconis") {
-        std::vector<double> sortedVals = featureValues;
-        std::sort(sortedVals.begin(), sortedVals.end());
-        double q1 = sortedVals[n / 4];
-        double q3 = sortedVals[3 * n / 4];
+        // 四分位数由分位数摘要近似给出
+        const QuantileSketch sketch = QuantileSketch::build(featureValues.data(), featureValues.size());
+        double q1 = sketch.quantile(0.25);
+        double q3 = sketch.quantile(0.75);
         double iqr = q3 - q1;
         if (iqr > 0.0) {
             double h = 2.0 * iqr / std::cbrt(n);
-            double range = sortedVals.back() - sortedVals.front();
+            double range = sketch.maxValue() - sketch.minValue();
             numBins = static_cast<int>(std::ceil(range / h));
         }
     }
@@ -276,12 +265,13 @@ void PrecomputedHistograms::parallelBinConstruction(int featureIndex,
 }
 
 std::tuple<int, double, double> PrecomputedHistograms::findBestSplitFast(
-    const std::vector<double>& data,
+    ConstSpan<double> data,
     int rowLength,
     const std::vector<double>& labels,
     const std::vector<int>& nodeIndices,
     double parentMetric,
-    const std::vector<int>& candidateFeatures) const {
+    const std::vector<int>& candidateFeatures,
+    const std::vector<double>* sampleWeights) const {
     
     auto startTime = std::chrono::high_resolution_clock::now();
     
@@ -314,43 +304,58 @@ std::tuple<int, double, double> PrecomputedHistograms::findBestSplitFast(
             if (hist.bins.empty()) continue;
             
             // **快速直方图查找**: 不重新构建，直接使用预计算结果
-            std::vector<int> nodeBinCounts(hist.bins.size(), 0);
-            std::vector<double> nodeBinSums(hist.bins.size(), 0.0);
-            std::vector<double> nodeBinSumSqs(hist.bins.size(), 0.0);
+            const size_t numBins = hist.bins.size();
+            std::vector<int> nodeBinCounts(numBins, 0);
+            std::vector<double> nodeBinWeights(numBins, 0.0);
+            std::vector<double> nodeBinSums(numBins, 0.0);
+            std::vector<double> nodeBinSumSqs(numBins, 0.0);
             
-            // 快速映射节点样本到桶
+            // 快速映射节点样本到桶（无权时 w = 1，权重和即样本数）
             for (int idx : nodeIndices) {
                 double val = data[idx * rowLength + f];
                 int binIdx = findBin(hist, val);
-                if (binIdx >= 0 && binIdx < static_cast<int>(hist.bins.size())) {
+                if (binIdx >= 0 && binIdx < static_cast<int>(numBins)) {
+                    const double w = sampleWeights ? (*sampleWeights)[idx] : 1.0;
+                    const double lbl = labels[idx];
                     nodeBinCounts[binIdx]++;
-                    nodeBinSums[binIdx] += labels[idx];
-                    nodeBinSumSqs[binIdx] += labels[idx] * labels[idx];
+                    nodeBinWeights[binIdx] += w;
+                    nodeBinSums[binIdx] += w * lbl;
+                    nodeBinSumSqs[binIdx] += w * lbl * lbl;
                 }
             }
             
-            // 使用前缀和进行快速分裂评估
-            double leftSum = 0.0, leftSumSq = 0.0;
+            double totalWeight = 0.0, totalSum = 0.0, totalSumSq = 0.0;
+            for (size_t b = 0; b < numBins; ++b) {
+                totalWeight += nodeBinWeights[b];
+                totalSum += nodeBinSums[b];
+                totalSumSq += nodeBinSumSqs[b];
+            }
+            if (totalWeight <= 0.0) continue;
+            
+            // 前缀累积左侧统计，右侧由总量减左侧得到
+            double leftSum = 0.0, leftSumSq = 0.0, leftWeight = 0.0;
             int leftCount = 0;
             
-            for (size_t b = 0; b + 1 < hist.bins.size(); ++b) {
+            for (size_t b = 0; b + 1 < numBins; ++b) {
                 leftSum += nodeBinSums[b];
                 leftSumSq += nodeBinSumSqs[b];
+                leftWeight += nodeBinWeights[b];
                 leftCount += nodeBinCounts[b];
                 
                 int rightCount = static_cast<int>(N) - leftCount;
                 if (leftCount == 0 || rightCount == 0) continue;
                 
-                double rightSum = 0.0, rightSumSq = 0.0;
-                for (size_t rb = b + 1; rb < hist.bins.size(); ++rb) {
-                    rightSum += nodeBinSums[rb];
-                    rightSumSq += nodeBinSumSqs[rb];
-                }
+                const double rightWeight = totalWeight - leftWeight;
+                if (leftWeight <= 0.0 || rightWeight <= 0.0) continue;
+                const double rightSum = totalSum - leftSum;
+                const double rightSumSq = totalSumSq - leftSumSq;
                 
-                // 计算MSE和增益
-                double leftMSE = leftSumSq / leftCount - std::pow(leftSum / leftCount, 2);
-                double rightMSE = rightSumSq / rightCount - std::pow(rightSum / rightCount, 2);
-                double gain = parentMetric - (leftMSE * leftCount + rightMSE * rightCount) / N;
+                // 计算（加权）MSE和增益
+                const double leftMean = leftSum / leftWeight;
+                const double rightMean = rightSum / rightWeight;
+                const double leftMSE = leftSumSq / leftWeight - leftMean * leftMean;
+                const double rightMSE = rightSumSq / rightWeight - rightMean * rightMean;
+                double gain = parentMetric - (leftMSE * leftWeight + rightMSE * rightWeight) / totalWeight;
                 
                 if (gain > localBestGain) {
                     localBestGain = gain;
@@ -371,7 +376,11 @@ std::tuple<int, double, double> PrecomputedHistograms::findBestSplitFast(
     }
     
     auto endTime = std::chrono::high_resolution_clock::now();
-    stats_.splitFindTimeMs += std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    const double elapsedMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    // 同一实例由并发节点共享
+    #pragma omp atomic
+    stats_.splitFindTimeMs += elapsedMs;
+    #pragma omp atomic
     ++stats_.totalSplitQueries;
     
     return {bestFeature, bestThreshold, bestGain};
@@ -436,7 +445,10 @@ void PrecomputedHistograms::updateChildHistograms(int featureIndex,
     rightHist.updatePrefixArrays();
     
     auto endTime = std::chrono::high_resolution_clock::now();
-    stats_.histogramUpdateTimeMs += std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    const double elapsedMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    #pragma omp atomic
+    stats_.histogramUpdateTimeMs += elapsedMs;
+    #pragma omp atomic
     ++stats_.totalHistogramUpdates;
 }
 
@@ -501,4 +513,36 @@ void HistogramCache::evictOldEntries() {
         std::advance(it, cache_.size() / 4);
         cache_.erase(cache_.begin(), it);
     }
-}
\ No newline at end of file
+}
+
+std::shared_ptr<const PrecomputedHistograms> PrecomputedHistogramCache::get(
+    ConstSpan<double> data,
+    int rowLength,
+    const std::vector<double>& labels,
+    const std::shared_ptr<const std::vector<int>>& trainingRows,
+    const std::string& binningType,
+    int bins) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const bool hit = histograms_ && data_ == data.data() && dataSize_ == data.size() &&
+                     rowLength_ == rowLength && rows_ == trainingRows &&
+                     (trainingRows || numLabels_ == labels.size());
+    if (hit) return histograms_;
+
+    std::vector<int> rows;
+    if (trainingRows) {
+        rows = *trainingRows;
+    } else {
+        rows.resize(labels.size());
+        std::iota(rows.begin(), rows.end(), 0);
+    }
+    auto fresh = std::make_shared<PrecomputedHistograms>(rowLength);
+    fresh->precompute(data, rowLength, labels, rows, binningType, bins);
+
+    histograms_ = std::move(fresh);
+    data_ = data.data();
+    dataSize_ = data.size();
+    rowLength_ = rowLength;
+    numLabels_ = labels.size();
+    rows_ = trainingRows;
+    return histograms_;
+}
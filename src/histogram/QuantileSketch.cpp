@@ -0,0 +1,232 @@
+// =============================================================================
+// src/histogram/QuantileSketch.cpp - 可合并的加权分位数摘要
+// =============================================================================
+#include "histogram/QuantileSketch.hpp"
+#include <algorithm>
+#include <cmath>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+QuantileSketch::QuantileSketch(size_t maxEntries)
+    : maxEntries_(std::max<size_t>(maxEntries, 8)) {
+    buffer_.reserve(maxEntries_);
+}
+
+void QuantileSketch::add(double value, double weight) {
+    if (!(weight > 0.0) || std::isnan(value)) return;
+    buffer_.emplace_back(value, weight);
+    totalWeight_ += weight;
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+    if (buffer_.size() >= maxEntries_) flushBuffer();
+}
+
+QuantileSketch QuantileSketch::build(const double* values, size_t n, size_t maxEntries) {
+#ifdef _OPENMP
+    const int numThreads = (n >= 100000 && !omp_in_parallel()) ? omp_get_max_threads() : 1;
+#else
+    const int numThreads = 1;
+#endif
+    std::vector<QuantileSketch> partial(numThreads, QuantileSketch(maxEntries));
+
+    #pragma omp parallel num_threads(numThreads) if(numThreads > 1)
+    {
+#ifdef _OPENMP
+        const int tid = omp_get_thread_num();
+#else
+        const int tid = 0;
+#endif
+        const size_t lo = n * tid / numThreads;
+        const size_t hi = n * (tid + 1) / numThreads;
+        for (size_t i = lo; i < hi; ++i) partial[tid].add(values[i]);
+    }
+
+    for (int t = 1; t < numThreads; ++t) partial[0].merge(partial[t]);
+    return std::move(partial[0]);
+}
+
+// 缓冲排序并聚合相同取值，得到精确摘要
+QuantileSketch::Summary QuantileSketch::fromBuffer(std::vector<std::pair<double, double>> buffer) {
+    std::sort(buffer.begin(), buffer.end());
+    Summary s;
+    s.reserve(buffer.size());
+    double before = 0.0;
+    for (size_t i = 0; i < buffer.size();) {
+        const double v = buffer[i].first;
+        double w = 0.0;
+        for (; i < buffer.size() && buffer[i].first == v; ++i) w += buffer[i].second;
+        s.push_back({v, before, before + w, w});
+        before += w;
+    }
+    return s;
+}
+
+// 合并两个摘要：一侧取值在另一侧的秩界由其相邻项给出
+QuantileSketch::Summary QuantileSketch::combine(const Summary& a, const Summary& b) {
+    if (a.empty()) return b;
+    if (b.empty()) return a;
+
+    Summary out;
+    out.reserve(a.size() + b.size());
+    size_t i = 0, j = 0;
+    double aPrevRmin = 0.0, bPrevRmin = 0.0;
+    while (i < a.size() && j < b.size()) {
+        if (a[i].value == b[j].value) {
+            out.push_back({a[i].value, a[i].rmin + b[j].rmin, a[i].rmax + b[j].rmax,
+                           a[i].wmin + b[j].wmin});
+            aPrevRmin = a[i++].rminNext();
+            bPrevRmin = b[j++].rminNext();
+        } else if (a[i].value < b[j].value) {
+            out.push_back({a[i].value, a[i].rmin + bPrevRmin, a[i].rmax + b[j].rmaxPrev(), a[i].wmin});
+            aPrevRmin = a[i++].rminNext();
+        } else {
+            out.push_back({b[j].value, b[j].rmin + aPrevRmin, b[j].rmax + a[i].rmaxPrev(), b[j].wmin});
+            bPrevRmin = b[j++].rminNext();
+        }
+    }
+    const double bLast = b.back().rmax;
+    for (; i < a.size(); ++i) {
+        out.push_back({a[i].value, a[i].rmin + bPrevRmin, a[i].rmax + bLast, a[i].wmin});
+    }
+    const double aLast = a.back().rmax;
+    for (; j < b.size(); ++j) {
+        out.push_back({b[j].value, b[j].rmin + aPrevRmin, b[j].rmax + aLast, b[j].wmin});
+    }
+    return out;
+}
+
+// 剪枝到 maxSize 项：保留首尾，中间按等距目标秩挑选最接近的项
+QuantileSketch::Summary QuantileSketch::prune(const Summary& s, size_t maxSize) {
+    if (s.size() <= maxSize || maxSize < 3) return s;
+
+    Summary out;
+    out.reserve(maxSize);
+    out.push_back(s.front());
+
+    const double begin = s.front().rmax;
+    const double range = s.back().rmin - s.front().rmax;
+    const size_t n = maxSize - 1;
+    size_t i = 1, last = 0;
+    for (size_t k = 1; k < n; ++k) {
+        const double dx2 = 2.0 * (static_cast<double>(k) * range / n + begin);
+        while (i < s.size() - 1 && dx2 >= s[i + 1].rmax + s[i + 1].rmin) ++i;
+        if (i == s.size() - 1) break;
+        const size_t pick = (dx2 < s[i].rminNext() + s[i + 1].rmaxPrev()) ? i : i + 1;
+        if (pick != last) {
+            out.push_back(s[pick]);
+            last = pick;
+        }
+    }
+    if (last != s.size() - 1) out.push_back(s.back());
+    return out;
+}
+
+void QuantileSketch::flushBuffer() {
+    if (buffer_.empty()) return;
+    Summary s = prune(fromBuffer(std::move(buffer_)), maxEntries_);
+    buffer_.clear();
+    buffer_.reserve(maxEntries_);
+    pushSummary(std::move(s));
+}
+
+// 二进制进位：同层已有摘要时合并剪枝后上移一层
+void QuantileSketch::pushSummary(Summary summary) {
+    for (size_t l = 0;; ++l) {
+        if (l == levels_.size()) levels_.emplace_back();
+        if (levels_[l].empty()) {
+            levels_[l] = std::move(summary);
+            return;
+        }
+        summary = prune(combine(levels_[l], summary), maxEntries_);
+        levels_[l].clear();
+    }
+}
+
+QuantileSketch::Summary QuantileSketch::finalSummary() const {
+    Summary s = fromBuffer(buffer_);
+    for (const auto& level : levels_) {
+        if (!level.empty()) s = combine(s, level);
+    }
+    return s;
+}
+
+void QuantileSketch::merge(const QuantileSketch& other) {
+    if (other.empty()) return;
+    totalWeight_ += other.totalWeight_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+    pushSummary(prune(other.finalSummary(), maxEntries_));
+}
+
+void QuantileSketch::serialize(std::vector<double>& out) const {
+    const Summary s = prune(finalSummary(), maxEntries_);
+    out.clear();
+    out.reserve(s.size() * 4);
+    for (const auto& e : s) {
+        out.push_back(e.value);
+        out.push_back(e.rmin);
+        out.push_back(e.rmax);
+        out.push_back(e.wmin);
+    }
+}
+
+void QuantileSketch::mergeSerialized(const double* data, size_t count) {
+    Summary s;
+    s.reserve(count / 4);
+    for (size_t i = 0; i + 3 < count; i += 4) {
+        s.push_back({data[i], data[i + 1], data[i + 2], data[i + 3]});
+    }
+    if (s.empty()) return;
+    totalWeight_ += s.back().rmax;
+    min_ = std::min(min_, s.front().value);
+    max_ = std::max(max_, s.back().value);
+    pushSummary(std::move(s));
+}
+
+// 取加权秩最接近 rank 的摘要项
+double QuantileSketch::query(const Summary& s, double rank) {
+    const double d2 = 2.0 * rank;
+    if (d2 < s.front().rmin + s.front().rmax) return s.front().value;
+    for (size_t i = 1; i < s.size(); ++i) {
+        if (d2 < s[i].rmin + s[i].rmax) {
+            return (d2 < s[i - 1].rminNext() + s[i].rmaxPrev()) ? s[i - 1].value : s[i].value;
+        }
+    }
+    return s.back().value;
+}
+
+double QuantileSketch::quantile(double q) const {
+    if (empty()) return 0.0;
+    const Summary s = finalSummary();
+    return query(s, std::clamp(q, 0.0, 1.0) * totalWeight_);
+}
+
+std::vector<double> QuantileSketch::cutPoints(int numBins) const {
+    std::vector<double> cuts;
+    if (empty() || numBins < 2) return cuts;
+
+    // 目标秩递增，单调前移扫描摘要（等价于逐个 query）
+    const Summary s = finalSummary();
+    cuts.reserve(numBins - 1);
+    size_t i = 1;
+    for (int b = 1; b < numBins; ++b) {
+        const double d2 = 2.0 * totalWeight_ * b / numBins;
+        double v;
+        if (d2 < s.front().rmin + s.front().rmax) {
+            v = s.front().value;
+        } else {
+            while (i < s.size() && d2 >= s[i].rmin + s[i].rmax) ++i;
+            v = (i == s.size()) ? s.back().value
+              : (d2 < s[i - 1].rminNext() + s[i].rmaxPrev()) ? s[i - 1].value : s[i].value;
+        }
+        if (v < max_ && (cuts.empty() || v > cuts.back())) cuts.push_back(v);
+    }
+    return cuts;
+}
+
+size_t QuantileSketch::memoryEntries() const {
+    size_t total = buffer_.size();
+    for (const auto& level : levels_) total += level.size();
+    return total;
+}
@@ -1,43 +1,246 @@
 #include "lightgbm/app/LightGBMApp.hpp"
 #include "functions/io/DataIO.hpp"
+#include "functions/io/BinnedMatrix.hpp"
 #include "pipeline/DataSplit.hpp"
 #include <iostream>
 #include <chrono>
+#include <cmath>
 #include <iomanip>
+#include <stdexcept>
+
+namespace {
+
+// 分批评估：测试集同样只驻留一个批次
+bool evaluateStreaming(const LightGBMTrainer& trainer, const std::string& path,
+                       int numFeatures, size_t batchRows, double& mse, double& mae) {
+    DataIO::CSVReader reader(path);
+    if (reader.numFeatures() != numFeatures) {
+        std::cerr << "Test data has " << reader.numFeatures() << " features, expected "
+                  << numFeatures << std::endl;
+        return false;
+    }
+    std::vector<double> X, y;
+    size_t total = 0;
+    mse = 0.0;
+    mae = 0.0;
+    while (size_t rows = reader.readBatch(X, y, batchRows)) {
+        const auto predictions = trainer.getLGBModel()->predictBatch(X, numFeatures);
+        for (size_t i = 0; i < rows; ++i) {
+            const double diff = y[i] - predictions[i];
+            mse += diff * diff;
+            mae += std::abs(diff);
+        }
+        total += rows;
+    }
+    if (total == 0) return false;
+    mse /= total;
+    mae /= total;
+    return true;
+}
+
+// 直方图分桶方式与桶数（流式 / float32 路径共用），非直方图方法抛出
+std::pair<bool, int> histogramBinning(const LightGBMAppOptions& opts, const char* mode) {
+    const bool equalFrequency = opts.splitMethod.rfind("histogram_eq", 0) == 0;
+    if (!equalFrequency && opts.splitMethod.rfind("histogram_ew", 0) != 0) {
+        throw std::invalid_argument(std::string(mode) +
+                                    " training requires --split-method histogram_ew|histogram_eq[:bins]");
+    }
+    int bins = opts.histogramBins;
+    const auto colon = opts.splitMethod.find(':');
+    if (colon != std::string::npos) bins = std::stoi(opts.splitMethod.substr(colon + 1));
+    return {equalFrequency, bins};
+}
+
+// float32 视图上逐行预测，不展开为 double 矩阵
+void evaluateView(const LightGBMModel& model, const DatasetViewF32& view, double& mse, double& mae) {
+    const size_t n = view.size();
+    const int d = view.numFeatures();
+    mse = 0.0;
+    mae = 0.0;
+    if (n == 0) return;
+
+    #pragma omp parallel for reduction(+:mse,mae) schedule(static, 256) if(n > 1000)
+    for (size_t i = 0; i < n; ++i) {
+        const double diff = view.label(i) - model.predict(view.sample(i), d);
+        mse += diff * diff;
+        mae += std::abs(diff);
+    }
+    mse /= n;
+    mae /= n;
+}
+
+void runLightGBMFloat32(const LightGBMAppOptions& opts) {
+    auto totalStart = std::chrono::high_resolution_clock::now();
+    const auto [equalFrequency, bins] = histogramBinning(opts, "Float32");
+    if (!opts.featureColumns.empty() || !opts.labelColumn.empty() ||
+        DataIO::expandPaths(opts.dataPath).size() != 1) {
+        throw std::invalid_argument("Float32 training reads a single CSV file without column selection");
+    }
+
+    // 特征以 float32 常驻（内存减半），标签与所有统计量保持 double
+    int rowLength;
+    DataIO io;
+    auto [X, y] = io.readCSVFloat(opts.dataPath, rowLength);
+    if (y.empty() || rowLength < 2) {
+        throw std::runtime_error("No data rows in " + opts.dataPath);
+    }
+    if (opts.verbose) {
+        std::cout << "Loaded data: " << y.size() << " samples, " << (rowLength - 1)
+                  << " features (float32, " << (X.size() * sizeof(float) >> 20) << " MB)" << std::endl;
+    }
+
+    DataViewsF32 dv = splitViews(X, y, rowLength, 0.8);
+    auto trainer = createLightGBMTrainer(opts);
+
+    if (opts.earlyStoppingRounds > 0 && opts.valSplit > 0) {
+        const size_t trainSize = dv.train.size();
+        const size_t valSize = static_cast<size_t>(trainSize * opts.valSplit);
+        if (valSize > 0) {
+            dv.validation = dv.train.slice(trainSize - valSize, trainSize);
+            dv.train = dv.train.slice(0, trainSize - valSize);
+            trainer->setValidationData(dv.validation);
+        }
+    }
+
+    auto binStart = std::chrono::high_resolution_clock::now();
+    auto matrix = BinnedMatrix::fromView(dv.train, bins, equalFrequency);
+    auto binEnd = std::chrono::high_resolution_clock::now();
+
+    if (opts.verbose) {
+        std::cout << "\n=== Training LightGBM (float32) ===" << std::endl;
+    }
+    auto trainStart = std::chrono::high_resolution_clock::now();
+    trainer->trainBinned(*matrix);
+    auto trainEnd = std::chrono::high_resolution_clock::now();
+
+    double trainMSE, trainMAE, testMSE, testMAE;
+    evaluateView(*trainer->getLGBModel(), dv.train, trainMSE, trainMAE);
+    evaluateView(*trainer->getLGBModel(), dv.test, testMSE, testMAE);
+    auto totalEnd = std::chrono::high_resolution_clock::now();
+
+    auto ms = [](auto a, auto b) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(b - a).count();
+    };
+    std::cout << "\n=== LightGBM Results ===" << std::endl;
+    std::cout << "Trees: " << trainer->getLGBModel()->getTreeCount() << std::endl;
+    std::cout << "Train MSE: " << std::fixed << std::setprecision(6) << trainMSE
+              << " | Train MAE: " << trainMAE << std::endl;
+    std::cout << "Test MSE: " << testMSE
+              << " | Test MAE: " << testMAE << std::endl;
+    std::cout << "Binning Time: " << ms(binStart, binEnd) << "ms"
+              << " | Train Time: " << ms(trainStart, trainEnd) << "ms"
+              << " | Total Time: " << ms(totalStart, totalEnd) << "ms" << std::endl;
+
+    printLightGBMModelSummary(trainer.get(), opts);
+}
+
+void runLightGBMStreaming(const LightGBMAppOptions& opts) {
+    auto totalStart = std::chrono::high_resolution_clock::now();
+
+    auto trainer = createLightGBMTrainer(opts);
+    if (opts.earlyStoppingRounds > 0 && opts.verbose) {
+        std::cout << "Streaming mode: validation split is not applied, "
+                  << "early stopping uses training loss" << std::endl;
+    }
+
+    // 两遍流式分桶：分桶方式与桶数与 histogram_ew / histogram_eq 保持一致
+    const auto [equalFrequency, bins] = histogramBinning(opts, "Streaming");
+
+    auto binStart = std::chrono::high_resolution_clock::now();
+    auto matrix = BinnedMatrix::fromCSV(opts.dataPath, bins, opts.streamBatchRows,
+                                        opts.binSpillPath, equalFrequency);
+    if (!matrix) {
+        throw std::runtime_error("No data rows in " + opts.dataPath);
+    }
+    auto binEnd = std::chrono::high_resolution_clock::now();
+
+    if (opts.verbose) {
+        std::cout << "\n=== Training LightGBM (streaming) ===" << std::endl;
+    }
+    auto trainStart = std::chrono::high_resolution_clock::now();
+    trainer->trainBinned(*matrix);
+    auto trainEnd = std::chrono::high_resolution_clock::now();
+
+    double testMSE = 0.0, testMAE = 0.0;
+    const bool hasTest = !opts.testDataPath.empty() &&
+        evaluateStreaming(*trainer, opts.testDataPath, matrix->features(),
+                          opts.streamBatchRows, testMSE, testMAE);
+    auto totalEnd = std::chrono::high_resolution_clock::now();
+
+    auto ms = [](auto a, auto b) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(b - a).count();
+    };
+    std::cout << "\n=== LightGBM Results ===" << std::endl;
+    std::cout << "Trees: " << trainer->getLGBModel()->getTreeCount() << std::endl;
+    if (hasTest) {
+        std::cout << "Test MSE: " << std::fixed << std::setprecision(6) << testMSE
+                  << " | Test MAE: " << testMAE << std::endl;
+    }
+    std::cout << "Binning Time: " << ms(binStart, binEnd) << "ms"
+              << " | Train Time: " << ms(trainStart, trainEnd) << "ms"
+              << " | Total Time: " << ms(totalStart, totalEnd) << "ms" << std::endl;
+
+    printLightGBMModelSummary(trainer.get(), opts);
+}
+
+} // namespace
 
 void runLightGBMApp(const LightGBMAppOptions& opts) {
+    if (opts.streaming) {
+        runLightGBMStreaming(opts);
+        return;
+    }
+    if (opts.float32) {
+        runLightGBMFloat32(opts);
+        return;
+    }
+
     auto totalStart = std::chrono::high_resolution_clock::now();
     
     // 读取数据
     int rowLength;
     DataIO io;
-    auto [X, y] = io.readCSV(opts.dataPath, rowLength);
+    const DataIO::ColumnSelection columns{DataIO::splitList(opts.featureColumns), opts.labelColumn};
+    auto [X, y] = io.readDataset(opts.dataPath, rowLength, columns);
     
     if (opts.verbose) {
         std::cout << "Loaded data: " << y.size() << " samples, " 
                   << (rowLength - 1) << " features" << std::endl;
     }
     
-    // 划分数据集
-    DataParams dp;
-    splitDataset(X, y, rowLength, dp);
+    // 划分数据集：训练 / 测试视图共享 X、y
+    DataViews dv = splitViews(X, y, rowLength, 0.8);
     
     // 创建训练器
     auto trainer = createLightGBMTrainer(opts);
     
+    // 设置验证集（如果需要早停）
+    if (opts.earlyStoppingRounds > 0 && opts.valSplit > 0) {
+        // 从训练集尾部再分出验证集（仅调整视图区间）
+        size_t trainSize = dv.train.size();
+        size_t valSize = static_cast<size_t>(trainSize * opts.valSplit);
+        
+        if (valSize > 0) {
+            dv.validation = dv.train.slice(trainSize - valSize, trainSize);
+            dv.train = dv.train.slice(0, trainSize - valSize);
+            
+            trainer->setValidationData(dv.validation);
+        }
+    }
+    
     // 训练模型
     if (opts.verbose) {
         std::cout << "\n=== Training LightGBM ===" << std::endl;
     }
     
     auto trainStart = std::chrono::high_resolution_clock::now();
-    trainer->train(dp.X_train, dp.rowLength, dp.y_train);
+    trainer->trainOnView(dv.train);
     auto trainEnd = std::chrono::high_resolution_clock::now();
     
     // 评估模型
     double trainMSE, trainMAE, testMSE, testMAE;
-    trainer->evaluate(dp.X_train, dp.rowLength, dp.y_train, trainMSE, trainMAE);
-    trainer->evaluate(dp.X_test, dp.rowLength, dp.y_test, testMSE, testMAE);
+    trainer->evaluateOnView(dv.train, trainMSE, trainMAE);
+    trainer->evaluateOnView(dv.test, testMSE, testMAE);
     
     auto totalEnd = std::chrono::high_resolution_clock::now();
     
@@ -66,10 +269,12 @@ std::unique_ptr<LightGBMTrainer> createLightGBMTrainer(const LightGBMAppOptions&
     config.minDataInLeaf = opts.minDataInLeaf;
     config.topRate = opts.topRate;
     config.otherRate = opts.otherRate;
+    config.seed = opts.seed;
     config.maxBin = opts.maxBin;
     config.maxConflictRate = opts.maxConflictRate;
     config.enableFeatureBundling = opts.enableFeatureBundling;
     config.enableGOSS = opts.enableGOSS;
+    config.histPoolSize = opts.histPoolSize;
     config.verbose = opts.verbose;
     config.earlyStoppingRounds = opts.earlyStoppingRounds;
     config.tolerance = opts.tolerance;
@@ -23,121 +23,211 @@ void GOSSSampler::sample(const std::vector<double>& gradients,
         std::iota(sampleIndices.begin(), sampleIndices.end(), 0);
         return;
     }
-    // 只有样本量足够大时才并行，否则串行
-    if (n >= getParallelThreshold()) {
-        sampleParallel(gradients, sampleIndices, sampleWeights);
-    } else {
-        sampleSerial(gradients, sampleIndices, sampleWeights);
-    }
+    sampleWithRates(gradients, topRate_, otherRate_, sampleIndices, sampleWeights);
 }
 
-void GOSSSampler::sampleParallel(const std::vector<double>& gradients,
-                                 std::vector<int>& sampleIndices,
-                                 std::vector<double>& sampleWeights) const {
+void GOSSSampler::sampleWithRates(const std::vector<double>& gradients,
+                                  double topRate,
+                                  double otherRate,
+                                  std::vector<int>& sampleIndices,
+                                  std::vector<double>& sampleWeights) const {
     size_t n = gradients.size();
-    // 并行构建 (|grad|, idx) 对
-    std::vector<std::pair<double, int>> gradWithIndex(n);
-    #pragma omp parallel for schedule(static)
-    for (size_t i = 0; i < n; ++i) {
-        gradWithIndex[i] = {std::abs(gradients[i]), static_cast<int>(i)};
-    }
-
-    // 并行排序：如果编译器支持 C++17 并行算法，可改用 std::sort(std::execution::par, ...)
-    // 这里依旧使用串行 std::sort，但仅在 n 较大时执行
-    std::sort(gradWithIndex.begin(), gradWithIndex.end(),
-              [](const auto& a, const auto& b) { return a.first > b.first; });
 
     // 计算采样数量
-    size_t topNum = static_cast<size_t>(std::floor(n * topRate_));
-    size_t smallGradNum = n - topNum;
-    size_t randNum = static_cast<size_t>(std::floor(smallGradNum * otherRate_));
+    size_t topNum = static_cast<size_t>(std::floor(n * topRate));
     topNum = std::min(topNum, n);
+    size_t smallGradNum = n - topNum;
+    size_t randNum = static_cast<size_t>(std::floor(smallGradNum * otherRate));
     randNum = std::min(randNum, smallGradNum);
 
-    sampleIndices.clear();
-    sampleWeights.clear();
-    sampleIndices.reserve(topNum + randNum);
-    sampleWeights.reserve(topNum + randNum);
-
-    // 并行收集大梯度样本索引
-    std::vector<int> topIndices(topNum);
-    #pragma omp parallel for schedule(static)
-    for (size_t i = 0; i < topNum; ++i) {
-        topIndices[i] = gradWithIndex[i].second;
-    }
-    sampleIndices.insert(sampleIndices.end(), topIndices.begin(), topIndices.end());
-    sampleWeights.insert(sampleWeights.end(), topNum, 1.0);
-
-    // 随机采样小梯度样本（串行以保证随机性）
-    if (randNum > 0 && smallGradNum > 0) {
-        std::vector<int> smallGradPool;
-        smallGradPool.reserve(smallGradNum);
-        for (size_t i = topNum; i < n; ++i) {
-            smallGradPool.push_back(gradWithIndex[i].second);
-        }
-        std::shuffle(smallGradPool.begin(), smallGradPool.end(), gen_);
-        double smallWeight = (1.0 - topRate_) / otherRate_;
-        for (size_t i = 0; i < randNum; ++i) {
-            sampleIndices.push_back(smallGradPool[i]);
-            sampleWeights.push_back(smallWeight);
-        }
+    // 选择大梯度：pool_[0, topNum) 为大梯度，pool_[topNum, n) 为小梯度池
+    // 只有样本量足够大时才并行，否则串行
+    if (n >= getParallelThreshold()) {
+        selectTopParallel(gradients, topNum);
+    } else {
+        selectTopSerial(gradients, topNum);
     }
 
-    // 如果采样结果为空，则退回全量
-    if (sampleIndices.empty()) {
+    // 随机采样小梯度样本：只做 randNum 步交换，不打乱整个池
+    drawSmallGradients(topNum, randNum);
+
+    const size_t selected = topNum + randNum;
+    if (selected == 0) {
+        // 如果采样结果为空，则退回全量
         sampleIndices.resize(n);
         sampleWeights.assign(n, 1.0);
         std::iota(sampleIndices.begin(), sampleIndices.end(), 0);
+        return;
     }
-}
 
-void GOSSSampler::sampleSerial(const std::vector<double>& gradients,
-                               std::vector<int>& sampleIndices,
-                               std::vector<double>& sampleWeights) const {
-    size_t n = gradients.size();
-    std::vector<std::pair<double, int>> gradWithIndex;
-    gradWithIndex.reserve(n);
-    for (size_t i = 0; i < n; ++i) {
-        gradWithIndex.emplace_back(std::abs(gradients[i]), static_cast<int>(i));
+    const double smallWeight = (1.0 - topRate) / otherRate;
+    sampleIndices.resize(selected);
+    sampleWeights.resize(selected);
+
+    #pragma omp parallel for schedule(static) if(selected >= getParallelThreshold())
+    for (size_t i = 0; i < selected; ++i) {
+        sampleIndices[i] = pool_[i];
+        sampleWeights[i] = (i < topNum) ? 1.0 : smallWeight;
     }
-    std::sort(gradWithIndex.begin(), gradWithIndex.end(),
-              [](const auto& a, const auto& b) { return a.first > b.first; });
+}
 
-    size_t topNum = static_cast<size_t>(std::floor(n * topRate_));
-    size_t smallGradNum = n - topNum;
-    size_t randNum = static_cast<size_t>(std::floor(smallGradNum * otherRate_));
-    topNum = std::min(topNum, n);
-    randNum = std::min(randNum, smallGradNum);
+void GOSSSampler::selectTopSerial(const std::vector<double>& gradients, size_t topNum) const {
+    const size_t n = gradients.size();
+    pool_.resize(n);
+    std::iota(pool_.begin(), pool_.end(), 0);
+    if (topNum == 0 || topNum >= n) return;
 
-    sampleIndices.clear();
-    sampleWeights.clear();
-    sampleIndices.reserve(topNum + randNum);
-    sampleWeights.reserve(topNum + randNum);
+    // nth_element：平均 O(n)，前 topNum 个即 |梯度| 最大的样本
+    std::nth_element(pool_.begin(), pool_.begin() + topNum, pool_.end(),
+                     [&gradients](int a, int b) {
+                         return std::abs(gradients[a]) > std::abs(gradients[b]);
+                     });
+}
 
-    // 保留大梯度
-    for (size_t i = 0; i < topNum; ++i) {
-        sampleIndices.push_back(gradWithIndex[i].second);
-        sampleWeights.push_back(1.0);
+void GOSSSampler::selectTopParallel(const std::vector<double>& gradients, size_t topNum) const {
+    const size_t n = gradients.size();
+    pool_.resize(n);
+    if (topNum == 0 || topNum >= n) {
+        std::iota(pool_.begin(), pool_.end(), 0);
+        return;
     }
-    // 随机采样小梯度
-    if (randNum > 0 && smallGradNum > 0) {
-        std::vector<int> smallGradPool;
-        smallGradPool.reserve(smallGradNum);
-        for (size_t i = topNum; i < n; ++i) {
-            smallGradPool.push_back(gradWithIndex[i].second);
+
+    topMask_.resize(n);
+#ifdef _OPENMP
+    const int maxThreads = omp_get_max_threads();
+#else
+    const int maxThreads = 1;
+#endif
+    threadHist_.assign(static_cast<size_t>(maxThreads) * kSelectBins, 0);
+    threadCounts_.assign(static_cast<size_t>(maxThreads) * 3 + 1, 0);
+
+    // 线程内部使用手工静态分块，保证各阶段访问同一段样本，结果与调度无关
+    double maxAbs = 0.0;
+    double scale = 0.0;
+    int boundaryBin = 0;
+    size_t need = 0;
+
+    #pragma omp parallel
+    {
+#ifdef _OPENMP
+        const int tid = omp_get_thread_num();
+        const int nt = omp_get_num_threads();
+#else
+        const int tid = 0;
+        const int nt = 1;
+#endif
+        const size_t begin = n * tid / nt;
+        const size_t end = n * (tid + 1) / nt;
+        size_t* hist = &threadHist_[static_cast<size_t>(tid) * kSelectBins];
+        size_t* topCount = &threadCounts_[0];
+        size_t* candCount = &threadCounts_[maxThreads];
+        size_t* candOffset = &threadCounts_[2 * maxThreads];
+
+        // 阶段1：|梯度| 最大值（确定直方图范围）
+        double localMax = 0.0;
+        for (size_t i = begin; i < end; ++i) {
+            localMax = std::max(localMax, std::abs(gradients[i]));
         }
-        std::shuffle(smallGradPool.begin(), smallGradPool.end(), gen_);
-        double smallWeight = (1.0 - topRate_) / otherRate_;
-        for (size_t i = 0; i < randNum; ++i) {
-            sampleIndices.push_back(smallGradPool[i]);
-            sampleWeights.push_back(smallWeight);
+        #pragma omp critical
+        {
+            maxAbs = std::max(maxAbs, localMax);
+        }
+        #pragma omp barrier
+
+        #pragma omp single
+        scale = (maxAbs > 0.0) ? kSelectBins / maxAbs : 0.0;
+
+        // 阶段2：线程局部直方图
+        for (size_t i = begin; i < end; ++i) {
+            int b = static_cast<int>(std::abs(gradients[i]) * scale);
+            ++hist[std::min(b, kSelectBins - 1)];
+        }
+        #pragma omp barrier
+
+        // 合并直方图，自顶向下找到包含第 topNum 大元素的边界桶
+        #pragma omp single
+        {
+            size_t above = 0;
+            for (int b = kSelectBins - 1; b >= 0; --b) {
+                size_t cnt = 0;
+                for (int t = 0; t < nt; ++t) cnt += threadHist_[static_cast<size_t>(t) * kSelectBins + b];
+                if (above + cnt >= topNum) {
+                    boundaryBin = b;
+                    need = topNum - above;
+                    break;
+                }
+                above += cnt;
+            }
+            size_t offset = 0;
+            for (int t = 0; t < nt; ++t) {
+                candOffset[t] = offset;
+                offset += threadHist_[static_cast<size_t>(t) * kSelectBins + boundaryBin];
+            }
+            candidates_.resize(offset);
+        }
+
+        // 阶段3：标记边界桶以上的样本，收集边界桶候选
+        size_t localTop = 0;
+        size_t pos = candOffset[tid];
+        for (size_t i = begin; i < end; ++i) {
+            const double v = std::abs(gradients[i]);
+            const int b = std::min(static_cast<int>(v * scale), kSelectBins - 1);
+            const char isTop = (b > boundaryBin) ? 1 : 0;
+            topMask_[i] = isTop;
+            localTop += isTop;
+            if (b == boundaryBin) {
+                candidates_[pos++] = {v, static_cast<int>(i)};
+            }
+        }
+        topCount[tid] = localTop;
+        candCount[tid] = 0;
+        #pragma omp barrier
+
+        // 边界桶内只需部分选择
+        #pragma omp single
+        {
+            if (need > 0 && need < candidates_.size()) {
+                std::nth_element(candidates_.begin(), candidates_.begin() + need, candidates_.end(),
+                                 [](const auto& a, const auto& b) { return a.first > b.first; });
+            }
+            const size_t take = std::min(need, candidates_.size());
+            for (size_t c = 0; c < take; ++c) {
+                const size_t idx = static_cast<size_t>(candidates_[c].second);
+                topMask_[idx] = 1;
+                // 所属线程块：begin_t = n*t/nt
+                int owner = static_cast<int>((idx * nt) / n);
+                while (owner + 1 < nt && n * (owner + 1) / nt <= idx) ++owner;
+                while (owner > 0 && n * owner / nt > idx) --owner;
+                ++topCount[owner];
+            }
+            // 前缀和：大梯度写入 [0, topNum)，小梯度写入 [topNum, n)
+            size_t topOff = 0, smallOff = topNum;
+            for (int t = 0; t < nt; ++t) {
+                const size_t len = n * (t + 1) / nt - n * t / nt;
+                candCount[t] = topOff;
+                candOffset[t] = smallOff;
+                topOff += topCount[t];
+                smallOff += len - topCount[t];
+            }
+        }
+
+        // 阶段4：按块顺序压缩写入 pool_
+        size_t topPos = candCount[tid];
+        size_t smallPos = candOffset[tid];
+        for (size_t i = begin; i < end; ++i) {
+            if (topMask_[i]) {
+                pool_[topPos++] = static_cast<int>(i);
+            } else {
+                pool_[smallPos++] = static_cast<int>(i);
+            }
         }
     }
-    if (sampleIndices.empty()) {
-        sampleIndices.resize(n);
-        sampleWeights.assign(n, 1.0);
-        std::iota(sampleIndices.begin(), sampleIndices.end(), 0);
-    }
+}
+
+void GOSSSampler::drawSmallGradients(size_t topNum, size_t randNum) const {
+    // 小梯度池的排列只由梯度决定（与线程数无关），随机流只由种子与采样轮次决定
+    Philox rng(seed_, {Philox::GOSS, round_++});
+    rng.partialShuffle(pool_.begin() + topNum, pool_.end(), randNum);
 }
 
 void GOSSSampler::sampleWithTiming(const std::vector<double>& gradients,
@@ -189,8 +279,7 @@ void GOSSSampler::adaptiveSample(const std::vector<double>& gradients,
         adaptiveTopRate = std::max(0.1, topRate_ * 0.8);
         adaptiveOtherRate = std::min(0.3, otherRate_ * 1.2);
     }
-    GOSSSampler adaptiveSampler(adaptiveTopRate, adaptiveOtherRate);
-    adaptiveSampler.sample(gradients, sampleIndices, sampleWeights);
+    sampleWithRates(gradients, adaptiveTopRate, adaptiveOtherRate, sampleIndices, sampleWeights);
 }
 
 GOSSSampler::SamplingStats GOSSSampler::getSamplingStats(
@@ -60,7 +60,7 @@ LightGBMTrainer::LightGBMTrainer(const LightGBMConfig& config)
 void LightGBMTrainer::initializeComponents() {
     lossFunction_ = std::make_unique<SquaredLoss>();
     if (config_.enableGOSS) {
-        gossSampler_ = std::make_unique<GOSSSampler>(config_.topRate, config_.otherRate);
+        gossSampler_ = std::make_unique<GOSSSampler>(config_.topRate, config_.otherRate, config_.seed);
     }
     if (config_.enableFeatureBundling) {
         featureBundler_ = std::make_unique<FeatureBundler>(config_.maxBin, config_.maxConflictRate);
@@ -93,26 +93,75 @@ void LightGBMTrainer::train(const std::vector<double>& data,
         }
     }
 
+    runBoosting(data, rowLength, labels, nullptr);
+}
+
+void LightGBMTrainer::trainBinned(const BinnedMatrix& bins) {
+    if (config_.verbose) {
+        std::cout << "LightGBM Binned: " << bins.rows() << " 样本, " << bins.features() << " 特征"
+                  << " (" << (bins.isSpilled() ? "disk" : "memory") << " bins)" << std::endl;
+        std::cout << "Split 方法: " << config_.splitMethod << std::endl;
+        std::cout << "GOSS: " << (config_.enableGOSS ? "Enabled" : "Disabled") << std::endl;
+    }
+
+    treeBuilder_->setExternalBins(&bins);
+    try {
+        runBoosting({}, bins.features(), bins.labels(), &bins);
+    } catch (...) {
+        treeBuilder_->setExternalBins(nullptr);
+        throw;
+    }
+    treeBuilder_->setExternalBins(nullptr);
+}
+
+void LightGBMTrainer::setDataParallel(IDataParallelReducer* reducer) {
+    treeBuilder_->setReducer(reducer);
+    reducer_ = reducer;
+}
+
+void LightGBMTrainer::runBoosting(const std::vector<double>& data,
+                                  int rowLength,
+                                  const std::vector<double>& labels,
+                                  const BinnedMatrix* binned) {
+    const size_t n = labels.size();
+
+    // 每次训练从空模型与空损失历史开始（早停只比较本次训练的损失）；
+    // 分桶缓存按数据地址识别，再次训练时即使地址相同，数据也可能已经改变
+    model_.clear();
+    trainingLoss_.clear();
+    treeBuilder_->invalidateBinnedData();
+    if (gossSampler_) gossSampler_->resetRounds();
+
     // 初始化预测和梯度
     const double baseScore = computeBaseScore(labels);
     model_.setBaseScore(baseScore);
     std::vector<double> predictions(n, baseScore);
     gradients_.assign(n, 0.0);
 
+    validationLoss_.clear();
+    bestIteration_ = -1;
+    if (hasValidation_) {
+        valPredictions_.assign(y_val_.size(), baseScore);
+        validationLoss_.reserve(config_.numIterations);
+    }
+
+    // 融合内核：损失、梯度与 |梯度|（GOSS 需要）一次遍历得到
+    std::vector<double>* absGradOut = config_.enableGOSS ? &absGradients_ : nullptr;
+    treeOutputs_.resize(n);
+    double nextLoss = globalMean(lossFunction_->updatePredictionsAndGradients(
+        labels, nullptr, 0.0, predictions, gradients_, nullptr, absGradOut), n);
+
     // Boosting 迭代
     for (int iter = 0; iter < config_.numIterations; ++iter) {
         auto iterStart = std::chrono::high_resolution_clock::now();
 
-        // 计算损失并更新梯度
-        const double currentLoss = computeLossOptimized(labels, predictions);
+        // 损失与梯度已由上一轮融合内核给出
+        const double currentLoss = nextLoss;
         trainingLoss_.push_back(currentLoss);
-        computeGradientsOptimized(labels, predictions);
 
         // GOSS 采样或全量
         if (config_.enableGOSS) {
-            std::vector<double> absGradients(n);
-            computeAbsGradients(absGradients);
-            gossSampler_->sample(absGradients, sampleIndices_, sampleWeights_);
+            gossSampler_->sample(absGradients_, sampleIndices_, sampleWeights_);
             normalizeWeights(n);
         } else {
             prepareFullSample(n);
@@ -131,7 +180,18 @@ void LightGBMTrainer::train(const std::vector<double>& data,
         }
 
         // **优化2: 高效预测更新**
-        updatePredictionsOptimized(data, rowLength, tree.get(), predictions, n);
+        if (binned) {
+            computeTreeOutputsBinned(*binned, tree.get(), n);
+        } else {
+            computeTreeOutputs(data, rowLength, tree.get(), n);
+        }
+        nextLoss = globalMean(lossFunction_->updatePredictionsAndGradients(
+            labels, treeOutputs_.data(), config_.learningRate,
+            predictions, gradients_, nullptr, absGradOut), n);
+        if (hasValidation_) {
+            updatePredictionsOptimized(X_val_, valRowLength_, tree.get(),
+                                       valPredictions_, valPredictions_.size());
+        }
         model_.addTree(std::move(tree), config_.learningRate);
 
         auto iterEnd = std::chrono::high_resolution_clock::now();
@@ -144,8 +204,16 @@ void LightGBMTrainer::train(const std::vector<double>& data,
                       << " | Time: " << iterTime.count() << " ms" << std::endl;
         }
 
-        // 早停检查
-        if (config_.earlyStoppingRounds > 0 && iter >= config_.earlyStoppingRounds) {
+        // 早停检查：有验证集时使用验证损失（循环结束后回滚到最佳迭代）
+        if (hasValidation_) {
+            if (checkValidationEarlyStop(iter)) {
+                if (config_.verbose) {
+                    std::cout << "Early stopping at iteration " << iter
+                              << ", best iteration: " << bestIteration_ << std::endl;
+                }
+                break;
+            }
+        } else if (config_.earlyStoppingRounds > 0 && iter >= config_.earlyStoppingRounds) {
             if (checkEarlyStop(iter)) {
                 if (config_.verbose) {
                     std::cout << "Early stopping at iteration " << iter << std::endl;
@@ -155,6 +223,8 @@ void LightGBMTrainer::train(const std::vector<double>& data,
         }
     }
 
+    rollbackToBestIteration();
+
     if (config_.verbose) {
         std::cout << "LightGBM Enhanced 训练完成，共 " << model_.getTreeCount() << " 棵树" << std::endl;
     }
@@ -223,25 +293,6 @@ double LightGBMTrainer::computeLossOptimized(const std::vector<double>& labels,
     return loss / n;
 }
 
-void LightGBMTrainer::computeGradientsOptimized(const std::vector<double>& labels,
-                                               const std::vector<double>& predictions) {
-    const size_t n = labels.size();
-    
-    #pragma omp parallel for schedule(static) if(n > 5000)
-    for (size_t i = 0; i < n; ++i) {
-        gradients_[i] = labels[i] - predictions[i];
-    }
-}
-
-void LightGBMTrainer::computeAbsGradients(std::vector<double>& absGradients) const {
-    const size_t n = gradients_.size();
-    
-    #pragma omp parallel for schedule(static) if(n > 5000)
-    for (size_t i = 0; i < n; ++i) {
-        absGradients[i] = std::abs(gradients_[i]);
-    }
-}
-
 void LightGBMTrainer::normalizeWeights(size_t n) {
     const double totalWeight = std::accumulate(sampleWeights_.begin(), sampleWeights_.end(), 0.0);
     if (totalWeight > 0.0) {
@@ -273,6 +324,30 @@ void LightGBMTrainer::updatePredictionsOptimized(const std::vector<double>& data
     }
 }
 
+void LightGBMTrainer::computeTreeOutputs(const std::vector<double>& data,
+                                         int rowLength,
+                                         const Node* tree,
+                                         size_t n) {
+    #pragma omp parallel for schedule(static) if(n > 5000)
+    for (size_t i = 0; i < n; ++i) {
+        treeOutputs_[i] = predictSingleTree(tree, &data[i * rowLength], rowLength);
+    }
+}
+
+void LightGBMTrainer::computeTreeOutputsBinned(const BinnedMatrix& bins,
+                                               const Node* tree,
+                                               size_t n) {
+    #pragma omp parallel for schedule(static) if(n > 5000)
+    for (size_t i = 0; i < n; ++i) {
+        const Node* cur = tree;
+        while (cur && !cur->isLeaf) {
+            const int f = cur->getFeatureIndex();
+            cur = (bins.representative(f, i) <= cur->getThreshold()) ? cur->getLeft() : cur->getRight();
+        }
+        treeOutputs_[i] = cur ? cur->getPrediction() : 0.0;
+    }
+}
+
 bool LightGBMTrainer::checkEarlyStop(int currentIter) const {
     const int patience = config_.earlyStoppingRounds;
     if (static_cast<int>(trainingLoss_.size()) < patience + 1) {
@@ -287,6 +362,33 @@ bool LightGBMTrainer::checkEarlyStop(int currentIter) const {
     return currentLoss >= bestLoss - config_.tolerance;
 }
 
+bool LightGBMTrainer::checkValidationEarlyStop(int currentIter) {
+    const double valLoss = globalMean(computeLossOptimized(y_val_, valPredictions_), y_val_.size());
+    validationLoss_.push_back(valLoss);
+
+    if (bestIteration_ < 0 || valLoss < bestValidationLoss_ - config_.tolerance) {
+        bestValidationLoss_ = valLoss;
+        bestIteration_ = currentIter;
+        return false;
+    }
+
+    return config_.earlyStoppingRounds > 0 &&
+           currentIter - bestIteration_ >= config_.earlyStoppingRounds;
+}
+
+// 有验证集时最终模型总是截断到验证损失最低的迭代（未触发早停时也一样）
+void LightGBMTrainer::rollbackToBestIteration() {
+    if (!hasValidation_ || bestIteration_ < 0) return;
+    const size_t keep = static_cast<size_t>(bestIteration_) + 1;
+    if (model_.getTreeCount() <= keep) return;
+    model_.truncate(keep);
+    if (config_.verbose) {
+        std::cout << "Rolled back to best iteration " << bestIteration_
+                  << " (validation loss " << std::fixed << std::setprecision(6)
+                  << bestValidationLoss_ << ")" << std::endl;
+    }
+}
+
 // **保留其他必要方法**
 
 double LightGBMTrainer::predict(const double* sample, int rowLength) const {
@@ -324,9 +426,21 @@ double LightGBMTrainer::computeBaseScore(const std::vector<double>& y) const {
         sum += y[i];
     }
     
+    if (reducer_) {
+        double totals[2] = {sum, static_cast<double>(n)};
+        reducer_->sum(totals, 2);
+        return totals[1] > 0.0 ? totals[0] / totals[1] : 0.0;
+    }
     return sum / n;
 }
 
+double LightGBMTrainer::globalMean(double localMean, size_t n) const {
+    if (!reducer_) return localMean;
+    double totals[2] = {n > 0 ? localMean * static_cast<double>(n) : 0.0, static_cast<double>(n)};
+    reducer_->sum(totals, 2);
+    return totals[1] > 0.0 ? totals[0] / totals[1] : 0.0;
+}
+
 std::vector<double> LightGBMTrainer::calculateFeatureImportance(int numFeatures) const {
     return model_.getFeatureImportance(numFeatures);
 }
@@ -0,0 +1,114 @@
+#include "lightgbm/trainer/MPILightGBMTrainer.hpp"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+// Collectives behind IDataParallelReducer; counts above INT_MAX are split into rounds
+class MPILightGBMTrainer::Reducer : public IDataParallelReducer {
+public:
+    explicit Reducer(MPI_Comm comm) : comm_(comm) {}
+
+    void sum(double* values, size_t count) override { allreduce(values, count, MPI_SUM); }
+    void min(double* values, size_t count) override { allreduce(values, count, MPI_MIN); }
+    void max(double* values, size_t count) override { allreduce(values, count, MPI_MAX); }
+
+    std::vector<std::vector<double>> allgather(const std::vector<double>& local) override {
+        int size = 1;
+        MPI_Comm_size(comm_, &size);
+
+        const int localCount = static_cast<int>(local.size());
+        std::vector<int> counts(size), displs(size);
+        MPI_Allgather(&localCount, 1, MPI_INT, counts.data(), 1, MPI_INT, comm_);
+        int total = 0;
+        for (int r = 0; r < size; ++r) {
+            displs[r] = total;
+            total += counts[r];
+        }
+
+        std::vector<double> all(total);
+        MPI_Allgatherv(local.data(), localCount, MPI_DOUBLE,
+                       all.data(), counts.data(), displs.data(), MPI_DOUBLE, comm_);
+
+        std::vector<std::vector<double>> parts(size);
+        for (int r = 0; r < size; ++r) {
+            parts[r].assign(all.begin() + displs[r], all.begin() + displs[r] + counts[r]);
+        }
+        return parts;
+    }
+
+private:
+    void allreduce(double* values, size_t count, MPI_Op op) {
+        for (size_t offset = 0; offset < count; offset += INT_MAX) {
+            const size_t n = std::min<size_t>(INT_MAX, count - offset);
+            MPI_Allreduce(MPI_IN_PLACE, values + offset, static_cast<int>(n), MPI_DOUBLE, op, comm_);
+        }
+    }
+
+    MPI_Comm comm_;
+};
+
+MPILightGBMTrainer::MPILightGBMTrainer(const LightGBMConfig& config, MPI_Comm comm)
+    : comm_(comm) {
+    MPI_Comm_rank(comm_, &mpiRank_);
+    MPI_Comm_size(comm_, &mpiSize_);
+
+    // Only the master reports progress; feature bundling decisions are made on
+    // local rows and would differ between processes, so every feature stays separate
+    LightGBMConfig localConfig = config;
+    localConfig.verbose = config.verbose && mpiRank_ == 0;
+    localConfig.enableFeatureBundling = false;
+
+    reducer_ = std::make_unique<Reducer>(comm_);
+    trainer_ = std::make_unique<LightGBMTrainer>(localConfig);
+    trainer_->setDataParallel(reducer_.get());
+}
+
+MPILightGBMTrainer::~MPILightGBMTrainer() = default;
+
+void MPILightGBMTrainer::train(const std::vector<double>& localData,
+                               int numFeatures,
+                               const std::vector<double>& localLabels) {
+    if (localData.size() != localLabels.size() * static_cast<size_t>(numFeatures)) {
+        throw std::invalid_argument("Process " + std::to_string(mpiRank_) + ": data size mismatch");
+    }
+    trainer_->train(localData, numFeatures, localLabels);
+}
+
+void MPILightGBMTrainer::evaluate(const std::vector<double>& localX,
+                                  int numFeatures,
+                                  const std::vector<double>& localY,
+                                  double& mse,
+                                  double& mae) {
+    const size_t n = localY.size();
+    double sums[3] = {0.0, 0.0, static_cast<double>(n)};
+
+    double sq = 0.0, abs = 0.0;
+    #pragma omp parallel for reduction(+:sq,abs) schedule(static) if(n > 5000)
+    for (size_t i = 0; i < n; ++i) {
+        const double diff = localY[i] - trainer_->predict(&localX[i * numFeatures], numFeatures);
+        sq += diff * diff;
+        abs += std::abs(diff);
+    }
+    sums[0] = sq;
+    sums[1] = abs;
+
+    MPI_Allreduce(MPI_IN_PLACE, sums, 3, MPI_DOUBLE, MPI_SUM, comm_);
+    mse = sums[2] > 0.0 ? sums[0] / sums[2] : 0.0;
+    mae = sums[2] > 0.0 ? sums[1] / sums[2] : 0.0;
+}
+
+bool MPILightGBMTrainer::modelsAgree(const double* sample, int numFeatures) const {
+    // Only rank 0's sample is used; other processes may pass nullptr
+    std::vector<double> row(numFeatures, 0.0);
+    if (mpiRank_ == 0 && sample) std::copy(sample, sample + numFeatures, row.begin());
+    MPI_Bcast(row.data(), numFeatures, MPI_DOUBLE, 0, comm_);
+
+    const double pred = trainer_->predict(row.data(), numFeatures);
+    double lo = pred, hi = pred;
+    MPI_Allreduce(MPI_IN_PLACE, &lo, 1, MPI_DOUBLE, MPI_MIN, comm_);
+    MPI_Allreduce(MPI_IN_PLACE, &hi, 1, MPI_DOUBLE, MPI_MAX, comm_);
+    return lo == hi;
+}
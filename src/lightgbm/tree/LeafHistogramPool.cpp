@@ -0,0 +1,93 @@
+// =============================================================================
+// src/lightgbm/tree/LeafHistogramPool.cpp
+// =============================================================================
+#include "lightgbm/tree/LeafHistogramPool.hpp"
+
+void LeafHistogramPool::reset(size_t capacity, size_t binsPerHistogram) {
+    if (binsPerHistogram != binsPerHistogram_ || capacity < slots_.size()) {
+        slots_.clear();
+        slotOwner_.clear();
+        lruPos_.clear();
+    }
+    capacity_ = capacity;
+    binsPerHistogram_ = binsPerHistogram;
+
+    // 已分配槽位全部回到空闲列表，内存跨树复用
+    lru_.clear();
+    leafToSlot_.clear();
+    freeSlots_.clear();
+    for (int s = static_cast<int>(slots_.size()) - 1; s >= 0; --s) {
+        slotOwner_[s] = -1;
+        lruPos_[s] = lru_.end();
+        freeSlots_.push_back(s);
+    }
+    stats_ = Stats{};
+}
+
+void LeafHistogramPool::touch(int slot) {
+    lru_.splice(lru_.begin(), lru_, lruPos_[slot]);
+}
+
+GradientHistBin* LeafHistogramPool::get(int leafId) {
+    auto it = leafToSlot_.find(leafId);
+    if (it == leafToSlot_.end()) {
+        ++stats_.misses;
+        return nullptr;
+    }
+    ++stats_.hits;
+    touch(it->second);
+    return slots_[it->second].data();
+}
+
+GradientHistBin* LeafHistogramPool::acquire(int leafId) {
+    auto existing = leafToSlot_.find(leafId);
+    if (existing != leafToSlot_.end()) {
+        touch(existing->second);
+        return slots_[existing->second].data();
+    }
+
+    int slot;
+    if (!freeSlots_.empty()) {
+        slot = freeSlots_.back();
+        freeSlots_.pop_back();
+    } else if (slots_.size() < capacity_) {
+        // 按需分配新槽位
+        slot = static_cast<int>(slots_.size());
+        slots_.emplace_back(binsPerHistogram_);
+        slotOwner_.push_back(-1);
+        lruPos_.push_back(lru_.end());
+    } else {
+        // **LRU 淘汰**：被淘汰叶子之后需要时由调用方重建
+        slot = lru_.back();
+        lru_.pop_back();
+        leafToSlot_.erase(slotOwner_[slot]);
+        ++stats_.evictions;
+    }
+
+    slotOwner_[slot] = leafId;
+    lru_.push_front(slot);
+    lruPos_[slot] = lru_.begin();
+    leafToSlot_[leafId] = slot;
+    return slots_[slot].data();
+}
+
+void LeafHistogramPool::rename(int fromLeafId, int toLeafId) {
+    auto it = leafToSlot_.find(fromLeafId);
+    if (it == leafToSlot_.end()) return;
+    const int slot = it->second;
+    leafToSlot_.erase(it);
+    leafToSlot_[toLeafId] = slot;
+    slotOwner_[slot] = toLeafId;
+    touch(slot);
+}
+
+void LeafHistogramPool::release(int leafId) {
+    auto it = leafToSlot_.find(leafId);
+    if (it == leafToSlot_.end()) return;
+    const int slot = it->second;
+    leafToSlot_.erase(it);
+    lru_.erase(lruPos_[slot]);
+    lruPos_[slot] = lru_.end();
+    slotOwner_[slot] = -1;
+    freeSlots_.push_back(slot);
+}
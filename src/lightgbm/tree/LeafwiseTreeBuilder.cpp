@@ -1,15 +1,79 @@
 // =============================================================================
 // src/lightgbm/tree/LeafwiseTreeBuilder.cpp
-// OpenMP 深度并行优化版本（减少锁竞争、提高阈值、预分配缓冲）
+// OpenMP 深度并行优化版本（叶子区间 + 直方图池、预分配缓冲）
 // =============================================================================
 #include "lightgbm/tree/LeafwiseTreeBuilder.hpp"
 #include <algorithm>
 #include <numeric>
 #include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
 #ifdef _OPENMP
 #include <omp.h>
 #endif
 
+int LeafwiseTreeBuilder::parseHistogramBins() const {
+    const std::string& method = config_.splitMethod;
+    int bins = 0;
+    if (method == "histogram_ew" || method == "histogram_eq") {
+        bins = config_.histogramBins;
+    } else if (method.find("histogram_ew:") == 0 || method.find("histogram_eq:") == 0) {
+        bins = std::stoi(method.substr(method.find(':') + 1));
+    }
+    // 桶号以 uint16_t 存储
+    return bins > 0 ? std::clamp(bins, 2, 65535) : 0;
+}
+
+void LeafwiseTreeBuilder::setExternalBins(const BinnedMatrix* bins) {
+    if (bins && (histogramBins_ == 0 || bins->maxBins() != histogramBins_ ||
+                 bins->isEqualFrequency() != equalFrequency_)) {
+        throw std::invalid_argument(std::string("External bins require ") +
+                                    (bins->isEqualFrequency() ? "histogram_eq" : "histogram_ew") +
+                                    " with " + std::to_string(bins->maxBins()) + " bins");
+    }
+    externalBins_ = bins;
+    invalidateBinnedData();
+}
+
+// 强制下一次 buildTree 重新准备分桶数据
+void LeafwiseTreeBuilder::invalidateBinnedData() {
+    binnedSource_ = nullptr;
+    binBase_ = nullptr;
+    binnedData_.clear();
+}
+
+void LeafwiseTreeBuilder::setReducer(IDataParallelReducer* reducer) {
+    if (reducer && histogramBins_ == 0) {
+        throw std::invalid_argument("Data-parallel training requires histogram_ew or histogram_eq");
+    }
+    if (reducer && externalBins_) {
+        throw std::invalid_argument("Data-parallel training does not support external bins");
+    }
+    reducer_ = reducer;
+    // 分桶范围随之改变，强制下一次 buildTree 重新分桶
+    binnedSource_ = nullptr;
+    binnedData_.clear();
+}
+
+// 直方图按 (梯度和, 权重和, 样本数) 打包成连续 double 后一次求和
+void LeafwiseTreeBuilder::reduceHistogram(GradientHistBin* hist) {
+    if (!reducer_) return;
+    const size_t total = histPool_.binsPerHistogram();
+    reduceBuffer_.resize(total * 3);
+    for (size_t i = 0; i < total; ++i) {
+        reduceBuffer_[3 * i] = hist[i].sumGradients;
+        reduceBuffer_[3 * i + 1] = hist[i].sumWeights;
+        reduceBuffer_[3 * i + 2] = hist[i].count;
+    }
+    reducer_->sum(reduceBuffer_.data(), reduceBuffer_.size());
+    for (size_t i = 0; i < total; ++i) {
+        hist[i].sumGradients = reduceBuffer_[3 * i];
+        hist[i].sumWeights = reduceBuffer_[3 * i + 1];
+        hist[i].count = static_cast<int>(reduceBuffer_[3 * i + 2]);
+    }
+}
+
 std::unique_ptr<Node> LeafwiseTreeBuilder::buildTree(
     const std::vector<double>& data,
     int rowLength,
@@ -22,51 +86,47 @@ std::unique_ptr<Node> LeafwiseTreeBuilder::buildTree(
     // 清空优先队列
     while (!leafQueue_.empty()) leafQueue_.pop();
 
-    // 初始化根节点
-    auto root = std::make_unique<Node>();
-    root->samples = sampleIndices.size();
-
-    // 计算根节点预测（加权平均），阈值 n>=2000 并行
-    double weightedSum = 0.0, totalWeight = 0.0;
+    // **GOSS 权重按行号展开**：子节点只搬运索引，权重始终按 idx 查取
     size_t n = sampleIndices.size();
-    if (n >= 2000) {
-        #pragma omp parallel for reduction(+:weightedSum, totalWeight) schedule(static)
-        for (size_t i = 0; i < n; ++i) {
-            int idx = sampleIndices[i];
-            double w = sampleWeights[i];
-            weightedSum += targets[idx] * w;
-            totalWeight += w;
-        }
-    } else {
-        for (size_t i = 0; i < n; ++i) {
-            int idx = sampleIndices[i];
-            double w = sampleWeights[i];
-            weightedSum += targets[idx] * w;
-            totalWeight += w;
+    rowWeights_.assign(targets.size(), 0.0);
+    weighted_ = false;
+    for (size_t i = 0; i < n; ++i) {
+        const double w = (i < sampleWeights.size()) ? sampleWeights[i] : 1.0;
+        rowWeights_[sampleIndices[i]] = w;
+        weighted_ |= (w != 1.0);
+    }
+
+    // 共享划分索引数组：根节点占据整个区间
+    order_.assign(sampleIndices.begin(), sampleIndices.end());
+    nextLeafId_ = 0;
+
+    if (histogramBins_ > 0) {
+        prepareBinnedData(data, rowLength, targets.size());
+        // 同时存活的叶子不超过 numLeaves，池容量取二者较小值
+        size_t capacity = static_cast<size_t>(std::max(config_.numLeaves, 2));
+        if (config_.histPoolSize > 0) {
+            capacity = std::min(capacity, static_cast<size_t>(config_.histPoolSize));
         }
+        histPool_.reset(std::max<size_t>(capacity, 2),
+                        static_cast<size_t>(numFeatures_) * histogramBins_);
     }
-    double rootPrediction = (totalWeight > 0.0) ? (weightedSum / totalWeight) : 0.0;
 
-    // 根节点尝试分裂
-    LeafInfo rootInfo;
+    // 初始化根节点
+    auto root = std::make_unique<Node>();
+
+    LeafInfo rootInfo{};
     rootInfo.node = root.get();
-    rootInfo.sampleIndices = sampleIndices;
-    if (n < static_cast<size_t>(config_.minDataInLeaf) * 2) {
-        // 样本太少，直接做叶
-        root->makeLeaf(rootPrediction);
+    rootInfo.begin = 0;
+    rootInfo.end = static_cast<int>(n);
+    rootInfo.leafId = nextLeafId_++;
+    computeLeafSums(rootInfo, targets);
+    root->samples = static_cast<int>(rootInfo.count);
+
+    // 根节点尝试分裂
+    if (!evaluateLeaf(data, rowLength, targets, rootInfo)) {
+        finalizeLeaf(rootInfo);
         return root;
     }
-    if (n >= 2000) {
-        if (!findBestSplitParallel(data, rowLength, targets, rootInfo.sampleIndices, sampleWeights, rootInfo)) {
-            root->makeLeaf(rootPrediction);
-            return root;
-        }
-    } else {
-        if (!findBestSplitSerial(data, rowLength, targets, rootInfo.sampleIndices, sampleWeights, rootInfo)) {
-            root->makeLeaf(rootPrediction);
-            return root;
-        }
-    }
     leafQueue_.push(rootInfo);
 
     int currentLeaves = 1;
@@ -75,293 +135,439 @@ std::unique_ptr<Node> LeafwiseTreeBuilder::buildTree(
         LeafInfo bestLeaf = leafQueue_.top();
         leafQueue_.pop();
 
-        // 如果不足以继续分裂
-        size_t m = bestLeaf.sampleIndices.size();
+        // 如果不足以继续分裂，直接置为叶子
         if (bestLeaf.splitGain <= config_.minSplitGain ||
-            m < static_cast<size_t>(config_.minDataInLeaf) * 2) {
-            // 直接并行/串行计算叶子预测，并置为叶子
-            double leafPred = (m >= 500)
-                              ? computeLeafPredictionParallel(bestLeaf.sampleIndices, targets, sampleWeights)
-                              : computeLeafPredictionSerial(bestLeaf.sampleIndices, targets, sampleWeights);
-            bestLeaf.node->makeLeaf(leafPred);
+            bestLeaf.count < config_.minDataInLeaf * 2) {
+            finalizeLeaf(bestLeaf);
             continue;
         }
 
-        // 并行或串行执行分裂
-        if (m >= 2000) {
-            splitLeafParallel(bestLeaf, data, rowLength, targets, sampleWeights);
-        } else {
-            splitLeafSerial(bestLeaf, data, rowLength, targets, sampleWeights);
-        }
+        splitLeaf(bestLeaf, data, rowLength, targets);
         currentLeaves++;
     }
 
-    // 处理剩余所有节点：串行或并行
-    if (!leafQueue_.empty()) {
-        if (leafQueue_.size() >= 4) {
-            processRemainingLeavesParallel(targets, sampleWeights);
-        } else {
-            processRemainingLeavesSerial(targets, sampleWeights);
-        }
+    // 处理剩余所有节点：叶值由区间统计直接得到
+    while (!leafQueue_.empty()) {
+        finalizeLeaf(leafQueue_.top());
+        leafQueue_.pop();
     }
 
     return root;
 }
 
-// 串行查找最佳 split
-bool LeafwiseTreeBuilder::findBestSplitSerial(const std::vector<double>& data,
-                                              int rowLength,
-                                              const std::vector<double>& targets,
-                                              const std::vector<int>& indices,
-                                              const std::vector<double>& weights,
-                                              LeafInfo& leafInfo) {
-    if (indices.size() < static_cast<size_t>(config_.minDataInLeaf) * 2) return false;
-    double currentMetric = criterion_->nodeMetric(targets, indices);
-    auto [f, thresh, gain] =
-        finder_->findBestSplit(data, rowLength, targets, indices, currentMetric, *criterion_);
-    leafInfo.bestFeature = f;
-    leafInfo.bestThreshold = thresh;
-    leafInfo.splitGain = gain;
-    return f >= 0 && gain > 0;
-}
+// 全数据一次等宽分桶（数据不变时跨树复用）；外部桶号矩阵时直接采用
+void LeafwiseTreeBuilder::prepareBinnedData(const std::vector<double>& data,
+                                            int rowLength,
+                                            size_t numRows) {
+    if (externalBins_) {
+        if (binBase_ == externalBins_->data()) return;
+        numRows_ = externalBins_->rows();
+        numFeatures_ = externalBins_->features();
+        binUpperBounds_.assign(numFeatures_, {});
+        featureBins_.assign(numFeatures_, 1);
+        for (int f = 0; f < numFeatures_; ++f) {
+            binUpperBounds_[f] = externalBins_->binning(f).upper;
+            featureBins_[f] = externalBins_->binning(f).bins;
+        }
+        binnedSource_ = nullptr;
+        binBase_ = externalBins_->data();
+        return;
+    }
 
-// 并行查找最佳 split（本质与串行相同，仅称为 parallel）
-bool LeafwiseTreeBuilder::findBestSplitParallel(const std::vector<double>& data,
-                                                int rowLength,
-                                                const std::vector<double>& targets,
-                                                const std::vector<int>& indices,
-                                                const std::vector<double>& weights,
-                                                LeafInfo& leafInfo) {
-    if (indices.size() < static_cast<size_t>(config_.minDataInLeaf) * 2) return false;
-    double currentMetric = criterion_->nodeMetric(targets, indices);
-    auto [f, thresh, gain] =
-        finder_->findBestSplit(data, rowLength, targets, indices, currentMetric, *criterion_);
-    leafInfo.bestFeature = f;
-    leafInfo.bestThreshold = thresh;
-    leafInfo.splitGain = gain;
-    return f >= 0 && gain > 0;
+    if (binnedSource_ == data.data() && numRows_ == numRows &&
+        numFeatures_ == rowLength && !binnedData_.empty()) {
+        return;
+    }
+
+    binnedSource_ = data.data();
+    numRows_ = numRows;
+    numFeatures_ = rowLength;
+    binnedData_.resize(static_cast<size_t>(rowLength) * numRows);
+    binUpperBounds_.assign(rowLength, {});
+    featureBins_.assign(rowLength, 1);
+    binBase_ = binnedData_.data();
+
+    // 第一遍：各特征的取值范围（等频时同时建分位数摘要）
+    std::vector<FeatureRangeSketch> ranges(rowLength);
+    std::vector<QuantileSketch> sketches(equalFrequency_ ? rowLength : 0);
+    #pragma omp parallel for schedule(dynamic) if(rowLength > 1 && numRows > 2000)
+    for (int f = 0; f < rowLength; ++f) {
+        for (size_t i = 0; i < numRows; ++i) {
+            const double v = data[i * rowLength + f];
+            ranges[f].add(v);
+            if (equalFrequency_) sketches[f].add(v);
+        }
+    }
+
+    // 与流式分桶（BinnedMatrix）共用同一分桶规则
+    std::vector<FeatureBinning> binnings(rowLength);
+    globalBinnings(ranges, sketches, binnings);
+
+    // 第二遍：写入列存桶号
+    #pragma omp parallel for schedule(dynamic) if(rowLength > 1 && numRows > 2000)
+    for (int f = 0; f < rowLength; ++f) {
+        uint16_t* col = &binnedData_[static_cast<size_t>(f) * numRows];
+        const FeatureBinning& binning = binnings[f];
+        for (size_t i = 0; i < numRows; ++i) col[i] = binning.index(data[i * rowLength + f]);
+
+        featureBins_[f] = binning.bins;
+        binUpperBounds_[f] = binning.upper;
+    }
 }
 
-// 串行分裂叶子
-void LeafwiseTreeBuilder::splitLeafSerial(LeafInfo& leafInfo,
-                                          const std::vector<double>& data,
-                                          int rowLength,
-                                          const std::vector<double>& targets,
-                                          const std::vector<double>& sampleWeights) {
-    leafInfo.node->makeInternal(leafInfo.bestFeature, leafInfo.bestThreshold);
-    leafInfo.node->leftChild = std::make_unique<Node>();
-    leafInfo.node->rightChild = std::make_unique<Node>();
-
-    leftIndices_.clear();
-    rightIndices_.clear();
-    leftWeights_.clear();
-    rightWeights_.clear();
-
-    for (size_t i = 0; i < leafInfo.sampleIndices.size(); ++i) {
-        int idx = leafInfo.sampleIndices[i];
-        double value = data[idx * rowLength + leafInfo.bestFeature];
-        double w = (i < sampleWeights.size()) ? sampleWeights[i] : 1.0;
-        if (value <= leafInfo.bestThreshold) {
-            leftIndices_.push_back(idx);
-            leftWeights_.push_back(w);
-        } else {
-            rightIndices_.push_back(idx);
-            rightWeights_.push_back(w);
+// 单进程直接由本地统计分桶；数据并行时先取全局范围、合并各进程摘要，各进程切点一致
+void LeafwiseTreeBuilder::globalBinnings(std::vector<FeatureRangeSketch>& ranges,
+                                         std::vector<QuantileSketch>& sketches,
+                                         std::vector<FeatureBinning>& binnings) {
+    const size_t numFeatures = ranges.size();
+    if (reducer_) {
+        std::vector<double> mins(numFeatures), maxs(numFeatures);
+        for (size_t f = 0; f < numFeatures; ++f) {
+            mins[f] = ranges[f].min;
+            maxs[f] = ranges[f].max;
+        }
+        reducer_->min(mins.data(), numFeatures);
+        reducer_->max(maxs.data(), numFeatures);
+        for (size_t f = 0; f < numFeatures; ++f) {
+            ranges[f].min = mins[f];
+            ranges[f].max = maxs[f];
+        }
+
+        if (equalFrequency_) {
+            // 各特征摘要依次序列化为 [长度, 内容...]；每个进程都从空摘要按进程序合并
+            std::vector<double> local, buffer;
+            for (const auto& sketch : sketches) {
+                sketch.serialize(buffer);
+                local.push_back(static_cast<double>(buffer.size()));
+                local.insert(local.end(), buffer.begin(), buffer.end());
+            }
+            const auto parts = reducer_->allgather(local);
+            for (auto& sketch : sketches) sketch = QuantileSketch();
+            for (const auto& part : parts) {
+                size_t pos = 0;
+                for (auto& sketch : sketches) {
+                    const size_t len = static_cast<size_t>(part[pos++]);
+                    sketch.mergeSerialized(part.data() + pos, len);
+                    pos += len;
+                }
+            }
         }
     }
 
-    // 左子节点
-    if (leftIndices_.size() >= static_cast<size_t>(config_.minDataInLeaf)) {
-        LeafInfo leftInfo;
-        leftInfo.node = leafInfo.node->leftChild.get();
-        leftInfo.sampleIndices = leftIndices_;
-        leftInfo.node->samples = leftIndices_.size();
-        if (leftIndices_.size() >= static_cast<size_t>(config_.minDataInLeaf) * 2 &&
-            findBestSplitSerial(data, rowLength, targets, leftInfo.sampleIndices, leftWeights_, leftInfo)) {
-            leafQueue_.push(leftInfo);
+    for (size_t f = 0; f < numFeatures; ++f) {
+        if (equalFrequency_) {
+            binnings[f].initFromCuts(sketches[f].cutPoints(histogramBins_), ranges[f].min, ranges[f].max);
         } else {
-            double leftPred = computeLeafPredictionSerial(leftIndices_, targets, leftWeights_);
-            leftInfo.node->makeLeaf(leftPred);
+            binnings[f].initEqualWidth(ranges[f].min, ranges[f].max, histogramBins_);
         }
-    } else {
-        double leftPred = computeLeafPredictionSerial(leftIndices_, targets, leftWeights_);
-        leafInfo.node->leftChild->makeLeaf(leftPred);
     }
+}
 
-    // 右子节点（逻辑同左）
-    if (rightIndices_.size() >= static_cast<size_t>(config_.minDataInLeaf)) {
-        LeafInfo rightInfo;
-        rightInfo.node = leafInfo.node->rightChild.get();
-        rightInfo.sampleIndices = rightIndices_;
-        rightInfo.node->samples = rightIndices_.size();
-        if (rightIndices_.size() >= static_cast<size_t>(config_.minDataInLeaf) * 2 &&
-            findBestSplitSerial(data, rowLength, targets, rightInfo.sampleIndices, rightWeights_, rightInfo)) {
-            leafQueue_.push(rightInfo);
-        } else {
-            double rightPred = computeLeafPredictionSerial(rightIndices_, targets, rightWeights_);
-            rightInfo.node->makeLeaf(rightPred);
+// 由区间 [begin, end) 构建所有特征的梯度直方图
+void LeafwiseTreeBuilder::buildLeafHistogram(const LeafInfo& leaf,
+                                             const std::vector<double>& targets,
+                                             GradientHistBin* hist) const {
+    const int bins = histogramBins_;
+    const int* rows = order_.data();
+
+    #pragma omp parallel for schedule(dynamic) if(leaf.size() >= 2000 && numFeatures_ > 1)
+    for (int f = 0; f < numFeatures_; ++f) {
+        GradientHistBin* h = hist + static_cast<size_t>(f) * bins;
+        std::fill(h, h + featureBins_[f], GradientHistBin{});
+        const uint16_t* col = binBase_ + static_cast<size_t>(f) * numRows_;
+
+        for (int i = leaf.begin; i < leaf.end; ++i) {
+            const int idx = rows[i];
+            const double w = rowWeights_[idx];
+            GradientHistBin& bin = h[col[idx]];
+            bin.sumGradients += w * targets[idx];
+            bin.sumWeights += w;
+            ++bin.count;
         }
-    } else {
-        double rightPred = computeLeafPredictionSerial(rightIndices_, targets, rightWeights_);
-        leafInfo.node->rightChild->makeLeaf(rightPred);
     }
 }
 
-// 并行分裂叶子，减少锁竞争：用线程本地缓冲收集子节点，最后串行合并
-void LeafwiseTreeBuilder::splitLeafParallel(LeafInfo& leafInfo,
-                                            const std::vector<double>& data,
-                                            int rowLength,
-                                            const std::vector<double>& targets,
-                                            const std::vector<double>& sampleWeights) {
-    leafInfo.node->makeInternal(leafInfo.bestFeature, leafInfo.bestThreshold);
-    leafInfo.node->leftChild = std::make_unique<Node>();
-    leafInfo.node->rightChild = std::make_unique<Node>();
-
-    size_t m = leafInfo.sampleIndices.size();
-    leftIndices_.clear();
-    rightIndices_.clear();
-    leftWeights_.clear();
-    rightWeights_.clear();
-    leftIndices_.reserve(m / 2 + 1);
-    rightIndices_.reserve(m / 2 + 1);
-    leftWeights_.reserve(m / 2 + 1);
-    rightWeights_.reserve(m / 2 + 1);
-
-    // 并行判断放到局部缓冲
-    int bestFeat = leafInfo.bestFeature;
-    double bestThresh = leafInfo.bestThreshold;
-    #pragma omp parallel
+// 直方图上扫描分裂点：增益 = (S_L²/W_L + S_R²/W_R - S²/W) / W（加权 MSE 下降）
+bool LeafwiseTreeBuilder::findBestSplitFromHistogram(const GradientHistBin* hist,
+                                                     LeafInfo& leaf) const {
+    const double totalS = leaf.sumGradients;
+    const double totalW = leaf.sumWeights;
+    const long long totalCount = leaf.count;
+    if (totalW <= 0.0) return false;
+
+    const int minData = std::max(config_.minDataInLeaf, 1);
+    const double parentScore = totalS * totalS / totalW;
+    const int bins = histogramBins_;
+
+    int bestFeature = -1;
+    int bestBin = -1;
+    double bestGain = 0.0;
+
+    #pragma omp parallel if(numFeatures_ > 4 && numFeatures_ * bins >= 16384)
     {
-        std::vector<int> localLeftIdx, localRightIdx;
-        std::vector<double> localLeftW, localRightW;
-        localLeftIdx.reserve(m / 4 + 1);
-        localRightIdx.reserve(m / 4 + 1);
-        localLeftW.reserve(m / 4 + 1);
-        localRightW.reserve(m / 4 + 1);
-
-        #pragma omp for schedule(dynamic)
-        for (size_t i = 0; i < m; ++i) {
-            int idx = leafInfo.sampleIndices[i];
-            double value = data[idx * rowLength + bestFeat];
-            double w = (i < sampleWeights.size()) ? sampleWeights[i] : 1.0;
-            if (value <= bestThresh) {
-                localLeftIdx.push_back(idx);
-                localLeftW.push_back(w);
-            } else {
-                localRightIdx.push_back(idx);
-                localRightW.push_back(w);
+        int localFeature = -1;
+        int localBin = -1;
+        double localGain = 0.0;
+
+        #pragma omp for schedule(dynamic) nowait
+        for (int f = 0; f < numFeatures_; ++f) {
+            const GradientHistBin* h = hist + static_cast<size_t>(f) * bins;
+            double leftS = 0.0, leftW = 0.0;
+            long long leftCount = 0;
+
+            for (int b = 0; b + 1 < featureBins_[f]; ++b) {
+                leftS += h[b].sumGradients;
+                leftW += h[b].sumWeights;
+                leftCount += h[b].count;
+
+                if (leftCount < minData) continue;
+                if (totalCount - leftCount < minData) break;
+
+                const double rightW = totalW - leftW;
+                if (leftW <= 0.0 || rightW <= 0.0) continue;
+                const double rightS = totalS - leftS;
+
+                const double gain =
+                    (leftS * leftS / leftW + rightS * rightS / rightW - parentScore) / totalW;
+                if (gain > localGain) {
+                    localGain = gain;
+                    localFeature = f;
+                    localBin = b;
+                }
             }
         }
 
         #pragma omp critical
         {
-            leftIndices_.insert(leftIndices_.end(), localLeftIdx.begin(), localLeftIdx.end());
-            leftWeights_.insert(leftWeights_.end(), localLeftW.begin(), localLeftW.end());
-            rightIndices_.insert(rightIndices_.end(), localRightIdx.begin(), localRightIdx.end());
-            rightWeights_.insert(rightWeights_.end(), localRightW.begin(), localRightW.end());
+            if (localFeature >= 0 &&
+                (localGain > bestGain ||
+                 (localGain == bestGain && (bestFeature < 0 || localFeature < bestFeature)))) {
+                bestGain = localGain;
+                bestFeature = localFeature;
+                bestBin = localBin;
+            }
         }
     }
 
-    // 左子节点
-    if (leftIndices_.size() >= static_cast<size_t>(config_.minDataInLeaf)) {
-        LeafInfo leftInfo;
-        leftInfo.node = leafInfo.node->leftChild.get();
-        leftInfo.sampleIndices = leftIndices_;
-        leftInfo.node->samples = leftIndices_.size();
-        if (leftIndices_.size() >= static_cast<size_t>(config_.minDataInLeaf) * 2 &&
-            findBestSplitParallel(data, rowLength, targets, leftInfo.sampleIndices, leftWeights_, leftInfo)) {
-            // 线程安全插入：这里只在并行段外，因为 findBestSplitParallel 只有判断，无插入冲突
-            leafQueue_.push(leftInfo);
-        } else {
-            double leftPred = computeLeafPredictionParallel(leftIndices_, targets, leftWeights_);
-            leftInfo.node->makeLeaf(leftPred);
-        }
-    } else {
-        double leftPred = computeLeafPredictionParallel(leftIndices_, targets, leftWeights_);
-        leafInfo.node->leftChild->makeLeaf(leftPred);
-    }
+    leaf.bestFeature = bestFeature;
+    leaf.bestBin = bestBin;
+    leaf.bestThreshold = (bestFeature >= 0) ? binUpperBounds_[bestFeature][bestBin] : 0.0;
+    leaf.splitGain = bestGain;
+    return bestFeature >= 0 && bestGain > 0;
+}
 
-    // 右子节点
-    if (rightIndices_.size() >= static_cast<size_t>(config_.minDataInLeaf)) {
-        LeafInfo rightInfo;
-        rightInfo.node = leafInfo.node->rightChild.get();
-        rightInfo.sampleIndices = rightIndices_;
-        rightInfo.node->samples = rightIndices_.size();
-        if (rightIndices_.size() >= static_cast<size_t>(config_.minDataInLeaf) * 2 &&
-            findBestSplitParallel(data, rowLength, targets, rightInfo.sampleIndices, rightWeights_, rightInfo)) {
-            leafQueue_.push(rightInfo);
-        } else {
-            double rightPred = computeLeafPredictionParallel(rightIndices_, targets, rightWeights_);
-            rightInfo.node->makeLeaf(rightPred);
+// 通用 finder 路径：区间拷入临时缓冲后调用 ISplitFinder
+bool LeafwiseTreeBuilder::findBestSplitWithFinder(const std::vector<double>& data,
+                                                  int rowLength,
+                                                  const std::vector<double>& targets,
+                                                  LeafInfo& leaf) {
+    tempIndices_.assign(order_.begin() + leaf.begin, order_.begin() + leaf.end);
+
+    // GOSS 放大权重需进入节点指标与直方图统计，否则小梯度样本被低估
+    double currentMetric = weighted_
+        ? criterion_->nodeMetricWeighted(targets, rowWeights_, tempIndices_)
+        : criterion_->nodeMetric(targets, tempIndices_);
+    auto [f, thresh, gain] = weighted_
+        ? finder_->findBestSplitWeighted(data, rowLength, targets, rowWeights_, tempIndices_, currentMetric, *criterion_)
+        : finder_->findBestSplit(data, rowLength, targets, tempIndices_, currentMetric, *criterion_);
+    leaf.bestFeature = f;
+    leaf.bestThreshold = thresh;
+    leaf.bestBin = -1;
+    leaf.splitGain = gain;
+    return f >= 0 && gain > 0;
+}
+
+bool LeafwiseTreeBuilder::evaluateLeaf(const std::vector<double>& data,
+                                       int rowLength,
+                                       const std::vector<double>& targets,
+                                       LeafInfo& leaf) {
+    leaf.bestFeature = -1;
+    leaf.bestBin = -1;
+    leaf.splitGain = 0.0;
+    if (leaf.count < config_.minDataInLeaf * 2) return false;
+
+    if (histogramBins_ > 0) {
+        // 池未命中时重建（各进程的池状态一致，数据并行时同时未命中）
+        GradientHistBin* hist = histPool_.get(leaf.leafId);
+        if (!hist) {
+            hist = histPool_.acquire(leaf.leafId);
+            buildLeafHistogram(leaf, targets, hist);
+            reduceHistogram(hist);
         }
-    } else {
-        double rightPred = computeLeafPredictionParallel(rightIndices_, targets, rightWeights_);
-        leafInfo.node->rightChild->makeLeaf(rightPred);
+        return findBestSplitFromHistogram(hist, leaf);
     }
+    return findBestSplitWithFinder(data, rowLength, targets, leaf);
 }
 
-double LeafwiseTreeBuilder::computeLeafPredictionSerial(
-    const std::vector<int>& indices,
-    const std::vector<double>& targets,
-    const std::vector<double>& weights) const {
-    if (indices.empty()) return 0.0;
+void LeafwiseTreeBuilder::computeLeafSums(LeafInfo& leaf,
+                                          const std::vector<double>& targets) {
     double sum = 0.0, wsum = 0.0;
-    for (size_t i = 0; i < indices.size(); ++i) {
-        sum += targets[indices[i]] * weights[i];
-        wsum += weights[i];
+    const int* rows = order_.data();
+    #pragma omp parallel for reduction(+:sum, wsum) schedule(static) if(leaf.size() >= 2000)
+    for (int i = leaf.begin; i < leaf.end; ++i) {
+        const int idx = rows[i];
+        const double w = rowWeights_[idx];
+        sum += targets[idx] * w;
+        wsum += w;
     }
-    return (wsum > 0.0) ? (sum / wsum) : 0.0;
+    double totals[3] = {sum, wsum, static_cast<double>(leaf.size())};
+    if (reducer_) reducer_->sum(totals, 3);
+    leaf.sumGradients = totals[0];
+    leaf.sumWeights = totals[1];
+    leaf.count = static_cast<long long>(totals[2]);
 }
 
-double LeafwiseTreeBuilder::computeLeafPredictionParallel(
-    const std::vector<int>& indices,
-    const std::vector<double>& targets,
-    const std::vector<double>& weights) const {
-    if (indices.empty()) return 0.0;
-    double sum = 0.0, wsum = 0.0;
-    size_t m = indices.size();
-    if (m >= 1000) {
-        #pragma omp parallel for reduction(+:sum, wsum) schedule(static)
-        for (size_t i = 0; i < m; ++i) {
-            sum += targets[indices[i]] * weights[i];
-            wsum += weights[i];
+// 稳定划分：左孩子保持在区间前部，线程按静态分块计数后前缀和定位写入
+int LeafwiseTreeBuilder::partitionLeaf(const LeafInfo& leaf,
+                                       const std::vector<double>& data,
+                                       int rowLength) {
+    const int begin = leaf.begin;
+    const int m = leaf.size();
+    const int feat = leaf.bestFeature;
+    const int bestBin = leaf.bestBin;
+    const double threshold = leaf.bestThreshold;
+    const uint16_t* col = (bestBin >= 0)
+        ? binBase_ + static_cast<size_t>(feat) * numRows_ : nullptr;
+
+    auto goesLeft = [&](int idx) {
+        return col ? (col[idx] <= bestBin)
+                   : (data[static_cast<size_t>(idx) * rowLength + feat] <= threshold);
+    };
+
+    if (partitionBuffer_.size() < static_cast<size_t>(m)) partitionBuffer_.resize(m);
+    int* rows = order_.data();
+    int* buffer = partitionBuffer_.data();
+
+#ifdef _OPENMP
+    const int maxThreads = (m >= 2000) ? omp_get_max_threads() : 1;
+#else
+    const int maxThreads = 1;
+#endif
+    threadLeftCounts_.assign(static_cast<size_t>(maxThreads) + 1, 0);
+    size_t totalLeft = 0;
+
+    #pragma omp parallel num_threads(maxThreads) if(maxThreads > 1)
+    {
+#ifdef _OPENMP
+        const int tid = omp_get_thread_num();
+        const int nt = omp_get_num_threads();
+#else
+        const int tid = 0;
+        const int nt = 1;
+#endif
+        const int lo = begin + static_cast<int>(static_cast<long long>(m) * tid / nt);
+        const int hi = begin + static_cast<int>(static_cast<long long>(m) * (tid + 1) / nt);
+
+        size_t leftCount = 0;
+        for (int i = lo; i < hi; ++i) leftCount += goesLeft(rows[i]) ? 1 : 0;
+        threadLeftCounts_[tid + 1] = leftCount;
+        #pragma omp barrier
+
+        #pragma omp single
+        {
+            for (int t = 0; t < nt; ++t) threadLeftCounts_[t + 1] += threadLeftCounts_[t];
+            totalLeft = threadLeftCounts_[nt];
         }
-    } else {
-        for (size_t i = 0; i < m; ++i) {
-            sum += targets[indices[i]] * weights[i];
-            wsum += weights[i];
+
+        size_t leftPos = threadLeftCounts_[tid];
+        size_t rightPos = totalLeft + (lo - begin) - threadLeftCounts_[tid];
+        for (int i = lo; i < hi; ++i) {
+            const int idx = rows[i];
+            if (goesLeft(idx)) buffer[leftPos++] = idx;
+            else buffer[rightPos++] = idx;
         }
     }
-    return (wsum > 0.0) ? (sum / wsum) : 0.0;
-}
 
-// 串行处理剩余叶子
-void LeafwiseTreeBuilder::processRemainingLeavesSerial(
-    const std::vector<double>& targets,
-    const std::vector<double>& sampleWeights) {
-    while (!leafQueue_.empty()) {
-        LeafInfo leaf = leafQueue_.top();
-        leafQueue_.pop();
-        double leafPred = computeLeafPredictionSerial(leaf.sampleIndices, targets, sampleWeights);
-        leaf.node->makeLeaf(leafPred);
-    }
+    std::copy(buffer, buffer + m, rows + begin);
+    return begin + static_cast<int>(totalLeft);
 }
 
-// 并行处理剩余叶子：用并行 for
-void LeafwiseTreeBuilder::processRemainingLeavesParallel(
-    const std::vector<double>& targets,
-    const std::vector<double>& sampleWeights) {
-    // 收集所有剩余叶子到临时数组
-    std::vector<LeafInfo> rem;
-    rem.reserve(leafQueue_.size());
-    while (!leafQueue_.empty()) {
-        rem.push_back(leafQueue_.top());
-        leafQueue_.pop();
+void LeafwiseTreeBuilder::splitLeaf(LeafInfo& leaf,
+                                    const std::vector<double>& data,
+                                    int rowLength,
+                                    const std::vector<double>& targets) {
+    leaf.node->makeInternal(leaf.bestFeature, leaf.bestThreshold);
+    leaf.node->leftChild = std::make_unique<Node>();
+    leaf.node->rightChild = std::make_unique<Node>();
+
+    const int mid = partitionLeaf(leaf, data, rowLength);
+
+    LeafInfo left{};
+    left.node = leaf.node->leftChild.get();
+    left.begin = leaf.begin;
+    left.end = mid;
+    left.leafId = nextLeafId_++;
+
+    LeafInfo right{};
+    right.node = leaf.node->rightChild.get();
+    right.begin = mid;
+    right.end = leaf.end;
+    right.leafId = nextLeafId_++;
+
+    // 孩子的全局样本数决定是否建直方图及扫描哪个孩子，各进程必须一致
+    double leftCount = left.size();
+    if (reducer_) reducer_->sum(&leftCount, 1);
+    left.count = static_cast<long long>(leftCount);
+    right.count = leaf.count - left.count;
+    left.node->samples = static_cast<int>(left.count);
+    right.node->samples = static_cast<int>(right.count);
+
+    const int minSplit = config_.minDataInLeaf * 2;
+    const bool needHistograms = histogramBins_ > 0 &&
+                                (left.count >= minSplit || right.count >= minSplit);
+
+    if (needHistograms) {
+        // **直方图减法**：只扫描较小的孩子，较大的孩子 = 父直方图 - 小孩子
+        LeafInfo& small = (left.count <= right.count) ? left : right;
+        LeafInfo& large = (left.count <= right.count) ? right : left;
+
+        GradientHistBin* parentHist = histPool_.get(leaf.leafId);
+        GradientHistBin* smallHist = histPool_.acquire(small.leafId);
+        buildLeafHistogram(small, targets, smallHist);
+        reduceHistogram(smallHist);
+
+        // 任一特征的桶合计即区间总量
+        small.sumGradients = 0.0;
+        small.sumWeights = 0.0;
+        for (int b = 0; b < featureBins_[0]; ++b) {
+            small.sumGradients += smallHist[b].sumGradients;
+            small.sumWeights += smallHist[b].sumWeights;
+        }
+        large.sumGradients = leaf.sumGradients - small.sumGradients;
+        large.sumWeights = leaf.sumWeights - small.sumWeights;
+
+        if (parentHist) {
+            const size_t total = histPool_.binsPerHistogram();
+            #pragma omp parallel for schedule(static) if(total >= 16384)
+            for (size_t i = 0; i < total; ++i) {
+                parentHist[i].sumGradients -= smallHist[i].sumGradients;
+                parentHist[i].sumWeights -= smallHist[i].sumWeights;
+                parentHist[i].count -= smallHist[i].count;
+            }
+            histPool_.rename(leaf.leafId, large.leafId);
+        } else {
+            GradientHistBin* largeHist = histPool_.acquire(large.leafId);
+            buildLeafHistogram(large, targets, largeHist);
+            reduceHistogram(largeHist);
+        }
+    } else {
+        histPool_.release(leaf.leafId);
+        computeLeafSums(left, targets);
+        right.sumGradients = leaf.sumGradients - left.sumGradients;
+        right.sumWeights = leaf.sumWeights - left.sumWeights;
     }
-    size_t m = rem.size();
-    #pragma omp parallel for schedule(dynamic)
-    for (size_t i = 0; i < m; ++i) {
-        double leafPred = computeLeafPredictionParallel(rem[i].sampleIndices, targets, sampleWeights);
-        rem[i].node->makeLeaf(leafPred);
+
+    for (LeafInfo* child : {&left, &right}) {
+        if (evaluateLeaf(data, rowLength, targets, *child)) {
+            leafQueue_.push(*child);
+        } else {
+            finalizeLeaf(*child);
+        }
     }
 }
+
+void LeafwiseTreeBuilder::finalizeLeaf(const LeafInfo& leaf) {
+    const double pred = (leaf.sumWeights > 0.0) ? (leaf.sumGradients / leaf.sumWeights) : 0.0;
+    leaf.node->makeLeaf(pred);
+    histPool_.release(leaf.leafId);
+}
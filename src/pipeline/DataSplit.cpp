@@ -1,4 +1,7 @@
 #include "pipeline/DataSplit.hpp"
+#include "functions/random/Philox.hpp"
+#include <algorithm>
+#include <numeric>
 
 bool splitDataset(const std::vector<double>& X,
                   const std::vector<double>& y,
@@ -16,3 +19,137 @@ bool splitDataset(const std::vector<double>& X,
     out.y_test.assign(y.begin() + trainRows, y.end());
     return true;
 }
+
+namespace {
+
+// 训练 / 验证行数，保证三段不越界
+std::pair<size_t, size_t> partitionSizes(size_t n, double trainRatio, double valRatio) {
+    const size_t trainRows = std::min(n, static_cast<size_t>(n * std::clamp(trainRatio, 0.0, 1.0)));
+    const size_t valRows = std::min(n - trainRows, static_cast<size_t>(n * std::max(valRatio, 0.0)));
+    return {trainRows, valRows};
+}
+
+std::shared_ptr<const std::vector<int>> shuffledRows(size_t n, uint32_t seed) {
+    auto rows = std::make_shared<std::vector<int>>(n);
+    std::iota(rows->begin(), rows->end(), 0);
+    // 计数器型随机流：打乱结果不依赖标准库的 shuffle 实现
+    Philox rng(seed, {Philox::Shuffle});
+    rng.shuffle(rows->begin(), rows->end());
+    return rows;
+}
+
+} // namespace
+
+namespace {
+
+// X 为 std::vector 或 ConstSpan，视图按 X 的存放方式构造
+template <typename T, typename Features>
+BasicDataViews<T> contiguousSplit(const Features& X,
+                                  const std::vector<double>& y,
+                                  int rowLength,
+                                  double trainRatio,
+                                  double valRatio) {
+    const int feat = rowLength - 1;
+    const size_t n = y.size();
+    const auto [trainRows, valRows] = partitionSizes(n, trainRatio, valRatio);
+
+    BasicDataViews<T> out;
+    out.rowLength = feat;
+    out.train = BasicDatasetView<T>::range(X, y, feat, 0, trainRows);
+    out.validation = BasicDatasetView<T>::range(X, y, feat, trainRows, trainRows + valRows);
+    out.test = BasicDatasetView<T>::range(X, y, feat, trainRows + valRows, n);
+    return out;
+}
+
+} // namespace
+
+template <typename T>
+BasicDataViews<T> splitViews(const std::vector<T>& X,
+                             const std::vector<double>& y,
+                             int rowLength,
+                             double trainRatio,
+                             double valRatio) {
+    return contiguousSplit<T>(X, y, rowLength, trainRatio, valRatio);
+}
+
+DataViews splitViews(ConstSpan<double> X,
+                     const std::vector<double>& y,
+                     int rowLength,
+                     double trainRatio,
+                     double valRatio) {
+    return contiguousSplit<double>(X, y, rowLength, trainRatio, valRatio);
+}
+
+template <typename T>
+BasicDataViews<T> shuffledSplitViews(const std::vector<T>& X,
+                                     const std::vector<double>& y,
+                                     int rowLength,
+                                     double trainRatio,
+                                     double valRatio,
+                                     uint32_t seed) {
+    const int feat = rowLength - 1;
+    const size_t n = y.size();
+    const auto [trainRows, valRows] = partitionSizes(n, trainRatio, valRatio);
+
+    // 三个视图共享同一行号排列，各取其中一段
+    const auto all = BasicDatasetView<T>::indexed(X, y, feat, shuffledRows(n, seed));
+    BasicDataViews<T> out;
+    out.rowLength = feat;
+    out.train = all.slice(0, trainRows);
+    out.validation = all.slice(trainRows, trainRows + valRows);
+    out.test = all.slice(trainRows + valRows, n);
+    return out;
+}
+
+template <typename T>
+std::vector<std::pair<BasicDatasetView<T>, BasicDatasetView<T>>>
+kFoldViews(const std::vector<T>& X,
+           const std::vector<double>& y,
+           int rowLength,
+           int k,
+           bool shuffle,
+           uint32_t seed) {
+    const int feat = rowLength - 1;
+    const size_t n = y.size();
+    std::vector<std::pair<BasicDatasetView<T>, BasicDatasetView<T>>> folds;
+    if (k < 2 || n < static_cast<size_t>(k)) return folds;
+
+    std::shared_ptr<const std::vector<int>> order;
+    if (shuffle) {
+        order = shuffledRows(n, seed);
+    } else {
+        auto rows = std::make_shared<std::vector<int>>(n);
+        std::iota(rows->begin(), rows->end(), 0);
+        order = std::move(rows);
+    }
+
+    // 验证折是排列中的连续一段；训练折需要跳过该段，单独保存其行号
+    folds.reserve(k);
+    for (int fold = 0; fold < k; ++fold) {
+        const size_t lo = n * fold / k;
+        const size_t hi = n * (fold + 1) / k;
+        auto trainRows = std::make_shared<std::vector<int>>();
+        trainRows->reserve(n - (hi - lo));
+        trainRows->insert(trainRows->end(), order->begin(), order->begin() + lo);
+        trainRows->insert(trainRows->end(), order->begin() + hi, order->end());
+
+        const auto all = BasicDatasetView<T>::indexed(X, y, feat, order);
+        folds.emplace_back(BasicDatasetView<T>::indexed(X, y, feat, std::move(trainRows)),
+                           all.slice(lo, hi));
+    }
+    return folds;
+}
+
+// 显式实例化：double 与 float 特征
+template DataViews splitViews(const std::vector<double>&, const std::vector<double>&,
+                              int, double, double);
+template DataViewsF32 splitViews(const std::vector<float>&, const std::vector<double>&,
+                                 int, double, double);
+template DataViews shuffledSplitViews(const std::vector<double>&, const std::vector<double>&,
+                                      int, double, double, uint32_t);
+template DataViewsF32 shuffledSplitViews(const std::vector<float>&, const std::vector<double>&,
+                                         int, double, double, uint32_t);
+template std::vector<std::pair<DatasetView, DatasetView>>
+kFoldViews(const std::vector<double>&, const std::vector<double>&, int, int, bool, uint32_t);
+template std::vector<std::pair<DatasetViewF32, DatasetViewF32>>
+kFoldViews(const std::vector<float>&, const std::vector<double>&, int, int, bool, uint32_t);
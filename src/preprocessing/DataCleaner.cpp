@@ -1,157 +1,384 @@
+// =============================================================================
+// src/preprocessing/DataCleaner.cpp - 列存并行数据清洗
+// =============================================================================
 #include "preprocessing/DataCleaner.hpp"
-#include <fstream>
-#include <sstream>
+#include "functions/io/DataIO.hpp"
 #include <algorithm>
-#include <numeric>
+#include <charconv>
 #include <cmath>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace preprocessing {
 
-void DataCleaner::readCSV(const std::string& filePath,
-                          std::vector<std::string>& headers,
-                          std::vector<std::vector<double>>& data) {
+namespace {
+
+constexpr double kStdEps = 1e-12;
+
+// 首行表头（按逗号切分，去掉行尾 '\r'）
+std::vector<std::string> readHeader(const std::string& filePath) {
     std::ifstream in(filePath);
     if (!in.is_open()) {
         throw std::runtime_error("无法打开文件: " + filePath);
     }
+    std::vector<std::string> headers;
     std::string line;
-    // 读取表头
-    if (!std::getline(in, line)) return;
-    headers.clear();
-    std::stringstream ssHead(line);
-    std::string col;
-    while (std::getline(ssHead, col, ',')) {
-        headers.push_back(col);
-    }
-    // 读取数据行
-    data.clear();
-    while (std::getline(in, line)) {
-        std::stringstream ss(line);
-        std::string cell;
-        std::vector<double> row;
-        while (std::getline(ss, cell, ',')) {
-            row.push_back(std::stod(cell));
+    if (!std::getline(in, line)) return headers;
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    size_t start = 0;
+    while (start <= line.size()) {
+        const size_t comma = line.find(',', start);
+        if (comma == std::string::npos) {
+            if (start < line.size()) headers.push_back(line.substr(start));
+            break;
         }
-        if (!row.empty()) data.push_back(std::move(row));
+        headers.push_back(line.substr(start, comma - start));
+        start = comma + 1;
     }
-    in.close();
+    return headers;
 }
 
-void DataCleaner::writeCSV(const std::string& filePath,
-                           const std::vector<std::string>& headers,
-                           const std::vector<std::vector<double>>& data) {
-    std::ofstream out(filePath);
-    if (!out.is_open()) {
-        throw std::runtime_error("无法写入文件: " + filePath);
-    }
-    // 写入表头
+void writeHeader(std::ofstream& out, const std::vector<std::string>& headers) {
     for (size_t i = 0; i < headers.size(); ++i) {
         out << headers[i] << (i + 1 < headers.size() ? ',' : '\n');
     }
-    // 写入数据行
-    for (const auto& row : data) {
-        for (size_t j = 0; j < row.size(); ++j) {
-            out << row[j] << (j + 1 < row.size() ? ',' : '\n');
+}
+
+// 与 ostream 默认格式（%g，6 位有效数字）一致，清洗结果与旧实现逐字节相同
+inline void appendValue(std::string& buf, double v) {
+    char tmp[32];
+    const auto res = std::to_chars(tmp, tmp + sizeof(tmp), v, std::chars_format::general, 6);
+    buf.append(tmp, res.ptr);
+}
+
+/**
+ * 并行格式化 [0, rows) 中 keep(i) 为真的行：按行块分给线程写入各自的缓冲，
+ * 再按块顺序整体写出，输出顺序与行顺序一致
+ */
+template <typename Value, typename Keep>
+void writeRows(std::ofstream& out, size_t rows, size_t columns, Value&& value, Keep&& keep) {
+    constexpr size_t kChunkRows = 8192;
+#ifdef _OPENMP
+    const size_t chunksPerRound = static_cast<size_t>(omp_get_max_threads()) * 4;
+#else
+    const size_t chunksPerRound = 1;
+#endif
+    const size_t numChunks = (rows + kChunkRows - 1) / kChunkRows;
+    std::vector<std::string> buffers(std::min(numChunks, chunksPerRound));
+
+    for (size_t first = 0; first < numChunks; first += chunksPerRound) {
+        const size_t last = std::min(numChunks, first + chunksPerRound);
+
+        #pragma omp parallel for schedule(dynamic) if(last - first > 1)
+        for (size_t k = first; k < last; ++k) {
+            std::string& buf = buffers[k - first];
+            buf.clear();
+            const size_t lo = k * kChunkRows;
+            const size_t hi = std::min(rows, lo + kChunkRows);
+            for (size_t i = lo; i < hi; ++i) {
+                if (!keep(i)) continue;
+                for (size_t c = 0; c < columns; ++c) {
+                    appendValue(buf, value(i, c));
+                    buf.push_back(c + 1 < columns ? ',' : '\n');
+                }
+            }
+        }
+        for (size_t k = first; k < last; ++k) {
+            out.write(buffers[k - first].data(), static_cast<std::streamsize>(buffers[k - first].size()));
         }
     }
-    out.close();
 }
 
-std::vector<std::vector<double>> DataCleaner::removeOutliers(
-    const std::vector<std::vector<double>>& data,
-    size_t colIndex,
-    double zThreshold) {
-    // 计算均值与标准差
-    std::vector<double> colVals;
-    colVals.reserve(data.size());
-    for (const auto& row : data) {
-        if (colIndex < row.size())
-            colVals.push_back(row[colIndex]);
-    }
-    double mean = std::accumulate(colVals.begin(), colVals.end(), 0.0) / colVals.size();
+// 均值与总体标准差（两遍：先均值，再离差平方和）
+std::pair<double, double> meanStd(const double* v, size_t n) {
+    if (n == 0) return {0.0, 0.0};
+    double sum = 0.0;
+    #pragma omp parallel for reduction(+:sum) schedule(static) if(n > 10000)
+    for (size_t i = 0; i < n; ++i) sum += v[i];
+    const double mean = sum / n;
+
     double var = 0.0;
-    for (double v : colVals) var += (v - mean) * (v - mean);
-    var /= colVals.size();
-    double stddev = std::sqrt(var);
-
-    std::vector<std::vector<double>> cleaned;
-    for (const auto& row : data) {
-        double v = row[colIndex];
-        double z = std::abs((v - mean) / (stddev + 1e-12));
-        if (z <= zThreshold) {
-            cleaned.push_back(row);
+    #pragma omp parallel for reduction(+:var) schedule(static) if(n > 10000)
+    for (size_t i = 0; i < n; ++i) var += (v[i] - mean) * (v[i] - mean);
+    return {mean, std::sqrt(var / n)};
+}
+
+// CSVReader 批次中第 c 列的取值（最后一列为标签）
+inline double batchValue(const std::vector<double>& X, const std::vector<double>& y,
+                         size_t d, size_t i, size_t c) {
+    return c < d ? X[i * d + c] : y[i];
+}
+
+} // namespace
+
+RowSelection::RowSelection(size_t rows)
+    : rows_(rows), words_((rows + 63) / 64, ~uint64_t(0)) {
+    // 末字超出行数的位清零，count() 直接做 popcount
+    if (rows % 64 != 0) words_.back() = (uint64_t(1) << (rows % 64)) - 1;
+}
+
+size_t RowSelection::count() const {
+    size_t total = 0;
+    #pragma omp parallel for reduction(+:total) schedule(static) if(words_.size() > 4096)
+    for (size_t w = 0; w < words_.size(); ++w) {
+        total += static_cast<size_t>(__builtin_popcountll(words_[w]));
+    }
+    return total;
+}
+
+ColumnTable DataCleaner::readCSV(const std::string& filePath, size_t batchRows) {
+    ColumnTable table;
+    table.headers = readHeader(filePath);
+
+    // 先只数行（映射扫描换行）以便一次分配列存缓冲
+    DataIO io;
+    const size_t expectedRows = io.getFileStats(filePath).totalRows;
+
+    DataIO::CSVReader reader(filePath);
+    const size_t d = static_cast<size_t>(reader.numFeatures());
+    if (expectedRows == 0 || !reader.hasNext()) return table;
+
+    table.columns = d + 1;
+    table.rows = expectedRows;
+    table.values.resize(table.columns * expectedRows);
+
+    std::vector<double> X, y;
+    size_t rowStart = 0;
+    batchRows = std::max<size_t>(batchRows, 1);
+    while (size_t rows = reader.readBatch(X, y, batchRows)) {
+        if (rowStart + rows > expectedRows) {
+            throw std::runtime_error("读取期间文件发生变化: " + filePath);
+        }
+        // 批内转置：每列写入各自的连续区段
+        #pragma omp parallel for schedule(static) if(table.columns > 1 && rows > 2000)
+        for (size_t c = 0; c < table.columns; ++c) {
+            double* dst = table.column(c) + rowStart;
+            for (size_t i = 0; i < rows; ++i) dst[i] = batchValue(X, y, d, i, c);
+        }
+        rowStart += rows;
+    }
+
+    // 实际行数少于计数时把各列前移为紧凑布局（目标位置不超过源位置，顺序拷贝安全）
+    if (rowStart < expectedRows) {
+        for (size_t c = 1; c < table.columns; ++c) {
+            std::copy(table.values.begin() + c * expectedRows,
+                      table.values.begin() + c * expectedRows + rowStart,
+                      table.values.begin() + c * rowStart);
         }
+        table.rows = rowStart;
+        table.values.resize(table.columns * rowStart);
     }
-    return cleaned;
+    return table;
 }
 
-std::vector<int> DataCleaner::equalFrequencyBinning(
-    const std::vector<double>& values,
-    int numBins) {
-    int n = static_cast<int>(values.size());
-    std::vector<std::pair<double,int>> sorted;
-    sorted.reserve(n);
-    for (int i = 0; i < n; ++i) sorted.emplace_back(values[i], i);
-    std::sort(sorted.begin(), sorted.end(), [](auto &a, auto &b){ return a.first < b.first; });
-
-    std::vector<int> bins(n);
-    int baseSize = n / numBins;
-    int rem = n % numBins;
-    int idx = 0;
-    for (int b = 0; b < numBins; ++b) {
-        int thisSize = baseSize + (b < rem ? 1 : 0);
-        for (int k = 0; k < thisSize; ++k) {
-            bins[sorted[idx].second] = b;
-            ++idx;
+void DataCleaner::writeCSV(const std::string& filePath,
+                           const ColumnTable& table,
+                           const RowSelection* selection) {
+    std::ofstream out(filePath, std::ios::binary);
+    if (!out.is_open()) {
+        throw std::runtime_error("无法写入文件: " + filePath);
+    }
+    writeHeader(out, table.headers);
+    writeRows(out, table.rows, table.columns,
+              [&](size_t i, size_t c) { return table.column(c)[i]; },
+              [&](size_t i) { return !selection || selection->test(i); });
+    out.close();
+    if (!out) {
+        throw std::runtime_error("写入失败: " + filePath);
+    }
+}
+
+void DataCleaner::removeOutliers(const ColumnTable& table,
+                                 size_t colIndex,
+                                 double zThreshold,
+                                 RowSelection& keep) {
+    if (colIndex >= table.columns || table.rows == 0) return;
+    const double* v = table.column(colIndex);
+    const auto [mean, stddev] = meanStd(v, table.rows);
+
+    // 每个线程处理整字（64 行），位图写入无竞争
+    const size_t rows = table.rows;
+    #pragma omp parallel for schedule(static) if(keep.numWords() > 256)
+    for (size_t w = 0; w < keep.numWords(); ++w) {
+        uint64_t& bits = keep.word(w);
+        const size_t hi = std::min(rows, (w + 1) * 64);
+        for (size_t i = w * 64; i < hi; ++i) {
+            const double z = std::abs((v[i] - mean) / (stddev + kStdEps));
+            if (z > zThreshold) bits &= ~(uint64_t(1) << (i & 63));
         }
     }
+}
+
+std::vector<int> DataCleaner::equalFrequencyBinning(const double* values, size_t n, int numBins) {
+    std::vector<int> bins(n, 0);
+    if (n == 0 || numBins <= 0) return bins;
+
+    std::vector<std::pair<double, int>> sorted(n);
+    for (size_t i = 0; i < n; ++i) sorted[i] = {values[i], static_cast<int>(i)};
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    const size_t baseSize = n / numBins;
+    const size_t rem = n % numBins;
+    size_t idx = 0;
+    for (int b = 0; b < numBins; ++b) {
+        const size_t thisSize = baseSize + (static_cast<size_t>(b) < rem ? 1 : 0);
+        for (size_t k = 0; k < thisSize; ++k) bins[sorted[idx++].second] = b;
+    }
     return bins;
 }
 
-std::vector<std::vector<double>> DataCleaner::removeOutliersByBinning(
-    const std::vector<std::vector<double>>& data,
-    size_t colX,
-    size_t colY,
-    int numBins,
-    double zThreshold) {
-    // 提取两个维度
-    std::vector<double> valsX, valsY;
-    valsX.reserve(data.size());
-    valsY.reserve(data.size());
-    for (auto &row : data) {
-        valsX.push_back(row[colX]);
-        valsY.push_back(row[colY]);
-    }
-    auto binsX = equalFrequencyBinning(valsX, numBins);
-    auto binsY = equalFrequencyBinning(valsY, numBins);
-
-    std::vector<std::vector<double>> result;
-    // 对每个 bin 分别计算并去除异常
+std::vector<int> DataCleaner::equalFrequencyBinning(const std::vector<double>& values, int numBins) {
+    return equalFrequencyBinning(values.data(), values.size(), numBins);
+}
+
+void DataCleaner::removeOutliersByBinning(const ColumnTable& table,
+                                          size_t colX,
+                                          size_t colY,
+                                          int numBins,
+                                          double zThreshold,
+                                          RowSelection& keep) {
+    if (colX >= table.columns || colY >= table.columns || table.rows == 0 || numBins <= 0) return;
+    const size_t n = table.rows;
+    const double* perf = table.column(table.columns - 1);
+
+    // 两个维度的排序分箱相互独立，并行进行
+    std::vector<int> binsX, binsY;
+    #pragma omp parallel sections if(n > 10000)
+    {
+        #pragma omp section
+        binsX = equalFrequencyBinning(table.column(colX), n, numBins);
+        #pragma omp section
+        binsY = equalFrequencyBinning(table.column(colY), n, numBins);
+    }
+
+    // 箱内均值与标准差：各线程局部累加后合并（X、Y 同箱的行只计一次）
+    std::vector<double> sum(numBins, 0.0), sq(numBins, 0.0);
+    std::vector<size_t> count(numBins, 0);
+    #pragma omp parallel if(n > 10000)
+    {
+        std::vector<double> localSum(numBins, 0.0);
+        std::vector<size_t> localCount(numBins, 0);
+        #pragma omp for schedule(static) nowait
+        for (size_t i = 0; i < n; ++i) {
+            localSum[binsX[i]] += perf[i];
+            ++localCount[binsX[i]];
+            if (binsY[i] != binsX[i]) {
+                localSum[binsY[i]] += perf[i];
+                ++localCount[binsY[i]];
+            }
+        }
+        #pragma omp critical
+        for (int b = 0; b < numBins; ++b) {
+            sum[b] += localSum[b];
+            count[b] += localCount[b];
+        }
+    }
+    std::vector<double> mean(numBins, 0.0);
     for (int b = 0; b < numBins; ++b) {
-        // 收集 bin 内索引
-        std::vector<int> idxs;
-        std::vector<double> perf;
-        for (size_t i = 0; i < data.size(); ++i) {
-            if (binsX[i] == b || binsY[i] == b) {
-                idxs.push_back(i);
-                perf.push_back(data[i].back());
+        if (count[b] > 0) mean[b] = sum[b] / count[b];
+    }
+
+    #pragma omp parallel if(n > 10000)
+    {
+        std::vector<double> localSq(numBins, 0.0);
+        #pragma omp for schedule(static) nowait
+        for (size_t i = 0; i < n; ++i) {
+            const double dx = perf[i] - mean[binsX[i]];
+            localSq[binsX[i]] += dx * dx;
+            if (binsY[i] != binsX[i]) {
+                const double dy = perf[i] - mean[binsY[i]];
+                localSq[binsY[i]] += dy * dy;
             }
         }
-        if (idxs.empty()) continue;
-        double mean = std::accumulate(perf.begin(), perf.end(), 0.0) / perf.size();
-        double var = 0.0;
-        for (double v : perf) var += (v - mean) * (v - mean);
-        var /= perf.size();
-        double stddev = std::sqrt(var);
-        // 保留正常
-        for (auto i : idxs) {
-            double z = std::abs((perf[i - idxs.front()] - mean) / (stddev + 1e-12));
-            if (z <= zThreshold) {
-                result.push_back(data[i]);
+        #pragma omp critical
+        for (int b = 0; b < numBins; ++b) sq[b] += localSq[b];
+    }
+    std::vector<double> stddev(numBins, 0.0);
+    for (int b = 0; b < numBins; ++b) {
+        if (count[b] > 0) stddev[b] = std::sqrt(sq[b] / count[b]);
+    }
+
+    auto outlier = [&](size_t i, int b) {
+        return std::abs((perf[i] - mean[b]) / (stddev[b] + kStdEps)) > zThreshold;
+    };
+    #pragma omp parallel for schedule(static) if(keep.numWords() > 256)
+    for (size_t w = 0; w < keep.numWords(); ++w) {
+        uint64_t& bits = keep.word(w);
+        const size_t hi = std::min(n, (w + 1) * 64);
+        for (size_t i = w * 64; i < hi; ++i) {
+            if (outlier(i, binsX[i]) || outlier(i, binsY[i])) bits &= ~(uint64_t(1) << (i & 63));
+        }
+    }
+}
+
+DataCleaner::CleanStats DataCleaner::cleanStreaming(const std::string& inPath,
+                                                    const std::string& outPath,
+                                                    size_t colIndex,
+                                                    double zThreshold,
+                                                    size_t batchRows) {
+    CleanStats stats;
+    const std::vector<std::string> headers = readHeader(inPath);
+    DataIO::CSVReader reader(inPath);
+    const size_t d = static_cast<size_t>(std::max(reader.numFeatures(), 0));
+    if (colIndex == kLastColumn) colIndex = d;
+    if (colIndex > d) {
+        throw std::runtime_error("列索引超出范围: " + std::to_string(colIndex));
+    }
+    batchRows = std::max<size_t>(batchRows, 1);
+
+    // **统计预扫描**：逐批求均值与离差平方和，再按 Chan 公式合并
+    std::vector<double> X, y;
+    double mean = 0.0, m2 = 0.0;
+    size_t n = 0;
+    std::vector<double> col;
+    while (size_t rows = reader.readBatch(X, y, batchRows)) {
+        col.resize(rows);
+        for (size_t i = 0; i < rows; ++i) col[i] = batchValue(X, y, d, i, colIndex);
+        const auto [batchMean, batchStd] = meanStd(col.data(), rows);
+        const double batchM2 = batchStd * batchStd * rows;
+        const size_t total = n + rows;
+        const double delta = batchMean - mean;
+        mean += delta * rows / total;
+        m2 += batchM2 + delta * delta * (static_cast<double>(n) * rows / total);
+        n = total;
+    }
+    const double stddev = n > 0 ? std::sqrt(m2 / n) : 0.0;
+
+    std::ofstream out(outPath, std::ios::binary);
+    if (!out.is_open()) {
+        throw std::runtime_error("无法写入文件: " + outPath);
+    }
+    writeHeader(out, headers);
+
+    // **过滤并写出**：位图只覆盖当前批次
+    reader.reset();
+    while (size_t rows = reader.readBatch(X, y, batchRows)) {
+        RowSelection keep(rows);
+        #pragma omp parallel for schedule(static) if(keep.numWords() > 256)
+        for (size_t w = 0; w < keep.numWords(); ++w) {
+            uint64_t& bits = keep.word(w);
+            const size_t hi = std::min(rows, (w + 1) * 64);
+            for (size_t i = w * 64; i < hi; ++i) {
+                const double z = std::abs((batchValue(X, y, d, i, colIndex) - mean) / (stddev + kStdEps));
+                if (z > zThreshold) bits &= ~(uint64_t(1) << (i & 63));
             }
         }
+        writeRows(out, rows, d + 1,
+                  [&](size_t i, size_t c) { return batchValue(X, y, d, i, c); },
+                  [&](size_t i) { return keep.test(i); });
+        stats.rows += rows;
+        stats.kept += keep.count();
+    }
+    out.close();
+    if (!out) {
+        throw std::runtime_error("写入失败: " + outPath);
     }
-    return result;
+    return stats;
 }
 
 } // namespace preprocessing
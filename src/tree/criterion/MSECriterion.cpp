@@ -1,5 +1,6 @@
 // src/tree/criterion/MSECriterion.cpp - OpenMP并行版本
 #include "criterion/MSECriterion.hpp"
+#include <algorithm>
 #include <numeric>
 #include <cmath>
 #ifdef _OPENMP
@@ -29,4 +30,31 @@ double MSECriterion::nodeMetric(const std::vector<double>& labels,
     
     // 处理数值精度问题，确保非负
     return std::max(0.0, mse);
-}
\ No newline at end of file
+}
+
+double MSECriterion::nodeMetricWeighted(const std::vector<double>& labels,
+                                        const std::vector<double>& weights,
+                                        const std::vector<int>& indices) const {
+    if (indices.empty()) return 0.0;
+    
+    size_t n = indices.size();
+    
+    // **加权方差：Σw·y²/W - (Σw·y/W)²**
+    double wSum = 0.0;
+    double sum = 0.0;
+    double sumSq = 0.0;
+    
+    #pragma omp parallel for reduction(+:wSum,sum,sumSq) schedule(static) if(n > 1000)
+    for (size_t i = 0; i < n; ++i) {
+        const int idx = indices[i];
+        const double w = weights[idx];
+        const double y = labels[idx];
+        wSum += w;
+        sum += w * y;
+        sumSq += w * y * y;
+    }
+    
+    if (wSum <= 0.0) return 0.0;
+    double mean = sum / wSum;
+    return std::max(0.0, sumSq / wSum - mean * mean);
+}
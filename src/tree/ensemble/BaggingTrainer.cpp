@@ -34,6 +34,7 @@
 #include <unordered_set>
 #include <functional>
 #include <atomic>
+#include <stdexcept>
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -55,13 +56,39 @@ BaggingTrainer::BaggingTrainer(int numTrees,
       splitMethod_(splitMethod),
       prunerType_(prunerType),
       prunerParam_(prunerParam),
-      gen_(seed) {
+      seed_(seed) {
     
     trees_.reserve(numTrees_);
-    oobIndices_.reserve(numTrees_);
 }
 
-std::unique_ptr<ISplitFinder> BaggingTrainer::createSplitFinder() const {
+void BaggingTrainer::setMaxFeatures(const std::string& spec) {
+    resolveMaxFeatures(spec, 1);  // 提前校验格式，非法规格抛出异常
+    maxFeatures_ = spec;
+}
+
+int BaggingTrainer::resolveMaxFeatures(const std::string& spec, int numFeatures) {
+    if (spec.empty() || spec == "all" || spec == "none") return 0;
+
+    double mtry = 0.0;
+    if (spec == "sqrt") {
+        mtry = std::sqrt(static_cast<double>(numFeatures));
+    } else if (spec == "log2") {
+        mtry = std::log2(static_cast<double>(numFeatures));
+    } else {
+        size_t pos = 0;
+        const double value = std::stod(spec, &pos);
+        if (pos != spec.size() || value <= 0.0) {
+            throw std::invalid_argument("Invalid max_features: " + spec);
+        }
+        // 含小数点视为比例，否则为特征个数
+        mtry = spec.find('.') != std::string::npos ? value * numFeatures : value;
+    }
+
+    const int k = std::max(1, static_cast<int>(mtry));
+    return k >= numFeatures ? 0 : k;
+}
+
+std::unique_ptr<ISplitFinder> BaggingTrainer::createSplitFinder(uint64_t treeKey) const {
     const std::string& method = splitMethod_;
     
     if (method == "exhaustive" || method == "exact") {
@@ -73,7 +100,7 @@ std::unique_ptr<ISplitFinder> BaggingTrainer::createSplitFinder() const {
         if (pos != std::string::npos) {
             k = std::stoi(method.substr(pos + 1));
         }
-        return std::make_unique<RandomSplitFinder>(k);
+        return std::make_unique<RandomSplitFinder>(k, treeKey);
     }
     else if (method == "quartile") {
         return std::make_unique<QuartileSplitFinder>();
@@ -152,159 +179,210 @@ std::unique_ptr<IPruner> BaggingTrainer::createPruner(const std::vector<double>&
     }
 }
 
-// **优化1: 高效Bootstrap采样 - 避免vector拷贝**
+// **Bootstrap 采样（多重计数）**：有放回抽样只累加各行被抽中的次数，
+// 再按行号顺序展开为重复行号列表（次数即权重），同一遍得到袋外样本
 void BaggingTrainer::bootstrapSample(int dataSize,
                                      std::vector<int>& sampleIndices,
                                      std::vector<int>& oobIndices,
-                                     std::mt19937& localGen) const {
+                                     Philox& rng) const {
     const int sampleSize = static_cast<int>(dataSize * sampleRatio_);
-    
-    // **预分配精确大小，避免重新分配**
-    sampleIndices.clear();
-    sampleIndices.reserve(sampleSize);
-    
-    // **使用高效的位图跟踪采样状态**
-    std::vector<bool> sampledBits(dataSize, false);
-    
-    // Bootstrap采样（有放回采样）
-    std::uniform_int_distribution<int> dist(0, dataSize - 1);
+
+    thread_local std::vector<uint32_t> counts;
+    counts.assign(dataSize, 0);
+
     for (int i = 0; i < sampleSize; ++i) {
-        const int idx = dist(localGen);
-        sampleIndices.push_back(idx);
-        sampledBits[idx] = true;
+        ++counts[rng.below(static_cast<uint64_t>(dataSize))];
     }
-    
-    // **计算袋外样本**
+
+    sampleIndices.clear();
+    sampleIndices.reserve(sampleSize);
     oobIndices.clear();
-    oobIndices.reserve(dataSize - sampleSize);
     for (int i = 0; i < dataSize; ++i) {
-        if (!sampledBits[i]) {
+        if (counts[i] == 0) {
             oobIndices.push_back(i);
+        } else {
+            sampleIndices.insert(sampleIndices.end(), counts[i], i);
         }
     }
 }
 
-// **优化2: 零拷贝数据传递 - 使用引用和move语义**
-void BaggingTrainer::extractSubsetOptimized(const std::vector<double>& originalData,
-                                           int rowLength,
-                                           const std::vector<double>& originalLabels,
-                                           const std::vector<int>& indices,
-                                           std::vector<double>& subData,
-                                           std::vector<double>& subLabels) const {
-    
-    const int featCount = rowLength;
-    const size_t totalSize = indices.size() * featCount;
-    
-    // **预分配确切大小，避免重新分配**
-    subData.resize(totalSize);
-    subLabels.resize(indices.size());
-    
-    // **优化的批量复制 - 更好的缓存局部性**
-    #pragma omp parallel for schedule(static) if(indices.size() > 500)
-    for (size_t i = 0; i < indices.size(); ++i) {
-        const int idx = indices[i];
-        
-        // **使用内存连续复制优化**
-        const double* srcStart = &originalData[idx * featCount];
-        double* dstStart = &subData[i * featCount];
-        std::copy(srcStart, srcStart + featCount, dstStart);
-        
-        subLabels[i] = originalLabels[idx];
-    }
-}
-
 void BaggingTrainer::train(const std::vector<double>& data,
                           int rowLength,
                           const std::vector<double>& labels) {
+    if (data.size() != labels.size() * static_cast<size_t>(std::max(rowLength, 0))) {
+        std::cerr << "Error: Data size mismatch" << std::endl;
+        return;
+    }
+    trainOnView(DatasetView(data, labels, rowLength));
+}
+
+// **数据视图训练**：全部树作为一批训练
+void BaggingTrainer::trainOnView(const DatasetView& view) {
+    std::vector<int> allTrees(std::max(numTrees_, 0));
+    std::iota(allTrees.begin(), allTrees.end(), 0);
+    bool pending = true;
+    trainOnView(view, [&]() {
+        std::vector<int> batch;
+        if (pending) batch.swap(allTrees);
+        pending = false;
+        return batch;
+    }, numTrees_);
+}
+
+// **动态调度训练**：Bootstrap 位置是视图内序号，经 rowId 映射回共享矩阵的行
+void BaggingTrainer::trainOnView(const DatasetView& view, const TreeBatchSource& nextBatch,
+                                 int expectedTrees) {
     trees_.clear();
-    oobIndices_.clear();
+    treeIds_.clear();
+    forest_.clear();
+    oobContributions_.clear();
+    oobSums_.clear();
+    oobCounts_.clear();
+    oobImportanceSums_.clear();
+    oobImportanceTrees_ = 0;
     
-    const int dataSize = static_cast<int>(labels.size());
+    const int dataSize = static_cast<int>(view.size());
+    const int rowLength = view.numFeatures();
     
     // **数据验证**
-    if (dataSize == 0 || data.empty() || rowLength <= 0) {
+    if (dataSize == 0 || rowLength <= 0) {
         std::cerr << "Error: Invalid training data (empty dataset)" << std::endl;
         return;
     }
     
-    if (static_cast<int>(data.size()) != dataSize * rowLength) {
-        std::cerr << "Error: Data size mismatch" << std::endl;
-        return;
-    }
-    
+    // 进度按本次训练的树计数；预计树数未知（跨进程动态领取）时只报已完成的棵数
+    const std::string treeCount = expectedTrees >= 0
+        ? std::to_string(expectedTrees) + " trees"
+        : "trees from a shared queue of " + std::to_string(numTrees_);
     #ifdef _OPENMP
     const int numThreads = omp_get_max_threads();
-    std::cout << "Training " << numTrees_ << " trees with " << numThreads 
+    std::cout << "Training " << treeCount << " with " << numThreads 
               << " OpenMP threads..." << std::endl;
     std::cout << "Dataset: " << dataSize << " samples, " << rowLength 
               << " features" << std::endl;
     #else
-    std::cout << "Training " << numTrees_ << " trees (no OpenMP)..." << std::endl;
+    std::cout << "Training " << treeCount << " (no OpenMP)..." << std::endl;
     #endif
     
-    // **重要：预分配所有容器，确保线程安全**
-    trees_.resize(numTrees_);
-    oobIndices_.resize(numTrees_);
+    // **随机森林模式**：每次分裂的候选特征数（0 表示全部特征）
+    const int mtry = resolveMaxFeatures(maxFeatures_, rowLength);
+    if (mtry > 0) {
+        std::cout << "Random forest mode: " << mtry << "/" << rowLength
+                  << " candidate features per split" << std::endl;
+    }
+    
+    // **本地树序号队列**：线程建完一棵树即取下一个；队列空时取号的线程调用 nextBatch 补充，
+    // 其他线程继续建树，不在批与批之间同步（慢树不会拖住整批）
+    std::vector<int> queue;
+    size_t queueHead = 0;
+    bool exhausted = false;
+    std::vector<std::pair<int, std::unique_ptr<SingleTreeTrainer>>> trained;
     
     // **原子计数器用于线程安全的进度跟踪**
     std::atomic<int> completedTrees(0);
+    const int progressStep = std::max(1, (expectedTrees > 0 ? expectedTrees : numTrees_) / 10);
     
-    // **核心：并行训练多棵树 - 避免vector拷贝**
-    #pragma omp parallel if(numTrees_ > 1)
+    #pragma omp parallel
     {
-        // **线程局部随机数生成器**
-        thread_local std::mt19937 localGen;
-        thread_local bool initialized = false;
-        if (!initialized) {
-            #ifdef _OPENMP
-            const int threadId = omp_get_thread_num();
-            localGen.seed(gen_() + threadId * 1000);
-            #else
-            localGen.seed(gen_());
-            #endif
-            initialized = true;
-        }
-        
         // **线程局部数据缓冲区 - 避免重复分配**
         std::vector<int> sampleIndices, oobIndices;
-        std::vector<double> subData, subLabels;
+        std::vector<std::pair<int, std::unique_ptr<SingleTreeTrainer>>> localTrees;
+        std::vector<OOBContribution> localOOB;
         
-        #pragma omp for schedule(dynamic, 1)
-        for (int t = 0; t < numTrees_; ++t) {
-            // Bootstrap采样
-            bootstrapSample(dataSize, sampleIndices, oobIndices, localGen);
+        for (;;) {
+            int t = -1;
+            #pragma omp critical(bagging_tree_queue)
+            {
+                if (queueHead == queue.size() && !exhausted) {
+                    queue = nextBatch();
+                    queueHead = 0;
+                    exhausted = queue.empty();
+                }
+                if (queueHead < queue.size()) t = queue[queueHead++];
+            }
+            if (t < 0) break;
             
-            // **高效数据提取 - 避免不必要的拷贝**
-            extractSubsetOptimized(data, rowLength, labels, sampleIndices, 
-                                  subData, subLabels);
+            // Bootstrap采样：计数器型随机流只由基础种子与全局树序号决定，与线程 / 进程无关
+            Philox bootstrapRng(seed_, {Philox::Bootstrap, static_cast<uint64_t>(t)});
+            bootstrapSample(dataSize, sampleIndices, oobIndices, bootstrapRng);
+            
+            // **零拷贝**：抽样位置映射为共享矩阵行号，重复行号表达抽中次数；
+            // 每棵树只持有 sampleRatio·n 个行号，不再拷贝 sampleRatio·n·F 个特征
+            auto rows = std::make_shared<std::vector<int>>(sampleIndices.size());
+            for (size_t i = 0; i < sampleIndices.size(); ++i) {
+                (*rows)[i] = view.rowId(sampleIndices[i]);
+            }
+            const auto bootstrap = DatasetView::indexed(view.features(), view.labels(), rowLength, std::move(rows));
+            
+            // 特征子采样 / 随机阈值的种子只取决于基础种子与树序号，节点在流号中区分
+            const uint64_t treeKey = Philox::hashIds({seed_, static_cast<uint64_t>(t)});
+            auto finder = createSplitFinder(treeKey);
+            finder->setFeatureSubsampling(mtry, treeKey);
             
             // **创建单棵树 - 使用智能指针管理内存**
             auto tree = std::make_unique<SingleTreeTrainer>(
-                createSplitFinder(),
+                std::move(finder),
                 createCriterion(),
                 createPruner({}, rowLength, {}),
                 maxDepth_,
                 minSamplesLeaf_
             );
             
-            tree->train(subData, rowLength, subLabels);
+            tree->trainOnView(bootstrap);
+            
+            // **增量袋外统计**：树刚建好时记录其袋外预测，训练后无需再遍历
+            Philox permRng(seed_, {Philox::OOBPermutation, static_cast<uint64_t>(t)});
+            localOOB.push_back(computeOOB(t, *tree, view, std::move(oobIndices),
+                                          oobImportance_ ? &permRng : nullptr));
             
-            // **线程安全的结果存储**
-            trees_[t] = std::move(tree);
-            oobIndices_[t] = std::move(oobIndices);
+            localTrees.emplace_back(t, std::move(tree));
             
             // **线程安全的进度输出**
             const int completed = ++completedTrees;
-            if (completed % std::max(1, numTrees_ / 10) == 0) {
+            if (completed % progressStep == 0) {
                 #pragma omp critical(progress_output)
                 {
-                    std::cout << "Completed " << completed << "/" << numTrees_ 
-                              << " trees (" << std::fixed << std::setprecision(1) 
-                              << 100.0 * completed / numTrees_ << "%)" << std::endl;
-                    std::cout.flush();
+                    std::cout << "Completed " << completed;
+                    if (expectedTrees > 0) {
+                        std::cout << "/" << expectedTrees << " trees (" << std::fixed << std::setprecision(1)
+                                  << 100.0 * completed / expectedTrees << "%)";
+                    } else {
+                        std::cout << " trees on this process";
+                    }
+                    std::cout << std::endl;
                 }
             }
         }
+        
+        #pragma omp critical(bagging_tree_merge)
+        {
+            for (auto& entry : localTrees) trained.push_back(std::move(entry));
+            for (auto& entry : localOOB) oobContributions_.push_back(std::move(entry));
+        }
+    }
+    
+    // **按全局树序号排列**：树的存放顺序与线程调度无关
+    std::sort(trained.begin(), trained.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    trees_.reserve(trained.size());
+    treeIds_.reserve(trained.size());
+    for (auto& [id, tree] : trained) {
+        treeIds_.push_back(id);
+        trees_.push_back(std::move(tree));
+    }
+    
+    // **按树序号折叠袋外贡献**：加法顺序与线程调度无关
+    std::sort(oobContributions_.begin(), oobContributions_.end(),
+              [](const OOBContribution& a, const OOBContribution& b) { return a.treeId < b.treeId; });
+    std::vector<const OOBContribution*> ordered;
+    ordered.reserve(oobContributions_.size());
+    for (const auto& c : oobContributions_) ordered.push_back(&c);
+    foldOOB(ordered, dataSize, oobImportance_ ? rowLength : 0,
+            oobSums_, oobCounts_, oobImportanceSums_, oobImportanceTrees_);
+    
+    // **紧凑森林**：全部树按先序展开到连续节点数组，供单行预测使用
+    for (const auto& tree : trees_) {
+        forest_.addTree(tree ? tree->getRoot() : nullptr);
     }
     
     std::cout << "Bagging training completed!" << std::endl;
@@ -314,20 +392,12 @@ void BaggingTrainer::train(const std::vector<double>& data,
     #endif
 }
 
-double BaggingTrainer::predict(const double* sample, int rowLength) const {
-    if (trees_.empty()) return 0.0;
-    
-    double sum = 0.0;
+double BaggingTrainer::predict(const double* sample, int /* rowLength */) const {
+    if (forest_.empty()) return 0.0;
     
-    // **并行预测**
-    #pragma omp parallel for reduction(+:sum) schedule(static) if(trees_.size() > 10)
-    for (size_t i = 0; i < trees_.size(); ++i) {
-        if (trees_[i]) {
-            sum += trees_[i]->predict(sample, rowLength);
-        }
-    }
-    
-    return sum / trees_.size();
+    // **串行快速路径**：逐行打分时为每行开并行区的开销远大于遍历本身；
+    // 批量评估在行维度并行，这里保持串行
+    return predictSum(sample) / static_cast<double>(forest_.numTrees());
 }
 
 void BaggingTrainer::evaluate(const std::vector<double>& X,
@@ -412,57 +482,118 @@ std::vector<double> BaggingTrainer::getFeatureImportance(int numFeatures) const
     return importance;
 }
 
-// **优化6: 批量OOB计算 - 避免vector拷贝**
+// **OOB 误差**：直接使用训练中累积的袋外统计
 double BaggingTrainer::getOOBError(const std::vector<double>& data,
                                   int rowLength,
                                   const std::vector<double>& labels) const {
-    if (trees_.empty() || oobIndices_.empty()) return 0.0;
-    
-    const int dataSize = static_cast<int>(labels.size());
-    std::vector<double> oobPredictions(dataSize, 0.0);
-    std::vector<int> oobCounts(dataSize, 0);
+    return getOOBError(DatasetView(data, labels, rowLength));
+}
+
+double BaggingTrainer::getOOBError(const DatasetView& train) const {
+    // 袋外统计按训练视图的序号累积，视图不一致时无法对应
+    if (trees_.empty() || oobCounts_.size() != train.size()) return 0.0;
     
-    // **并行计算所有OOB预测**
-    #pragma omp parallel for schedule(static) if(trees_.size() > 10)
-    for (size_t t = 0; t < trees_.size(); ++t) {
-        if (!trees_[t]) continue;
-        
-        const auto& oobSet = oobIndices_[t];
-        
-        // **对当前树的OOB样本进行预测**
-        for (const int idx : oobSet) {
-            const double pred = trees_[t]->predict(&data[idx * rowLength], rowLength);
-            
-            // **线程安全的累加**
-            #pragma omp atomic
-            oobPredictions[idx] += pred;
-            
-            #pragma omp atomic
-            oobCounts[idx]++;
-        }
-    }
+    return oobMeanSquaredError(train, oobSums_, oobCounts_);
+}
+
+double BaggingTrainer::oobMeanSquaredError(const DatasetView& train,
+                                           const std::vector<double>& sums,
+                                           const std::vector<uint32_t>& counts) {
+    if (counts.size() != train.size() || sums.size() != train.size()) return 0.0;
     
-    // **计算OOB误差**
+    // 串行按序号求和：与线程数无关，分布式版本得到逐位相同的结果
     double oobMSE = 0.0;
-    int validCount = 0;
-    
-    #pragma omp parallel for reduction(+:oobMSE,validCount) schedule(static)
-    for (int i = 0; i < dataSize; ++i) {
-        if (oobCounts[i] > 0) {
-            const double avgPred = oobPredictions[i] / oobCounts[i];
-            const double diff = labels[i] - avgPred;
+    size_t validCount = 0;
+    for (size_t i = 0; i < train.size(); ++i) {
+        if (counts[i] > 0) {
+            const double diff = train.label(i) - sums[i] / counts[i];
             oobMSE += diff * diff;
-            validCount++;
+            ++validCount;
         }
     }
     
     return validCount > 0 ? oobMSE / validCount : 0.0;
 }
 
-// **保留旧接口的兼容性方法**
-void BaggingTrainer::bootstrapSample(int dataSize,
-                                     std::vector<int>& sampleIndices,
-                                     std::vector<int>& oobIndices) const {
-    thread_local std::mt19937 localGen(gen_());
-    bootstrapSample(dataSize, sampleIndices, oobIndices, localGen);
-}
\ No newline at end of file
+std::vector<double> BaggingTrainer::getOOBPermutationImportance() const {
+    std::vector<double> importance(oobImportanceSums_);
+    if (oobImportanceTrees_ > 0) {
+        const double invTrees = 1.0 / oobImportanceTrees_;
+        for (double& v : importance) v *= invTrees;
+    }
+    return importance;
+}
+
+// **单棵树的袋外贡献**：预测只写该树自己的记录
+BaggingTrainer::OOBContribution BaggingTrainer::computeOOB(int treeId,
+                                                           const SingleTreeTrainer& tree,
+                                                           const DatasetView& view,
+                                                           std::vector<int> oob,
+                                                           Philox* permRng) const {
+    const int rowLength = view.numFeatures();
+    OOBContribution out;
+    out.treeId = treeId;
+    out.predictions.resize(oob.size());
+    
+    double baseSq = 0.0;
+    for (size_t k = 0; k < oob.size(); ++k) {
+        const double pred = tree.predict(view.sample(oob[k]), rowLength);
+        out.predictions[k] = pred;
+        const double diff = view.label(oob[k]) - pred;
+        baseSq += diff * diff;
+    }
+    out.rows = std::move(oob);
+    if (!permRng || out.rows.size() < 2) return out;
+    
+    // **OOB 置换重要性**：袋外行打乱一次，所有特征共用该排列（每次只替换一个特征）；
+    // 每行只拷贝一次到行缓冲，逐特征替换、预测、还原
+    const std::vector<int>& rows = out.rows;
+    std::vector<int> perm(rows);
+    permRng->shuffle(perm.begin(), perm.end());
+    
+    std::vector<double> permSq(rowLength, 0.0);
+    std::vector<double> row(rowLength);
+    for (size_t k = 0; k < rows.size(); ++k) {
+        const double* src = view.sample(rows[k]);
+        const double* donor = view.sample(perm[k]);
+        const double y = view.label(rows[k]);
+        std::copy(src, src + rowLength, row.begin());
+        for (int j = 0; j < rowLength; ++j) {
+            row[j] = donor[j];
+            const double diff = y - tree.predict(row.data(), rowLength);
+            permSq[j] += diff * diff;
+            row[j] = src[j];
+        }
+    }
+    
+    out.importance.resize(rowLength);
+    const double invOOB = 1.0 / static_cast<double>(rows.size());
+    for (int j = 0; j < rowLength; ++j) {
+        out.importance[j] = (permSq[j] - baseSq) * invOOB;
+    }
+    return out;
+}
+
+// **按序折叠**：逐树把袋外预测加到对应行；每行的加法顺序即树序号顺序
+void BaggingTrainer::foldOOB(const std::vector<const OOBContribution*>& ordered,
+                             size_t dataSize, int numFeatures,
+                             std::vector<double>& sums, std::vector<uint32_t>& counts,
+                             std::vector<double>& importanceSums, int& importanceTrees) {
+    sums.assign(dataSize, 0.0);
+    counts.assign(dataSize, 0);
+    importanceSums.assign(std::max(numFeatures, 0), 0.0);
+    importanceTrees = 0;
+    
+    for (const OOBContribution* c : ordered) {
+        for (size_t k = 0; k < c->rows.size(); ++k) {
+            const size_t i = static_cast<size_t>(c->rows[k]);
+            if (i >= dataSize) continue;
+            sums[i] += c->predictions[k];
+            ++counts[i];
+        }
+        if (!c->importance.empty() && c->importance.size() == importanceSums.size()) {
+            for (size_t j = 0; j < importanceSums.size(); ++j) importanceSums[j] += c->importance[j];
+            ++importanceTrees;
+        }
+    }
+}
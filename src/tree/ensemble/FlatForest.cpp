@@ -0,0 +1,59 @@
+// =============================================================================
+// src/tree/ensemble/FlatForest.cpp - 紧凑森林构建
+// =============================================================================
+#include "ensemble/FlatForest.hpp"
+
+#include <utility>
+
+// **先序展开**：栈中先压右孩子再压左孩子，左孩子总是紧随父节点写出；
+// 右孩子出栈时回填父节点的 right 下标
+void FlatForest::addTree(const Node* root) {
+    roots_.push_back(static_cast<int>(nodes_.size()));
+
+    std::vector<std::pair<const Node*, int>> stack;  // (节点, 待回填 right 的父节点下标)
+    stack.emplace_back(root, -1);
+    while (!stack.empty()) {
+        const auto [node, parent] = stack.back();
+        stack.pop_back();
+
+        const int idx = static_cast<int>(nodes_.size());
+        if (parent >= 0) nodes_[parent].right = idx;
+
+        // 缺失的孩子与逐节点遍历一致，预测为 0
+        if (!node) {
+            nodes_.push_back({-1, -1, 0.0});
+        } else if (node->isLeaf) {
+            nodes_.push_back({-1, -1, node->getPrediction()});
+        } else {
+            nodes_.push_back({node->getFeatureIndex(), -1, node->getThreshold()});
+            stack.emplace_back(node->getRight(), idx);
+            stack.emplace_back(node->getLeft(), -1);
+        }
+    }
+}
+
+void FlatForest::append(const FlatForest& other) {
+    const int offset = static_cast<int>(nodes_.size());
+    nodes_.reserve(nodes_.size() + other.nodes_.size());
+    for (FlatNode node : other.nodes_) {
+        if (node.feature >= 0) node.right += offset;
+        nodes_.push_back(node);
+    }
+    for (const int root : other.roots_) {
+        roots_.push_back(root + offset);
+    }
+}
+
+// 各树节点连续存放：第 k 棵树占据 [roots[k], roots[k+1])
+void FlatForest::appendTree(const FlatForest& other, size_t k) {
+    const int first = other.roots_[k];
+    const int last = k + 1 < other.roots_.size() ? other.roots_[k + 1]
+                                                 : static_cast<int>(other.nodes_.size());
+    const int offset = static_cast<int>(nodes_.size()) - first;
+    roots_.push_back(first + offset);
+    for (int i = first; i < last; ++i) {
+        FlatNode node = other.nodes_[i];
+        if (node.feature >= 0) node.right += offset;
+        nodes_.push_back(node);
+    }
+}
@@ -1,10 +1,12 @@
 #include "ensemble/MPIBaggingTrainer.hpp"
+#include "ensemble/MPIDataLoader.hpp"
 #include <iostream>
 #include <iomanip>
 #include <set>
 #include <chrono>
 #include <numeric>
 #include <algorithm>
+#include <cstring>
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -37,24 +39,12 @@ MPIBaggingTrainer::MPIBaggingTrainer(int numTrees,
     localNumTrees_ = localTrees;
     treeOffset_ = offset;
     
-    // Strong randomization for process independence
-    std::random_device rd;
-    std::mt19937 masterGen(seed);
-    
-    // Generate independent seed sequence
-    std::vector<uint32_t> processSeeds(mpiSize_);
-    for (int i = 0; i < mpiSize_; ++i) {
-        processSeeds[i] = masterGen();
-        processSeeds[i] ^= (i * 2654435761U);  // Large prime
-        processSeeds[i] ^= rd();  // Hardware randomness
-    }
-    
-    uint32_t localSeed = processSeeds[mpiRank_];
-    uint32_t bagSeed = localSeed ^ (treeOffset_ * 1103515245U);
-    
+    // Every process uses the same base seed: the local trainer derives each tree's
+    // bootstrap and feature sampling from (seed, global tree id), so a tree is the
+    // same no matter which process trains it
     // Create local bagging trainer
     localBagging_ = std::make_unique<BaggingTrainer>(
-        localNumTrees_,
+        numTrees_,
         sampleRatio_,
         maxDepth_,
         minSamplesLeaf_,
@@ -62,13 +52,13 @@ MPIBaggingTrainer::MPIBaggingTrainer(int numTrees,
         splitMethod_,
         prunerType_,
         prunerParam_,
-        bagSeed
+        baseSeed_
     );
     
     if (mpiRank_ == 0) {
         std::cout << "Enhanced MPI Bagging initialized with " << mpiSize_ << " processes" << std::endl;
         std::cout << "Total trees: " << numTrees_ << std::endl;
-        std::cout << "Strong randomization: enabled" << std::endl;
+        std::cout << "Per-tree seeds: derived from base seed " << baseSeed_ << " and tree id" << std::endl;
         #ifdef _OPENMP
         std::cout << "OpenMP threads per process: " << omp_get_max_threads() << std::endl;
         #endif
@@ -79,34 +69,61 @@ void MPIBaggingTrainer::train(const std::vector<double>& data,
                               int numFeatures,
                               const std::vector<double>& labels) {
     
+    size_t expectedDataSize = labels.size() * numFeatures;
+    if (data.size() != expectedDataSize) {
+        std::cerr << "Process " << mpiRank_ << " ERROR: Data size mismatch!" << std::endl;
+        return;
+    }
+    trainOnView(DatasetView(data, labels, numFeatures));
+}
+
+void MPIBaggingTrainer::trainOnView(const DatasetView& view) {
+    
     auto totalStart = std::chrono::high_resolution_clock::now();
     
+    // Dynamic claims are made by whichever OpenMP thread runs out of work, so the
+    // MPI library must allow serialized calls from any thread
+    if (dynamicScheduling_ && !threadsMayCallMPI()) {
+        if (mpiRank_ == 0) {
+            std::cout << "MPI thread support below MPI_THREAD_SERIALIZED: "
+                      << "falling back to static tree scheduling" << std::endl;
+        }
+        dynamicScheduling_ = false;
+    }
+    
     if (mpiRank_ == 0) {
-        std::cout << "\nStarting distributed training..." << std::endl;
-        for (int r = 0; r < mpiSize_; ++r) {
-            auto [trees, offset] = calculateTreeAssignment(r, mpiSize_, numTrees_);
-            std::cout << "  Process " << r << ": trees " << offset 
-                      << "-" << (offset + trees - 1) << " (" << trees << " trees)" << std::endl;
+        std::cout << "\nStarting distributed training ("
+                  << (dynamicScheduling_ ? "dynamic" : "static") << " tree scheduling)..." << std::endl;
+        if (!dynamicScheduling_) {
+            for (int r = 0; r < mpiSize_; ++r) {
+                auto [trees, offset] = calculateTreeAssignment(r, mpiSize_, numTrees_);
+                std::cout << "  Process " << r << ": trees " << offset 
+                          << "-" << (offset + trees - 1) << " (" << trees << " trees)" << std::endl;
+            }
         }
     }
     
     auto trainStart = std::chrono::high_resolution_clock::now();
     
-    // Data validation
-    if (labels.empty() || data.empty() || numFeatures <= 0) {
+    // Data validation (every process holds the same view, so all take the same branch)
+    if (view.empty() || view.numFeatures() <= 0) {
         std::cerr << "Process " << mpiRank_ << " ERROR: Invalid training data!" << std::endl;
         return;
     }
     
-    size_t expectedDataSize = labels.size() * numFeatures;
-    if (data.size() != expectedDataSize) {
-        std::cerr << "Process " << mpiRank_ << " ERROR: Data size mismatch!" << std::endl;
-        return;
-    }
-    
-    if (localNumTrees_ > 0) {
-        localBagging_->train(data, numFeatures, labels);
+    if (dynamicScheduling_) {
+        trainDynamic(view);
+    } else {
+        auto [trees, offset] = calculateTreeAssignment(mpiRank_, mpiSize_, numTrees_);
+        std::vector<int> block(trees);
+        std::iota(block.begin(), block.end(), offset);
+        localBagging_->trainOnView(view, [&block]() {
+            std::vector<int> batch;
+            batch.swap(block);
+            return batch;
+        }, trees);
     }
+    localNumTrees_ = static_cast<int>(localBagging_->getTreeIds().size());
     
     auto trainEnd = std::chrono::high_resolution_clock::now();
     
@@ -126,18 +143,131 @@ void MPIBaggingTrainer::train(const std::vector<double>& data,
     }
 }
 
-double MPIBaggingTrainer::predict(const double* sample, int numFeatures) const {
-    double localPred = 0.0;
+bool MPIBaggingTrainer::threadsMayCallMPI() {
+    int provided = MPI_THREAD_SINGLE;
+    MPI_Query_thread(&provided);
+    int threads = 1;
+    #ifdef _OPENMP
+    threads = omp_get_max_threads();
+    #endif
+    return provided >= MPI_THREAD_SERIALIZED || threads == 1;
+}
+
+void MPIBaggingTrainer::trainDynamic(const DatasetView& view) {
+    // Shared tree counter on rank 0; every claim is one atomic fetch-and-add
+    int64_t* counter = nullptr;
+    MPI_Win win;
+    const MPI_Aint bytes = mpiRank_ == 0 ? static_cast<MPI_Aint>(sizeof(int64_t)) : 0;
+    MPI_Win_allocate(bytes, sizeof(int64_t), MPI_INFO_NULL, comm_, &counter, &win);
+    
+    // Initialize inside the passive-target epoch: the local store is made visible
+    // to RMA by MPI_Win_sync, and the barrier orders it before any remote claim
+    MPI_Win_lock_all(0, win);
+    if (mpiRank_ == 0) {
+        *counter = 0;
+        MPI_Win_sync(win);
+    }
+    MPI_Barrier(comm_);
     
-    if (localNumTrees_ > 0 && localBagging_) {
-        double avgPred = localBagging_->predict(sample, numFeatures);
-        localPred = avgPred * localNumTrees_;
+    // Each OpenMP thread claims one id when it finishes a tree; the local queue's
+    // critical section serializes the claims, the other threads keep training
+    const int64_t one = 1;
+    localBagging_->trainOnView(view, [&]() {
+        int64_t first = 0;
+        MPI_Fetch_and_op(&one, &first, MPI_INT64_T, 0, 0, MPI_SUM, win);
+        MPI_Win_flush(0, win);
+        
+        std::vector<int> batch;
+        if (first < numTrees_) batch.push_back(static_cast<int>(first));
+        return batch;
+    });
+    
+    MPI_Win_unlock_all(win);
+    MPI_Win_free(&win);
+}
+
+double MPIBaggingTrainer::predict(const double* sample, int /* numFeatures */) const {
+    // Serving path: the whole forest is local, no collectives per row
+    if (!globalForest_.empty()) {
+        return globalForest_.predictSum(sample) / static_cast<double>(globalForest_.numTrees());
     }
     
-    double globalSum = 0.0;
-    MPI_Allreduce(&localPred, &globalSum, 1, MPI_DOUBLE, MPI_SUM, comm_);
+    // Each tree's prediction goes to its id slot. Every slot has exactly one
+    // contributor, so the reduction is exact; the slots are then summed in id
+    // order, as the gathered forest does
+    std::vector<double> perTree(numTrees_, 0.0);
+    if (localNumTrees_ > 0 && localBagging_) {
+        const FlatForest& forest = localBagging_->getForest();
+        const std::vector<int>& ids = localBagging_->getTreeIds();
+        for (size_t k = 0; k < ids.size(); ++k) {
+            perTree[ids[k]] = forest.predictTree(sample, k);
+        }
+    }
+    MPI_Allreduce(MPI_IN_PLACE, perTree.data(), numTrees_, MPI_DOUBLE, MPI_SUM, comm_);
     
-    return globalSum / numTrees_;
+    double sum = 0.0;
+    for (const double v : perTree) sum += v;
+    return sum / numTrees_;
+}
+
+void MPIBaggingTrainer::gatherForest(int rootRank) {
+    collectForest(globalForest_, rootRank);
+}
+
+void MPIBaggingTrainer::collectForest(FlatForest& forest, int rootRank) const {
+    using FlatNode = FlatForest::FlatNode;
+    const FlatForest emptyForest;
+    const FlatForest& local = (localNumTrees_ > 0 && localBagging_) ? localBagging_->getForest() : emptyForest;
+    
+    const std::vector<int> emptyIds;
+    const std::vector<int>& localIds = (localNumTrees_ > 0 && localBagging_) ? localBagging_->getTreeIds() : emptyIds;
+    
+    // Node arrays, roots and tree ids travel as bytes with 64-bit sizes in
+    // chunked rounds, so a forest larger than 2 GB does not overflow int counts
+    std::vector<char> nodeBuf, rootBuf, idBuf;
+    std::vector<uint64_t> nodeBytes, rootBytes, idBytes;
+    mpi_data::gatherBytesChunked(local.nodes().data(), local.nodes().size() * sizeof(FlatNode),
+                                 nodeBuf, nodeBytes, rootRank, comm_);
+    mpi_data::gatherBytesChunked(local.roots().data(), local.roots().size() * sizeof(int),
+                                 rootBuf, rootBytes, rootRank, comm_);
+    mpi_data::gatherBytesChunked(localIds.data(), localIds.size() * sizeof(int),
+                                 idBuf, idBytes, rootRank, comm_);
+    
+    forest.clear();
+    if (rootRank >= 0 && rootRank != mpiRank_) return;
+    
+    // Node indices are local to each sender; rebuild each rank's forest first
+    std::vector<FlatForest> parts(mpiSize_);
+    std::vector<size_t> rootDispls(mpiSize_ + 1, 0);
+    size_t nodeOffset = 0;
+    for (int r = 0; r < mpiSize_; ++r) {
+        std::vector<FlatNode> partNodes(nodeBytes[r] / sizeof(FlatNode));
+        std::vector<int> partRoots(rootBytes[r] / sizeof(int));
+        if (nodeBytes[r] > 0) std::memcpy(partNodes.data(), nodeBuf.data() + nodeOffset, nodeBytes[r]);
+        if (rootBytes[r] > 0) std::memcpy(partRoots.data(), rootBuf.data() + rootDispls[r] * sizeof(int), rootBytes[r]);
+        parts[r].assign(std::move(partNodes), std::move(partRoots));
+        nodeOffset += nodeBytes[r];
+        rootDispls[r + 1] = rootDispls[r] + rootBytes[r] / sizeof(int);
+    }
+    const size_t totalRoots = rootDispls[mpiSize_];
+    std::vector<int> ids(totalRoots);
+    if (totalRoots > 0) std::memcpy(ids.data(), idBuf.data(), totalRoots * sizeof(int));
+    
+    // Then append tree by tree in global id order, so the forest (and the order of
+    // the floating-point sums in predict) does not depend on the schedule
+    std::vector<std::pair<int, size_t>> order;  // (tree id, global position)
+    order.reserve(totalRoots);
+    for (size_t i = 0; i < totalRoots; ++i) order.emplace_back(ids[i], i);
+    std::sort(order.begin(), order.end());
+    
+    std::vector<int> ownerRank(totalRoots);
+    for (int r = 0; r < mpiSize_; ++r) {
+        std::fill(ownerRank.begin() + rootDispls[r], ownerRank.begin() + rootDispls[r + 1], r);
+    }
+    for (const auto& [id, pos] : order) {
+        const int r = ownerRank[pos];
+        forest.appendTree(parts[r], pos - rootDispls[r]);
+    }
 }
 
 void MPIBaggingTrainer::predictBatch(const std::vector<double>& X,
@@ -149,35 +279,79 @@ void MPIBaggingTrainer::predictBatch(const std::vector<double>& X,
         return;
     }
     
-    const size_t n = X.size() / numFeatures;
-    predictions.resize(n);
-    
-    std::vector<double> localPredictions(n, 0.0);
-    
-    if (localNumTrees_ > 0) {
-        #pragma omp parallel for schedule(static, 256) if(n > 1000)
-        for (size_t i = 0; i < n; ++i) {
-            localPredictions[i] = localBagging_->predict(&X[i * numFeatures], numFeatures) * localNumTrees_;
-        }
-    }
-    
-    // Ensure consistent batch sizes across processes
-    int localSize = static_cast<int>(n);
-    int globalSize = 0;
-    MPI_Allreduce(&localSize, &globalSize, 1, MPI_INT, MPI_MAX, comm_);
-    
-    if (localSize != globalSize) {
+    predictRows(DatasetView::unlabeled(X, numFeatures), predictions);
+}
+
+void MPIBaggingTrainer::predictRows(const DatasetView& view,
+                                    std::vector<double>& predictions,
+                                    const ChunkCallback& onChunk) const {
+    const size_t n = view.size();
+    predictions.assign(n, 0.0);
+    
+    // Batch sizes must agree, and every rank needs the whole forest: ranks without
+    // it (gatherForest() not called, or called for a single root) trigger one
+    // collective gather into a temporary copy
+    long long checks[3] = {static_cast<long long>(n), -static_cast<long long>(n),
+                           globalForest_.empty() ? 1 : 0};
+    MPI_Allreduce(MPI_IN_PLACE, checks, 3, MPI_LONG_LONG, MPI_MAX, comm_);
+    if (checks[0] != -checks[1]) {
         std::cerr << "Process " << mpiRank_ << " ERROR: Inconsistent batch sizes!" << std::endl;
+        predictions.clear();
         return;
     }
+    FlatForest gathered;
+    if (checks[2] != 0) collectForest(gathered, -1);
+    const FlatForest& forest = checks[2] != 0 ? gathered : globalForest_;
+    if (n == 0 || forest.empty()) return;
+    
+    // Every row is scored by one rank on the id-ordered forest, so predictions do
+    // not depend on which rank trained which tree. Each chunk's rows are split
+    // across ranks; the in-place allgather of chunk k overlaps scoring of chunk k+1
+    const size_t numChunks = (n + kPredictChunkRows - 1) / kPredictChunkRows;
+    std::vector<MPI_Request> requests(numChunks, MPI_REQUEST_NULL);
+    std::vector<std::vector<int>> counts(numChunks), displs(numChunks);
+    const double forestSize = static_cast<double>(forest.numTrees());
+    size_t nextToFinish = 0;
+    
+    auto finishChunk = [&](size_t k) {
+        MPI_Wait(&requests[k], MPI_STATUS_IGNORE);
+        const size_t begin = k * kPredictChunkRows;
+        const size_t end = std::min(n, begin + kPredictChunkRows);
+        if (onChunk) onChunk(begin, end);
+    };
+    
+    for (size_t k = 0; k < numChunks; ++k) {
+        const size_t begin = k * kPredictChunkRows;
+        const size_t len = std::min(n, begin + kPredictChunkRows) - begin;
+        counts[k].resize(mpiSize_);
+        displs[k].resize(mpiSize_);
+        for (int r = 0; r < mpiSize_; ++r) {
+            const size_t lo = len * r / mpiSize_;
+            const size_t hi = len * (r + 1) / mpiSize_;
+            counts[k][r] = static_cast<int>(hi - lo);
+            displs[k][r] = static_cast<int>(lo);
+        }
+        
+        const size_t lo = begin + displs[k][mpiRank_];
+        const size_t hi = lo + counts[k][mpiRank_];
+        #pragma omp parallel for schedule(static, 256) if(hi - lo > 1000)
+        for (size_t i = lo; i < hi; ++i) {
+            predictions[i] = forest.predictSum(view.sample(i)) / forestSize;
+        }
+        
+        MPI_Iallgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, predictions.data() + begin,
+                        counts[k].data(), displs[k].data(), MPI_DOUBLE, comm_, &requests[k]);
+        
+        // Bound the number of exchanges in flight and give the library a chance to progress them
+        while (k + 1 - nextToFinish > kMaxInFlightChunks) {
+            finishChunk(nextToFinish++);
+        }
+        int done = 0;
+        MPI_Test(&requests[nextToFinish], &done, MPI_STATUS_IGNORE);
+    }
     
-    MPI_Allreduce(localPredictions.data(), predictions.data(), 
-                  static_cast<int>(n), MPI_DOUBLE, MPI_SUM, comm_);
-    
-    const double invNumTrees = 1.0 / numTrees_;
-    #pragma omp parallel for schedule(static) if(n > 1000)
-    for (size_t i = 0; i < n; ++i) {
-        predictions[i] *= invNumTrees;
+    while (nextToFinish < numChunks) {
+        finishChunk(nextToFinish++);
     }
 }
 
@@ -187,18 +361,33 @@ void MPIBaggingTrainer::evaluate(const std::vector<double>& X,
                                  double& mse,
                                  double& mae) {
     
-    const size_t n = y.size();
-    
     // Data validation
-    if (X.size() != n * numFeatures) {
+    if (X.size() != y.size() * numFeatures) {
         std::cerr << "Process " << mpiRank_ << " ERROR: Data size mismatch in evaluate!" << std::endl;
         mse = mae = std::numeric_limits<double>::infinity();
         return;
     }
+    evaluateOnView(DatasetView(X, y, numFeatures), mse, mae);
+}
+
+void MPIBaggingTrainer::evaluateOnView(const DatasetView& view, double& mse, double& mae) {
+    const size_t n = view.size();
     
-    // Use batch prediction to avoid MPI communication in OpenMP loops
+    // Predictions already arrive identical on every process, so the errors are
+    // accumulated chunk by chunk as each reduction lands; no extra metrics round
+    double sqSum = 0.0, absSum = 0.0;
     std::vector<double> predictions;
-    predictBatch(X, numFeatures, predictions);
+    predictRows(view, predictions, [&](size_t begin, size_t end) {
+        double sq = 0.0, abs = 0.0;
+        #pragma omp parallel for reduction(+:sq,abs) schedule(static, 256) if(end - begin > 1000)
+        for (size_t i = begin; i < end; ++i) {
+            const double diff = view.label(i) - predictions[i];
+            sq += diff * diff;
+            abs += std::abs(diff);
+        }
+        sqSum += sq;
+        absSum += abs;
+    });
     
     if (predictions.size() != n) {
         std::cerr << "Process " << mpiRank_ << " ERROR: Prediction size mismatch!" << std::endl;
@@ -206,19 +395,8 @@ void MPIBaggingTrainer::evaluate(const std::vector<double>& X,
         return;
     }
     
-    // Compute MSE and MAE using OpenMP
-    mse = 0.0;
-    mae = 0.0;
-    
-    #pragma omp parallel for reduction(+:mse,mae) schedule(static, 256) if(n > 1000)
-    for (size_t i = 0; i < n; ++i) {
-        const double diff = y[i] - predictions[i];
-        mse += diff * diff;
-        mae += std::abs(diff);
-    }
-    
-    mse /= n;
-    mae /= n;
+    mse = sqSum / n;
+    mae = absSum / n;
     
     // Only master reports results
     if (mpiRank_ == 0) {
@@ -228,9 +406,8 @@ void MPIBaggingTrainer::evaluate(const std::vector<double>& X,
 }
 
 std::vector<double> MPIBaggingTrainer::getFeatureImportance(int numFeatures) const {
-    // Ensure all processes use the same number of features
-    int globalNumFeatures = numFeatures;
-    MPI_Bcast(&globalNumFeatures, 1, MPI_INT, 0, comm_);
+    // Every process passes the same feature count (collective)
+    const int globalNumFeatures = numFeatures;
     
     // Calculate local importance
     std::vector<double> localImportance(globalNumFeatures, 0.0);
@@ -260,12 +437,9 @@ std::vector<double> MPIBaggingTrainer::getFeatureImportance(int numFeatures) con
         }
     }
     
-    // Synchronization barrier
-    MPI_Barrier(comm_);
-    
-    // Sum across all processes
-    std::vector<double> globalImportance(globalNumFeatures, 0.0);
-    int mpiResult = MPI_Allreduce(localImportance.data(), globalImportance.data(), 
+    // One reduction; every process normalizes its own copy
+    std::vector<double> globalImportance = std::move(localImportance);
+    int mpiResult = MPI_Allreduce(MPI_IN_PLACE, globalImportance.data(),
                                   globalNumFeatures, MPI_DOUBLE, MPI_SUM, comm_);
     
     if (mpiResult != MPI_SUCCESS) {
@@ -275,31 +449,120 @@ std::vector<double> MPIBaggingTrainer::getFeatureImportance(int numFeatures) con
         return std::vector<double>(globalNumFeatures, 0.0);
     }
     
-    // Normalize by total trees (only on master process)
-    if (mpiRank_ == 0 && numTrees_ > 0) {
+    if (numTrees_ > 0) {
         const double invNumTrees = 1.0 / numTrees_;
         for (auto& val : globalImportance) {
             val *= invNumTrees;
         }
     }
     
-    // Broadcast the normalized result to all processes
-    MPI_Bcast(globalImportance.data(), globalNumFeatures, MPI_DOUBLE, 0, comm_);
-    
     return globalImportance;
 }
 
 double MPIBaggingTrainer::getOOBError(const std::vector<double>& data,
                                       int numFeatures,
                                       const std::vector<double>& labels) const {
+    return getOOBError(DatasetView(data, labels, numFeatures));
+}
+
+bool MPIBaggingTrainer::foldGlobalOOB(size_t n, int numFeatures,
+                                      std::vector<double>& sums,
+                                      std::vector<uint32_t>& counts,
+                                      std::vector<double>& importanceSums,
+                                      int& importanceTrees) const {
+    using Contribution = BaggingTrainer::OOBContribution;
+    static const std::vector<Contribution> noContributions;
+    const auto& local = (localNumTrees_ > 0 && localBagging_) ? localBagging_->getOOBContributions()
+                                                              : noContributions;
+    const bool withImportance = numFeatures > 0;
+    
+    // Per tree: (id, OOB rows, importance length) in meta, row positions in rows,
+    // predictions followed by importance deltas in values
+    std::vector<int64_t> meta;
+    std::vector<int> rows;
+    std::vector<double> values;
+    meta.reserve(3 * local.size());
+    for (const auto& c : local) {
+        const size_t imp = withImportance ? c.importance.size() : 0;
+        meta.insert(meta.end(), {static_cast<int64_t>(c.treeId), static_cast<int64_t>(c.rows.size()),
+                                 static_cast<int64_t>(imp)});
+        rows.insert(rows.end(), c.rows.begin(), c.rows.end());
+        values.insert(values.end(), c.predictions.begin(), c.predictions.end());
+        values.insert(values.end(), c.importance.begin(), c.importance.begin() + imp);
+    }
     
-    // OOB error calculation is complex in distributed setting
-    // For now, return local OOB error on master process
-    if (mpiRank_ == 0 && localNumTrees_ > 0) {
-        return localBagging_->getOOBError(data, numFeatures, labels);
+    std::vector<char> metaBuf, rowBuf, valueBuf;
+    std::vector<uint64_t> metaBytes, rowBytes, valueBytes;
+    mpi_data::gatherBytesChunked(meta.data(), meta.size() * sizeof(int64_t), metaBuf, metaBytes, 0, comm_);
+    mpi_data::gatherBytesChunked(rows.data(), rows.size() * sizeof(int), rowBuf, rowBytes, 0, comm_);
+    mpi_data::gatherBytesChunked(values.data(), values.size() * sizeof(double), valueBuf, valueBytes, 0, comm_);
+    if (mpiRank_ != 0) return false;
+    
+    // Unpack every rank's trees (buffers are concatenated in rank order)
+    std::vector<Contribution> all;
+    const size_t numTrees = metaBuf.size() / (3 * sizeof(int64_t));
+    all.resize(numTrees);
+    const char* metaPtr = metaBuf.data();
+    const char* rowPtr = rowBuf.data();
+    const char* valuePtr = valueBuf.data();
+    for (auto& c : all) {
+        int64_t header[3];
+        std::memcpy(header, metaPtr, sizeof(header));
+        metaPtr += sizeof(header);
+        c.treeId = static_cast<int>(header[0]);
+        c.rows.resize(static_cast<size_t>(header[1]));
+        c.predictions.resize(c.rows.size());
+        c.importance.resize(static_cast<size_t>(header[2]));
+        const size_t rowBytesTree = c.rows.size() * sizeof(int);
+        if (rowBytesTree > 0) std::memcpy(c.rows.data(), rowPtr, rowBytesTree);
+        rowPtr += rowBytesTree;
+        const size_t predBytes = c.predictions.size() * sizeof(double);
+        if (predBytes > 0) std::memcpy(c.predictions.data(), valuePtr, predBytes);
+        valuePtr += predBytes;
+        const size_t impBytes = c.importance.size() * sizeof(double);
+        if (impBytes > 0) std::memcpy(c.importance.data(), valuePtr, impBytes);
+        valuePtr += impBytes;
+    }
+    
+    // Fold in global tree id order, exactly as a single process folds its own trees
+    std::vector<const Contribution*> ordered;
+    ordered.reserve(all.size());
+    for (const auto& c : all) ordered.push_back(&c);
+    std::sort(ordered.begin(), ordered.end(),
+              [](const Contribution* a, const Contribution* b) { return a->treeId < b->treeId; });
+    BaggingTrainer::foldOOB(ordered, n, numFeatures, sums, counts, importanceSums, importanceTrees);
+    return true;
+}
+
+double MPIBaggingTrainer::getOOBError(const DatasetView& train) const {
+    // Per-tree OOB predictions recorded during training are folded on rank 0 in
+    // tree id order, so the error does not depend on which rank trained which tree
+    std::vector<double> sums, importanceSums;
+    std::vector<uint32_t> counts;
+    int importanceTrees = 0;
+    double oobMSE = 0.0;
+    if (foldGlobalOOB(train.size(), 0, sums, counts, importanceSums, importanceTrees)) {
+        oobMSE = BaggingTrainer::oobMeanSquaredError(train, sums, counts);
+    }
+    MPI_Bcast(&oobMSE, 1, MPI_DOUBLE, 0, comm_);
+    return oobMSE;
+}
+
+std::vector<double> MPIBaggingTrainer::getOOBPermutationImportance(int numFeatures) const {
+    // Per-tree importance deltas are folded on rank 0 in tree id order, then broadcast
+    std::vector<double> sums, importance;
+    std::vector<uint32_t> counts;
+    int trees = 0;
+    if (foldGlobalOOB(0, numFeatures, sums, counts, importance, trees) && trees > 0) {
+        const double invTrees = 1.0 / trees;
+        for (double& v : importance) v *= invTrees;
     }
+    MPI_Bcast(&trees, 1, MPI_INT, 0, comm_);
+    if (trees == 0) return {};
     
-    return 0.0;
+    importance.resize(numFeatures);
+    MPI_Bcast(importance.data(), numFeatures, MPI_DOUBLE, 0, comm_);
+    return importance;
 }
 
 MPIBaggingTrainer::~MPIBaggingTrainer() {
@@ -0,0 +1,291 @@
+// =============================================================================
+// src/tree/ensemble/MPIDataLoader.cpp - MPI 分片并行加载与节点共享内存窗口
+// =============================================================================
+#include "ensemble/MPIDataLoader.hpp"
+#include "functions/io/DataIO.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace mpi_data {
+
+void bcastChunked(double* data, size_t count, int root, MPI_Comm comm, size_t chunkElements) {
+    for (size_t offset = 0; offset < count; offset += chunkElements) {
+        const size_t n = std::min(chunkElements, count - offset);
+        MPI_Bcast(data + offset, static_cast<int>(n), MPI_DOUBLE, root, comm);
+    }
+}
+
+void allreduceSumChunked(double* data, size_t count, MPI_Comm comm, size_t chunkElements) {
+    for (size_t offset = 0; offset < count; offset += chunkElements) {
+        const size_t n = std::min(chunkElements, count - offset);
+        MPI_Allreduce(MPI_IN_PLACE, data + offset, static_cast<int>(n), MPI_DOUBLE, MPI_SUM, comm);
+    }
+}
+
+namespace {
+
+// 分块变长收集的公共实现：root < 0 为全收集（Allgatherv），否则为 Gatherv
+template <typename T>
+void gathervRounds(const T* local, uint64_t localCount, MPI_Datatype type,
+                   std::vector<T>& global, std::vector<uint64_t>& counts,
+                   int root, MPI_Comm comm, size_t chunkElements) {
+    int size = 1;
+    int rank = 0;
+    MPI_Comm_size(comm, &size);
+    MPI_Comm_rank(comm, &rank);
+    const bool receives = root < 0 || root == rank;
+
+    // 各进程贡献长度以 64 位交换
+    counts.assign(size, 0);
+    MPI_Allgather(&localCount, 1, MPI_UINT64_T, counts.data(), 1, MPI_UINT64_T, comm);
+
+    std::vector<size_t> offsets(size + 1, 0);
+    for (int r = 0; r < size; ++r) offsets[r + 1] = offsets[r] + counts[r];
+    global.resize(receives ? offsets[size] : 0);
+
+    // 每轮的接收总量不超过 chunkElements，保证 int 计数与位移不溢出
+    const size_t perRank = std::max<size_t>(1, chunkElements / size);
+    const uint64_t maxCount = *std::max_element(counts.begin(), counts.end());
+    std::vector<int> roundCounts(size), roundDispls(size);
+    std::vector<T> roundBuf;
+
+    for (size_t start = 0; start < maxCount; start += perRank) {
+        int total = 0;
+        for (int r = 0; r < size; ++r) {
+            const size_t remaining = counts[r] > start ? counts[r] - start : 0;
+            roundCounts[r] = static_cast<int>(std::min(perRank, remaining));
+            roundDispls[r] = total;
+            total += roundCounts[r];
+        }
+        roundBuf.resize(receives ? total : 0);
+
+        const T* sendBuf = local + std::min<uint64_t>(start, localCount);
+        if (root < 0) {
+            MPI_Allgatherv(sendBuf, roundCounts[rank], type,
+                           roundBuf.data(), roundCounts.data(), roundDispls.data(), type, comm);
+        } else {
+            MPI_Gatherv(sendBuf, roundCounts[rank], type,
+                        roundBuf.data(), roundCounts.data(), roundDispls.data(), type, root, comm);
+        }
+        if (!receives) continue;
+
+        for (int r = 0; r < size; ++r) {
+            if (roundCounts[r] == 0) continue;
+            std::memcpy(global.data() + offsets[r] + start, roundBuf.data() + roundDispls[r],
+                        static_cast<size_t>(roundCounts[r]) * sizeof(T));
+        }
+    }
+}
+
+} // namespace
+
+void allgatherChunked(const std::vector<double>& local,
+                      std::vector<double>& global,
+                      MPI_Comm comm,
+                      size_t chunkElements) {
+    std::vector<uint64_t> counts;
+    gathervRounds(local.data(), local.size(), MPI_DOUBLE, global, counts, -1, comm, chunkElements);
+}
+
+void gatherBytesChunked(const void* local, size_t bytes,
+                        std::vector<char>& global,
+                        std::vector<uint64_t>& counts,
+                        int root, MPI_Comm comm,
+                        size_t chunkElements) {
+    gathervRounds(static_cast<const char*>(local), bytes, MPI_BYTE, global, counts, root, comm, chunkElements);
+}
+
+namespace {
+
+struct LocalShard {
+    std::vector<double> X;
+    std::vector<double> y;
+    int rowLength = 0;
+};
+
+// 读取本进程负责的分片，并校验各进程列数一致（集合调用）
+LocalShard readLocalShard(const std::string& spec, MPI_Comm comm) {
+    int size = 1;
+    int rank = 0;
+    MPI_Comm_size(comm, &size);
+    MPI_Comm_rank(comm, &rank);
+
+    const std::vector<std::string> paths = DataIO::expandPaths(spec);
+    if (paths.empty()) {
+        throw std::runtime_error("No input files match: " + spec);
+    }
+
+    // 本进程负责的分片
+    DataIO io;
+    int localRowLength = 0;
+    std::vector<double> localX, localY;
+    if (paths.size() == 1) {
+        std::tie(localX, localY) = io.readCSVShard(paths.front(), rank, size, localRowLength);
+    } else {
+        const size_t lo = paths.size() * rank / size;
+        const size_t hi = paths.size() * (rank + 1) / size;
+        // 列按首个文件的表头投影：各进程起始文件不同，但列顺序一致
+        DataIO::ColumnSelection selection;
+        std::ifstream first(paths.front());
+        std::string header;
+        std::getline(first, header);
+        if (!header.empty() && header.back() == '\r') header.pop_back();
+        selection.features = DataIO::splitList(header);
+        if (!selection.features.empty()) {
+            selection.label = selection.features.back();
+            selection.features.pop_back();
+        }
+        if (lo < hi) {
+            const std::vector<std::string> mine(paths.begin() + lo, paths.begin() + hi);
+            std::tie(localX, localY) = io.readCSVFiles(mine, localRowLength, selection);
+        }
+    }
+
+    // 列数以解析到数据行的进程为准；各进程必须一致
+    int rowLength = 0;
+    int minRowLength = 0;
+    const int reportedMin = localY.empty() ? INT32_MAX : localRowLength;
+    MPI_Allreduce(&localRowLength, &rowLength, 1, MPI_INT, MPI_MAX, comm);
+    MPI_Allreduce(&reportedMin, &minRowLength, 1, MPI_INT, MPI_MIN, comm);
+    if (rowLength <= 1 || minRowLength != rowLength) {
+        throw std::runtime_error("Inconsistent or empty shards while loading: " + spec);
+    }
+
+    LocalShard shard;
+    shard.X = std::move(localX);
+    shard.y = std::move(localY);
+    shard.rowLength = rowLength;
+    return shard;
+}
+
+} // namespace
+
+ShardedDataset loadSharded(const std::string& spec, MPI_Comm comm) {
+    const LocalShard shard = readLocalShard(spec, comm);
+
+    ShardedDataset out;
+    out.rowLength = shard.rowLength;
+    out.localRows = shard.y.size();
+    allgatherChunked(shard.X, out.X, comm);
+    allgatherChunked(shard.y, out.y, comm);
+    return out;
+}
+
+NodeSharedArray::NodeSharedArray(size_t count, MPI_Comm comm) : size_(count) {
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &nodeComm_);
+    int nodeRank = 0;
+    MPI_Comm_rank(nodeComm_, &nodeRank);
+
+    // 节点首进程分配整块，其余进程分配 0 字节后查询首进程的基址
+    const MPI_Aint bytes = nodeRank == 0 ? static_cast<MPI_Aint>(count * sizeof(double)) : 0;
+    void* local = nullptr;
+    MPI_Win_allocate_shared(bytes, sizeof(double), MPI_INFO_NULL, nodeComm_, &local, &win_);
+
+    MPI_Aint querySize = 0;
+    int dispUnit = 0;
+    void* base = nullptr;
+    MPI_Win_shared_query(win_, 0, &querySize, &dispUnit, &base);
+    base_ = static_cast<double*>(base);
+}
+
+NodeSharedArray::~NodeSharedArray() {
+    release();
+}
+
+NodeSharedArray::NodeSharedArray(NodeSharedArray&& other) noexcept
+    : win_(other.win_), nodeComm_(other.nodeComm_), base_(other.base_), size_(other.size_) {
+    other.win_ = MPI_WIN_NULL;
+    other.nodeComm_ = MPI_COMM_NULL;
+    other.base_ = nullptr;
+    other.size_ = 0;
+}
+
+NodeSharedArray& NodeSharedArray::operator=(NodeSharedArray&& other) noexcept {
+    if (this != &other) {
+        release();
+        std::swap(win_, other.win_);
+        std::swap(nodeComm_, other.nodeComm_);
+        std::swap(base_, other.base_);
+        std::swap(size_, other.size_);
+    }
+    return *this;
+}
+
+int NodeSharedArray::nodeRanks() const {
+    int ranks = 1;
+    if (nodeComm_ != MPI_COMM_NULL) MPI_Comm_size(nodeComm_, &ranks);
+    return ranks;
+}
+
+void NodeSharedArray::fence() {
+    if (win_ != MPI_WIN_NULL) MPI_Win_fence(0, win_);
+}
+
+void NodeSharedArray::release() {
+    if (win_ != MPI_WIN_NULL) MPI_Win_free(&win_);
+    if (nodeComm_ != MPI_COMM_NULL) MPI_Comm_free(&nodeComm_);
+    base_ = nullptr;
+    size_ = 0;
+}
+
+SharedDataset loadShardedShared(const std::string& spec, MPI_Comm comm) {
+    int size = 1;
+    int rank = 0;
+    MPI_Comm_size(comm, &size);
+    MPI_Comm_rank(comm, &rank);
+
+    LocalShard shard = readLocalShard(spec, comm);
+
+    // 各进程分片在全局矩阵中的位置
+    const uint64_t localCount = shard.X.size();
+    std::vector<uint64_t> counts(size);
+    MPI_Allgather(&localCount, 1, MPI_UINT64_T, counts.data(), 1, MPI_UINT64_T, comm);
+    std::vector<size_t> offsets(size + 1, 0);
+    for (int r = 0; r < size; ++r) offsets[r + 1] = offsets[r] + counts[r];
+
+    SharedDataset out;
+    out.rowLength = shard.rowLength;
+    out.localRows = shard.y.size();
+    out.X = NodeSharedArray(offsets[size], comm);
+
+    // 节点内：各进程把自己的分片写到窗口中的全局位置（互不重叠）
+    out.X.fence();
+    std::copy(shard.X.begin(), shard.X.end(), out.X.data() + offsets[rank]);
+    out.X.fence();
+    std::vector<double>().swap(shard.X);
+
+    // 节点间：各节点首进程组成通信域，依次广播每个进程的分片（由其所在节点的首进程发出）
+    int nodeRank = 0;
+    MPI_Comm_rank(out.X.nodeComm(), &nodeRank);
+    MPI_Comm leaderComm = MPI_COMM_NULL;
+    MPI_Comm_split(comm, nodeRank == 0 ? 0 : MPI_UNDEFINED, rank, &leaderComm);
+
+    int leaderRank = 0;
+    if (leaderComm != MPI_COMM_NULL) MPI_Comm_rank(leaderComm, &leaderRank);
+    MPI_Bcast(&leaderRank, 1, MPI_INT, 0, out.X.nodeComm());
+    std::vector<int> ownerLeader(size);
+    MPI_Allgather(&leaderRank, 1, MPI_INT, ownerLeader.data(), 1, MPI_INT, comm);
+
+    if (leaderComm != MPI_COMM_NULL) {
+        int numLeaders = 1;
+        MPI_Comm_size(leaderComm, &numLeaders);
+        if (numLeaders > 1) {
+            for (int r = 0; r < size; ++r) {
+                bcastChunked(out.X.data() + offsets[r], counts[r], ownerLeader[r], leaderComm);
+            }
+        }
+        MPI_Comm_free(&leaderComm);
+    }
+    out.X.fence();
+
+    allgatherChunked(shard.y, out.y, comm);
+    return out;
+}
+
+} // namespace mpi_data
@@ -1,5 +1,6 @@
 // AdaptiveEQFinder.cpp
 #include "finder/AdaptiveEQFinder.hpp"
+#include "histogram/QuantileSketch.hpp"
 
 #include <algorithm>
 #include <cmath>
@@ -37,7 +38,7 @@ AdaptiveEQFinder::calculateOptimalFrequencyParams(const std::vector<double>& v)
 
 /*=== findBestSplit =======================================================*/
 std::tuple<int,double,double>
-AdaptiveEQFinder::findBestSplit(const std::vector<double>& data,
+AdaptiveEQFinder::findBestSplit(ConstSpan<double> data,
                                 int                       rowLen,
                                 const std::vector<double>&labels,
                                 const std::vector<int>&   idx,
@@ -53,11 +54,15 @@ AdaptiveEQFinder::findBestSplit(const std::vector<double>& data,
     double bestThr  = 0.0;
     double bestGain = -std::numeric_limits<double>::infinity();
 
+    // 候选特征（随机森林模式下为每节点子采样）
+    const std::vector<int> features = candidateFeatures(rowLen, idx);
+    const int numCandidates = static_cast<int>(features.size());
     const double EPS = 1e-12;
 
     // 并行遍历每个特征 f
     #pragma omp parallel for schedule(dynamic)
-    for (int f = 0; f < rowLen; ++f) {
+    for (int c = 0; c < numCandidates; ++c) {
+        const int f = features[c];
         // 每个线程维护自己的局部最优
         double localBestGain = -std::numeric_limits<double>::infinity();
         double localBestThr  = 0.0;
@@ -73,26 +78,47 @@ AdaptiveEQFinder::findBestSplit(const std::vector<double>& data,
         const auto [bins, perBin] = calculateOptimalFrequencyParams(values);
         if (N < static_cast<size_t>(2 * perBin)) continue;  // 样本太少，跳过此特征
 
-        // 3. 对索引进行排序，得到 sortedIdx
-        std::vector<int> sortedIdx = idx;  // 直接拷贝
-        std::sort(sortedIdx.begin(), sortedIdx.end(),
-                  [&](int a, int b) {
-                      return data[a * rowLen + f] < data[b * rowLen + f];
-                  });
-
-        // 4. 枚举等频分割点
-        for (size_t pivot = perBin; pivot <= N - perBin; pivot += perBin) {
-            double vL = data[sortedIdx[pivot - 1] * rowLen + f];
-            double vR = data[sortedIdx[pivot]     * rowLen + f];
-            if (std::fabs(vR - vL) < EPS) 
+        // 3. 分位数摘要给出等频切点（每 perBin 个样本一个），无需对索引排序
+        const QuantileSketch sketch = QuantileSketch::build(values.data(), values.size());
+        const std::vector<double> cuts = sketch.cutPoints(static_cast<int>(N / perBin));
+
+        // 4. 按桶计数排序索引（O(N)），每个切点的左子节点即为前缀
+        const size_t B = cuts.size() + 1;
+        std::vector<int> binOf(N);
+        std::vector<size_t> binStart(B + 1, 0);
+        std::vector<double> binMin(B, std::numeric_limits<double>::infinity());
+        std::vector<double> binMax(B, -std::numeric_limits<double>::infinity());
+        for (size_t k = 0; k < N; ++k) {
+            const double v = values[k];
+            const int b = static_cast<int>(std::lower_bound(cuts.begin(), cuts.end(), v) - cuts.begin());
+            binOf[k] = b;
+            ++binStart[b + 1];
+            binMin[b] = std::min(binMin[b], v);
+            binMax[b] = std::max(binMax[b], v);
+        }
+        for (size_t b = 0; b < B; ++b) binStart[b + 1] += binStart[b];
+        std::vector<int> grouped(N);
+        {
+            std::vector<size_t> pos(binStart.begin(), binStart.end() - 1);
+            for (size_t k = 0; k < N; ++k) grouped[pos[binOf[k]]++] = idx[k];
+        }
+        std::vector<double> suffixMin(B + 1, std::numeric_limits<double>::infinity());
+        for (size_t b = B; b-- > 0;) suffixMin[b] = std::min(suffixMin[b + 1], binMin[b]);
+
+        // 5. 枚举等频切点：左侧为 value <= cut
+        std::vector<int> leftBuf, rightBuf;
+        leftBuf.reserve(N);
+        rightBuf.reserve(N);
+        double vL = -std::numeric_limits<double>::infinity();
+        for (size_t b = 0; b + 1 < B; ++b) {
+            vL = std::max(vL, binMax[b]);
+            const double vR = suffixMin[b + 1];
+            const size_t pivot = binStart[b + 1];
+            if (pivot == 0 || pivot == N || std::fabs(vR - vL) < EPS)
                 continue;  // 相同值无效
 
-            // 分配到左右子节点索引缓冲区
-            std::vector<int> leftBuf, rightBuf;
-            leftBuf.reserve(pivot);
-            rightBuf.reserve(N - pivot);
-            leftBuf.assign(sortedIdx.begin(),          sortedIdx.begin() + pivot);
-            rightBuf.assign(sortedIdx.begin() + pivot, sortedIdx.end());
+            leftBuf.assign(grouped.begin(),          grouped.begin() + pivot);
+            rightBuf.assign(grouped.begin() + pivot, grouped.end());
 
             // 保证每个子节点样本数 >= minSamplesPerBin_
             if (leftBuf.size() < static_cast<size_t>(minSamplesPerBin_) ||
@@ -16,18 +16,6 @@
 #include <omp.h>
 #endif
 
-// 自适应等宽直方图管理器
-static thread_local std::unique_ptr<PrecomputedHistograms> g_adaptiveEWManager = nullptr;
-static thread_local bool g_adaptiveEWInitialized = false;
-
-static PrecomputedHistograms* getAdaptiveEWManager(int numFeatures) {
-    if (!g_adaptiveEWInitialized) {
-        g_adaptiveEWManager = std::make_unique<PrecomputedHistograms>(numFeatures);
-        g_adaptiveEWInitialized = true;
-    }
-    return g_adaptiveEWManager.get();
-}
-
 // **优化的工具函数**
 static double calculateIQRFast(std::vector<double>& values) {
     if (values.size() < 4) return 0.0;
@@ -47,7 +35,7 @@ static double calculateIQRFast(std::vector<double>& values) {
 }
 
 std::tuple<int, double, double>
-AdaptiveEWFinder::findBestSplit(const std::vector<double>& data,
+AdaptiveEWFinder::findBestSplit(ConstSpan<double> data,
                                 int                       rowLen,
                                 const std::vector<double>&labels,
                                 const std::vector<int>&   idx,
@@ -58,24 +46,11 @@ AdaptiveEWFinder::findBestSplit(const std::vector<double>& data,
     if (N < 2) return {-1, 0.0, 0.0};
 
     // **核心优化1: 使用自适应等宽预计算直方图**
-    PrecomputedHistograms* histManager = getAdaptiveEWManager(rowLen);
-    
-    static thread_local bool isFirstCall = true;
-    if (isFirstCall) {
-        std::vector<int> allIndices(labels.size());
-        std::iota(allIndices.begin(), allIndices.end(), 0);
-        
-        // **优化2: 预计算自适应等宽直方图**
-        histManager->precompute(data, rowLen, labels, allIndices, "adaptive_ew", 0);
-        isFirstCall = false;
-        
-        std::cout << "AdaptiveEW: Precomputed adaptive equal-width histograms for " 
-                  << rowLen << " features" << std::endl;
-    }
+    const auto histManager = histograms_.get(data, rowLen, labels, trainingRows_, "adaptive_ew", 0);
     
     // **优化3: 快速自适应分裂查找**
     auto [bestFeat, bestThr, bestGain] = histManager->findBestSplitFast(
-        data, rowLen, labels, idx, parentMetric);
+        data, rowLen, labels, idx, parentMetric, candidateFeatures(rowLen, idx));
     
     // 备选优化方法
     if (bestFeat < 0) {
@@ -87,7 +62,7 @@ AdaptiveEWFinder::findBestSplit(const std::vector<double>& data,
 
 // **优化的自适应等宽方法**
 std::tuple<int, double, double>
-AdaptiveEWFinder::findBestSplitAdaptiveEWOptimized(const std::vector<double>& data,
+AdaptiveEWFinder::findBestSplitAdaptiveEWOptimized(ConstSpan<double> data,
                                                    int rowLen,
                                                    const std::vector<double>& labels,
                                                    const std::vector<int>& idx,
@@ -101,6 +76,8 @@ AdaptiveEWFinder::findBestSplitAdaptiveEWOptimized(const std::vector<double>& da
 
     const double EPS = 1e-12;
 
+    const std::vector<int> features = candidateFeatures(rowLen, idx);
+    const int numCandidates = static_cast<int>(features.size());
     // **优化4: 智能并行策略**
     const bool useParallel = (N > 1000 && rowLen > 4);
 
@@ -121,7 +98,8 @@ AdaptiveEWFinder::findBestSplitAdaptiveEWOptimized(const std::vector<double>& da
             rightBuf.reserve(N);
 
             #pragma omp for schedule(dynamic) nowait
-            for (int f = 0; f < rowLen; ++f) {
+            for (int c = 0; c < numCandidates; ++c) {
+                const int f = features[c];
                 // **优化6: 单次遍历收集特征值**
                 values.clear();
                 for (int i : idx) {
@@ -213,7 +191,8 @@ AdaptiveEWFinder::findBestSplitAdaptiveEWOptimized(const std::vector<double>& da
         values.reserve(N);
         buckets.reserve(128);
 
-        for (int f = 0; f < rowLen; ++f) {
+        for (int c = 0; c < numCandidates; ++c) {
+            const int f = features[c];
             values.clear();
             for (int i : idx) {
                 values.emplace_back(data[i * rowLen + f]);
@@ -10,7 +10,7 @@
 #endif
 
 std::tuple<int, double, double>
-ExhaustiveSplitFinder::findBestSplit(const std::vector<double>& data,
+ExhaustiveSplitFinder::findBestSplit(ConstSpan<double> data,
                                      int                       rowLength,
                                      const std::vector<double>& labels,
                                      const std::vector<int>&    indices,
@@ -20,33 +20,26 @@ ExhaustiveSplitFinder::findBestSplit(const std::vector<double>& data,
     const size_t N = indices.size();
     if (N < 2) return {-1, 0.0, 0.0};
 
-    /* ---------- 并行计算父节点统计信息 ---------- */
+    /* ---------- 父节点统计信息 ---------- */
+    // 串行按行序累加：O(N) 远小于各特征排序的开销，且结果与线程数无关
     double totalSum   = 0.0;
     double totalSumSq = 0.0;
-    
-    // 根据数据大小选择是否使用并行
-    bool useParallel = N > 1000;
-    
-    if (useParallel) {
-        #pragma omp parallel for reduction(+:totalSum,totalSumSq) schedule(static)
-        for (size_t i = 0; i < N; ++i) {
-            const double y = labels[indices[i]];
-            totalSum   += y;
-            totalSumSq += y * y;
-        }
-    } else {
-        // 小数据集使用串行计算
-        for (size_t i = 0; i < N; ++i) {
-            const double y = labels[indices[i]];
-            totalSum   += y;
-            totalSumSq += y * y;
-        }
+    for (size_t i = 0; i < N; ++i) {
+        const double y = labels[indices[i]];
+        totalSum   += y;
+        totalSumSq += y * y;
     }
     
+    // 根据数据大小选择是否并行搜索特征
+    const bool useParallel = N > 1000;
+    
     const double parentMean = totalSum / static_cast<double>(N);
     const double parentMSE  = totalSumSq / static_cast<double>(N) - parentMean * parentMean;
 
     /* ---------- 智能并行特征搜索 ---------- */
+    // 候选特征（随机森林模式下为每节点子采样）
+    const std::vector<int> features = candidateFeatures(rowLength, indices);
+    const int numCandidates = static_cast<int>(features.size());
     int    globalBestFeat = -1;
     double globalBestThr  = 0.0;
     double globalBestGain = 0.0;
@@ -54,18 +47,21 @@ ExhaustiveSplitFinder::findBestSplit(const std::vector<double>& data,
 
     if (useParallel) {
         // 并行版本 - 中大型数据集
+        // 各候选特征的局部最优写入自己的槽位，区域结束后按候选顺序归约：
+        // 增益相同时总是选靠前的特征，与串行版本一致、与线程调度无关
+        std::vector<double> bestGainPerFeature(numCandidates, 0.0);
+        std::vector<double> bestThrPerFeature(numCandidates, 0.0);
+
         #pragma omp parallel
         {
-            // 线程局部变量
-            int    localBestFeat = -1;
-            double localBestThr  = 0.0;
-            double localBestGain = 0.0;
-            
             // 线程局部缓冲区（避免重复分配）
             std::vector<int> localSortedIdx(N);
             
-            #pragma omp for schedule(dynamic) nowait
-            for (int f = 0; f < rowLength; ++f) {
+            #pragma omp for schedule(dynamic)
+            for (int c = 0; c < numCandidates; ++c) {
+                const int f = features[c];
+                double localBestGain = 0.0;
+                double localBestThr  = 0.0;
                 /* --- 拷贝当前索引并按特征值排序 --- */
                 std::copy(indices.begin(), indices.end(), localSortedIdx.begin());
                 std::sort(localSortedIdx.begin(), localSortedIdx.end(),
@@ -109,28 +105,29 @@ ExhaustiveSplitFinder::findBestSplit(const std::vector<double>& data,
 
                         if (gain > localBestGain) {
                             localBestGain = gain;
-                            localBestFeat = f;
                             localBestThr  = 0.5 * (currentVal + nextVal);
                         }
                     }
                 }
+                bestGainPerFeature[c] = localBestGain;
+                bestThrPerFeature[c]  = localBestThr;
             }
-            
-            /* --- 线程间归约：更新全局最佳结果 --- */
-            #pragma omp critical
-            {
-                if (localBestGain > globalBestGain) {
-                    globalBestGain = localBestGain;
-                    globalBestFeat = localBestFeat;
-                    globalBestThr  = localBestThr;
-                }
+        }
+        
+        /* --- 按候选顺序归约全局最佳结果 --- */
+        for (int c = 0; c < numCandidates; ++c) {
+            if (bestGainPerFeature[c] > globalBestGain) {
+                globalBestGain = bestGainPerFeature[c];
+                globalBestFeat = features[c];
+                globalBestThr  = bestThrPerFeature[c];
             }
         }
     } else {
         // 串行版本 - 小数据集
         std::vector<int> sortedIdx(N);
         
-        for (int f = 0; f < rowLength; ++f) {
+        for (int c = 0; c < numCandidates; ++c) {
+            const int f = features[c];
             /* --- 拷贝当前索引并按特征值排序 --- */
             std::copy(indices.begin(), indices.end(), sortedIdx.begin());
             std::sort(sortedIdx.begin(), sortedIdx.end(),
@@ -183,4 +180,112 @@ ExhaustiveSplitFinder::findBestSplit(const std::vector<double>& data,
     }
 
     return {globalBestFeat, globalBestThr, globalBestGain};
-}
\ No newline at end of file
+}
+
+/* ---------- 加权版本：左右子集统计量按样本权重累积 ---------- */
+std::tuple<int, double, double>
+ExhaustiveSplitFinder::findBestSplitWeighted(ConstSpan<double> data,
+                                             int                       rowLength,
+                                             const std::vector<double>& labels,
+                                             const std::vector<double>& weights,
+                                             const std::vector<int>&    indices,
+                                             double /*currentMetric*/,
+                                             const ISplitCriterion&     /*criterion*/) const
+{
+    const size_t N = indices.size();
+    if (N < 2) return {-1, 0.0, 0.0};
+
+    double totalW     = 0.0;
+    double totalSum   = 0.0;
+    double totalSumSq = 0.0;
+
+    // 串行累加，结果与线程数无关（同无权版本）
+    for (size_t i = 0; i < N; ++i) {
+        const int    idx = indices[i];
+        const double w   = weights[idx];
+        const double y   = labels[idx];
+        totalW     += w;
+        totalSum   += w * y;
+        totalSumSq += w * y * y;
+    }
+    if (totalW <= 0.0) return {-1, 0.0, 0.0};
+
+    const std::vector<int> features = candidateFeatures(rowLength, indices);
+    const int numCandidates = static_cast<int>(features.size());
+
+    const double parentMean = totalSum / totalW;
+    const double parentMSE  = totalSumSq / totalW - parentMean * parentMean;
+
+    int    globalBestFeat = -1;
+    double globalBestThr  = 0.0;
+    double globalBestGain = 0.0;
+    constexpr double EPS = 1e-12;
+
+    // 与无权版本相同：逐候选记录局部最优，再按候选顺序归约
+    std::vector<double> bestGainPerFeature(numCandidates, 0.0);
+    std::vector<double> bestThrPerFeature(numCandidates, 0.0);
+
+    #pragma omp parallel if(N > 1000)
+    {
+        std::vector<int> localSortedIdx(N);
+
+        #pragma omp for schedule(dynamic)
+        for (int c = 0; c < numCandidates; ++c) {
+            const int f = features[c];
+            double localBestGain = 0.0;
+            double localBestThr  = 0.0;
+            std::copy(indices.begin(), indices.end(), localSortedIdx.begin());
+            std::sort(localSortedIdx.begin(), localSortedIdx.end(),
+                      [&](int a, int b) {
+                          return data[a * rowLength + f] < data[b * rowLength + f];
+                      });
+
+            double leftW     = 0.0;
+            double leftSum   = 0.0;
+            double leftSumSq = 0.0;
+
+            for (size_t i = 0; i < N - 1; ++i) {
+                const int    idx = localSortedIdx[i];
+                const double w   = weights[idx];
+                const double y   = labels[idx];
+                leftW     += w;
+                leftSum   += w * y;
+                leftSumSq += w * y * y;
+
+                const double currentVal = data[idx * rowLength + f];
+                const double nextVal    = data[localSortedIdx[i + 1] * rowLength + f];
+                if (!(currentVal + EPS < nextVal)) continue;
+
+                const double rightW = totalW - leftW;
+                if (leftW <= 0.0 || rightW <= 0.0) continue;
+
+                const double rightSum   = totalSum   - leftSum;
+                const double rightSumSq = totalSumSq - leftSumSq;
+
+                const double leftMean  = leftSum  / leftW;
+                const double rightMean = rightSum / rightW;
+                const double leftMSE   = leftSumSq  / leftW  - leftMean  * leftMean;
+                const double rightMSE  = rightSumSq / rightW - rightMean * rightMean;
+
+                const double gain = parentMSE - (leftMSE * leftW + rightMSE * rightW) / totalW;
+
+                if (gain > localBestGain) {
+                    localBestGain = gain;
+                    localBestThr  = 0.5 * (currentVal + nextVal);
+                }
+            }
+            bestGainPerFeature[c] = localBestGain;
+            bestThrPerFeature[c]  = localBestThr;
+        }
+    }
+
+    for (int c = 0; c < numCandidates; ++c) {
+        if (bestGainPerFeature[c] > globalBestGain) {
+            globalBestGain = bestGainPerFeature[c];
+            globalBestFeat = features[c];
+            globalBestThr  = bestThrPerFeature[c];
+        }
+    }
+
+    return {globalBestFeat, globalBestThr, globalBestGain};
+}
@@ -6,7 +6,7 @@
 // 添加传统优化方法的声明到头文件中
 // 在HistogramEWFinder类中添加：
 // std::tuple<int, double, double> findBestSplitTraditionalOptimized(
-//     const std::vector<double>& X, int D, const std::vector<double>& y,
+//     ConstSpan<double> X, int D, const std::vector<double>& y,
 //     const std::vector<int>& idx, double parentMetric, const ISplitCriterion& crit) const;
 #include "histogram/PrecomputedHistograms.hpp"
 #include <algorithm>
@@ -22,21 +22,8 @@
 #include <omp.h>
 #endif
 
-// 静态全局直方图管理器（线程安全的单例模式）
-static thread_local std::unique_ptr<PrecomputedHistograms> g_histogramManager = nullptr;
-static thread_local bool g_histogramInitialized = false;
-
-// 直方图管理器访问函数
-static PrecomputedHistograms* getHistogramManager(int numFeatures) {
-    if (!g_histogramInitialized) {
-        g_histogramManager = std::make_unique<PrecomputedHistograms>(numFeatures);
-        g_histogramInitialized = true;
-    }
-    return g_histogramManager.get();
-}
-
 std::tuple<int, double, double>
-HistogramEWFinder::findBestSplit(const std::vector<double>& X,
+HistogramEWFinder::findBestSplit(ConstSpan<double> X,
                                  int                        D,
                                  const std::vector<double>& y,
                                  const std::vector<int>&    idx,
@@ -45,27 +32,12 @@ HistogramEWFinder::findBestSplit(const std::vector<double>& X,
     
     if (idx.size() < 2) return {-1, 0.0, 0.0};
 
-    // **核心优化1: 使用预计算直方图管理器**
-    PrecomputedHistograms* histManager = getHistogramManager(D);
-    
-    // **优化2: 首次调用时预计算所有直方图**
-    static thread_local bool isFirstCall = true;
-    if (isFirstCall) {
-        // 创建全数据集索引用于预计算
-        std::vector<int> allIndices(y.size());
-        std::iota(allIndices.begin(), allIndices.end(), 0);
-        
-        // 一次性预计算所有特征的等宽直方图
-        histManager->precompute(X, D, y, allIndices, "equal_width", bins_);
-        isFirstCall = false;
-        
-        std::cout << "HistogramEW: Precomputed histograms for " << D 
-                  << " features with " << bins_ << " bins" << std::endl;
-    }
+    // **核心优化1: 使用预计算直方图（数据或训练行变化时重新预计算）**
+    const auto histManager = histograms_.get(X, D, y, trainingRows_, "equal_width", bins_);
     
     // **优化3: 使用快速分裂查找，避免重新计算直方图**
     auto [bestFeat, bestThr, bestGain] = histManager->findBestSplitFast(
-        X, D, y, idx, parentMetric);
+        X, D, y, idx, parentMetric, candidateFeatures(D, idx));
     
     // 如果快速查找失败，回退到传统方法（但仍然优化）
     if (bestFeat < 0) {
@@ -75,9 +47,25 @@ HistogramEWFinder::findBestSplit(const std::vector<double>& X,
     return {bestFeat, bestThr, bestGain};
 }
 
+// **加权分裂查找**: 直方图桶内累积 w·g、w·g² 与 Σw
+std::tuple<int, double, double>
+HistogramEWFinder::findBestSplitWeighted(ConstSpan<double> X,
+                                         int                        D,
+                                         const std::vector<double>& y,
+                                         const std::vector<double>& w,
+                                         const std::vector<int>&    idx,
+                                         double                     parentMetric,
+                                         const ISplitCriterion&     /* crit */) const {
+    
+    if (idx.size() < 2) return {-1, 0.0, 0.0};
+
+    const auto histManager = histograms_.get(X, D, y, trainingRows_, "equal_width", bins_);
+    return histManager->findBestSplitFast(X, D, y, idx, parentMetric, candidateFeatures(D, idx), &w);
+}
+
 // **优化的传统方法**: 保留作为备选，但仍进行了优化
 std::tuple<int, double, double>
-HistogramEWFinder::findBestSplitTraditionalOptimized(const std::vector<double>& X,
+HistogramEWFinder::findBestSplitTraditionalOptimized(ConstSpan<double> X,
                                                      int D,
                                                      const std::vector<double>& y,
                                                      const std::vector<int>& idx,
@@ -91,6 +79,8 @@ HistogramEWFinder::findBestSplitTraditionalOptimized(const std::vector<double>&
 
     const double EPS = 1e-12;
 
+    const std::vector<int> features = candidateFeatures(D, idx);
+    const int numCandidates = static_cast<int>(features.size());
     // **优化4: 智能并行策略 - 减少线程创建开销**
     const bool useParallel = (N > 1000 && D > 4);
     
@@ -111,7 +101,8 @@ HistogramEWFinder::findBestSplitTraditionalOptimized(const std::vector<double>&
             std::vector<double> prefixSumSq(bins_);
 
             #pragma omp for schedule(dynamic) nowait
-            for (int f = 0; f < D; ++f) {
+            for (int c = 0; c < numCandidates; ++c) {
+                const int f = features[c];
                 // **优化6: 快速特征范围计算（避免多次遍历）**
                 double vMin = std::numeric_limits<double>::infinity();
                 double vMax = -vMin;
@@ -199,7 +190,8 @@ HistogramEWFinder::findBestSplitTraditionalOptimized(const std::vector<double>&
         std::vector<double> histSum(bins_);
         std::vector<double> histSumSq(bins_);
         
-        for (int f = 0; f < D; ++f) {
+        for (int c = 0; c < numCandidates; ++c) {
+            const int f = features[c];
             // 计算特征范围
             auto [minIt, maxIt] = std::minmax_element(idx.begin(), idx.end(),
                 [&](int a, int b) { return X[a * D + f] < X[b * D + f]; });
@@ -8,7 +8,7 @@
 #include <omp.h>   // 新增 OpenMP 头文件
 
 std::tuple<int, double, double>
-QuartileSplitFinder::findBestSplit(const std::vector<double>& X,   // 特征矩阵 (行优先)
+QuartileSplitFinder::findBestSplit(ConstSpan<double> X,   // 特征矩阵 (行优先)
                                    int                        D,   // 每行特征数
                                    const std::vector<double>& y,   // 标签
                                    const std::vector<int>&    idx, // 当前样本索引
@@ -24,9 +24,12 @@ QuartileSplitFinder::findBestSplit(const std::vector<double>& X,   // 特征矩
     const size_t N = idx.size();
     const double EPS = 1e-12;
 
+    const std::vector<int> features = candidateFeatures(D, idx);
+    const int numCandidates = static_cast<int>(features.size());
     /* 并行遍历每个特征 f */
     #pragma omp parallel for schedule(dynamic)
-    for (int f = 0; f < D; ++f) {
+    for (int c = 0; c < numCandidates; ++c) {
+        const int f = features[c];
         // 每个线程维护自己的局部最优
         double localBestGain = -std::numeric_limits<double>::infinity();
         double localBestThr  = 0.0;
@@ -1,7 +1,6 @@
 // src/tree/finder/RandomSplitFinder.cpp
 #include "finder/RandomSplitFinder.hpp"
 #include <limits>
-#include <random>
 #include <vector>
 #include <algorithm>
 #include <cmath>
@@ -10,7 +9,7 @@
 #endif
 
 std::tuple<int, double, double>
-RandomSplitFinder::findBestSplit(const std::vector<double>& X,
+RandomSplitFinder::findBestSplit(ConstSpan<double> X,
                                  int                          D,
                                  const std::vector<double>&   y,
                                  const std::vector<int>&      idx,
@@ -30,29 +29,18 @@ RandomSplitFinder::findBestSplit(const std::vector<double>& X,
     double globalBestThr   = 0.0;
     double globalBestGain  = -std::numeric_limits<double>::infinity();
 
-    // 用于并行时，给每个线程准备一个种子
-    int maxThreads = 1;
-#ifdef _OPENMP
-    maxThreads = omp_get_max_threads();
-#endif
-    std::vector<uint32_t> threadSeeds(maxThreads);
-    {
-        // 先序列化地为每个线程生成不同 seed
-        std::mt19937 seedGen(gen_());
-        std::uniform_int_distribution<uint32_t> seedDist(0, 0xFFFFFFFF);
-        for (int t = 0; t < maxThreads; ++t) {
-            threadSeeds[t] = seedDist(seedGen);
-        }
-    }
+    const std::vector<int> features = candidateFeatures(D, idx);
+    const int numCandidates = static_cast<int>(features.size());
+    const uint64_t nodeKey = Philox::nodeKey(idx);
 
-    // 并行时，每个线程保存自己找到的局部最优 (feat, thr, gain)
-    std::vector<int>    bestFeatPerThread(maxThreads, -1);
-    std::vector<double> bestThrPerThread(maxThreads, 0.0);
-    std::vector<double> bestGainPerThread(maxThreads,
-                                          -std::numeric_limits<double>::infinity());
+    // 每个候选特征各存一份局部最优，按特征顺序归约：平分时的取舍与线程调度无关
+    std::vector<double> bestThrPerFeature(numCandidates, 0.0);
+    std::vector<double> bestGainPerFeature(numCandidates,
+                                           -std::numeric_limits<double>::infinity());
 
     // 包装一个函数：在单线程或并行内部调用的，计算某个特征 f 上的最优随机切分
-    auto processFeature = [&](int f, int tid) {
+    auto processFeature = [&](int c) {
+        const int f = features[c];
         // 1) 提取该特征在所有节点样本中的值 (values)，以及对应的 y 标签 (labels_f)
         static thread_local std::vector<std::pair<double,double>> vals; 
         vals.clear();
@@ -83,8 +71,7 @@ RandomSplitFinder::findBestSplit(const std::vector<double>& X,
         }
 
         // 4) 根据 parentMetric（父节点的 MSE），进行 k_ 次随机阈值尝试
-        std::mt19937 localGen(threadSeeds[tid]);
-        std::uniform_real_distribution<double> uni01(0.0, 1.0);
+        Philox rng(seed_, {Philox::RandomSplit, nodeKey, static_cast<uint64_t>(f)});
 
         double vMin = sortedX.front();
         double vMax = sortedX.back();
@@ -96,7 +83,7 @@ RandomSplitFinder::findBestSplit(const std::vector<double>& X,
         double localBestThr  = 0.0;
 
         for (int r = 0; r < k_; ++r) {
-            double thr = vMin + uni01(localGen) * (vMax - vMin);
+            double thr = vMin + rng.uniform() * (vMax - vMin);
             // 二分查找阈值在 sortedX 中的位置 pos（第一个 > thr）
             int pos = int(std::upper_bound(sortedX.begin(), sortedX.end(), thr) - sortedX.begin());
             if (pos == 0 || pos == nIdx) {
@@ -130,41 +117,29 @@ RandomSplitFinder::findBestSplit(const std::vector<double>& X,
             }
         }
 
-        // 更新线程局部变量：feature 索引记在 bestFeatPerThread
-        if (localBestGain > bestGainPerThread[tid]) {
-            bestGainPerThread[tid] = localBestGain;
-            bestFeatPerThread[tid] = f;
-            bestThrPerThread[tid]  = localBestThr;
-        }
+        bestGainPerFeature[c] = localBestGain;
+        bestThrPerFeature[c]  = localBestThr;
     };
 
     // **并行或串行遍历特征**
     if (useParallel) {
-        #pragma omp parallel
-        {
-            int tid = 0;
-#ifdef _OPENMP
-            tid = omp_get_thread_num();
-#endif
-            #pragma omp for schedule(dynamic)
-            for (int f = 0; f < D; ++f) {
-                processFeature(f, tid);
-            }
+        #pragma omp parallel for schedule(dynamic)
+        for (int c = 0; c < numCandidates; ++c) {
+            processFeature(c);
         }
     } else {
         // 串行遍历所有特征
-        for (int f = 0; f < D; ++f) {
-            processFeature(f, /*tid=*/0);
+        for (int c = 0; c < numCandidates; ++c) {
+            processFeature(c);
         }
     }
 
-    // **归约所有线程的局部最优**
-    for (int t = 0; t < maxThreads; ++t) {
-        double gain = bestGainPerThread[t];
-        if (gain > globalBestGain) {
-            globalBestGain  = gain;
-            globalBestFeat  = bestFeatPerThread[t];
-            globalBestThr   = bestThrPerThread[t];
+    // **按特征顺序归约局部最优**
+    for (int c = 0; c < numCandidates; ++c) {
+        if (bestGainPerFeature[c] > globalBestGain) {
+            globalBestGain = bestGainPerFeature[c];
+            globalBestFeat = features[c];
+            globalBestThr  = bestThrPerFeature[c];
         }
     }
 
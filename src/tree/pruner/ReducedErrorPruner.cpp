@@ -3,17 +3,18 @@
 
 double ReducedErrorPruner::validate(Node* n) const {
     double mse = 0.0;
-    for (size_t i = 0; i < yv_.size(); ++i) {
-        const double* sample = &Xv_[i * D_];
+    const size_t count = val_.size();
+    for (size_t i = 0; i < count; ++i) {
+        const double* sample = val_.sample(i);
         Node* cur = n;
         while (!cur->isLeaf) {
             cur = (sample[cur->getFeatureIndex()] <= cur->getThreshold())
                     ? cur->getLeft() : cur->getRight();
         }
-        double diff = yv_[i] - cur->getPrediction();
+        double diff = val_.label(i) - cur->getPrediction();
         mse += diff * diff;
     }
-    return mse / yv_.size();
+    return mse / count;
 }
 
 void ReducedErrorPruner::pruneRec(std::unique_ptr<Node>& n) const {
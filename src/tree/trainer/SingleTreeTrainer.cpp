@@ -86,6 +86,28 @@ void SingleTreeTrainer::train(const std::vector<double>& data,
                               int rowLength,
                               const std::vector<double>& labels) {
     
+    // 预分配索引数组
+    std::vector<int> rootIndices(labels.size());
+    std::iota(rootIndices.begin(), rootIndices.end(), 0);
+    trainFromRoot(data, rowLength, labels, std::move(rootIndices));
+}
+
+// **数据视图训练**：根节点直接持有视图行号，在共享矩阵上建树，不拷贝特征
+void SingleTreeTrainer::trainOnView(const DatasetView& view) {
+    if (view.coversAll()) {
+        train(view.data(), view.numFeatures(), view.labels());
+        return;
+    }
+    auto rows = std::make_shared<const std::vector<int>>(view.rowIndices());
+    finder_->setTrainingRows(rows);
+    trainFromRoot(view.features(), view.numFeatures(), view.labels(), std::vector<int>(*rows));
+    finder_->setTrainingRows(nullptr);
+}
+
+void SingleTreeTrainer::trainFromRoot(ConstSpan<double> data,
+                                      int rowLength,
+                                      const std::vector<double>& labels,
+                                      std::vector<int>&& rootIndices) {
     auto trainStart = std::chrono::high_resolution_clock::now();
     
     root_ = std::make_unique<Node>();
@@ -97,12 +119,8 @@ void SingleTreeTrainer::train(const std::vector<double>& data,
     std::cout << "Using " << numThreads << " OpenMP threads (controlled by OMP_NUM_THREADS)" << std::endl;
     #endif
     
-    // 预分配索引数组
-    std::vector<int> rootIndices(labels.size());
-    std::iota(rootIndices.begin(), rootIndices.end(), 0);
-    
     // **教授建议的任务队列/线程池模式**
-    const bool useTaskQueue = (labels.size() > 1000 && numThreads > 1);
+    const bool useTaskQueue = (rootIndices.size() > 1000 && numThreads > 1);
     
     if (useTaskQueue) {
         std::cout << "Large dataset detected, using task queue strategy" << std::endl;
@@ -136,7 +154,7 @@ void SingleTreeTrainer::train(const std::vector<double>& data,
 }
 
 // **新方法：任务队列驱动的树构建**
-void SingleTreeTrainer::buildTreeWithTaskQueue(const std::vector<double>& data,
+void SingleTreeTrainer::buildTreeWithTaskQueue(ConstSpan<double> data,
                                                int rowLength,
                                                const std::vector<double>& labels,
                                                std::vector<int>&& rootIndices) {
@@ -179,7 +197,7 @@ void SingleTreeTrainer::buildTreeWithTaskQueue(const std::vector<double>& data,
 }
 
 // **任务处理方法**
-void SingleTreeTrainer::processTask(const std::vector<double>& data,
+void SingleTreeTrainer::processTask(ConstSpan<double> data,
                                     int rowLength,
                                     const std::vector<double>& labels,
                                     std::unique_ptr<SplitTask> task,
@@ -275,7 +293,7 @@ void SingleTreeTrainer::processTask(const std::vector<double>& data,
 
 // **优化的节点分裂（保留用于小数据集）**
 void SingleTreeTrainer::splitNodeOptimized(Node* node,
-                                           const std::vector<double>& data,
+                                           ConstSpan<double> data,
                                            int rowLength,
                                            const std::vector<double>& labels,
                                            std::vector<int>& indices,
@@ -288,20 +306,11 @@ void SingleTreeTrainer::splitNodeOptimized(Node* node,
     node->metric = criterion_->nodeMetric(labels, indices);
     node->samples = indices.size();
     
-    // **高效计算节点预测值**
+    // **节点预测值**：按行序串行累加，与任务队列路径逐位一致
     double sum = 0.0;
     const size_t numSamples = indices.size();
-    
-    // **教授建议：避免过小数据集的并行开销**
-    if (numSamples > 1000) {
-        #pragma omp parallel for reduction(+:sum) schedule(static) num_threads(4)
-        for (size_t i = 0; i < numSamples; ++i) {
-            sum += labels[indices[i]];
-        }
-    } else {
-        for (size_t i = 0; i < numSamples; ++i) {
-            sum += labels[indices[i]];
-        }
+    for (size_t i = 0; i < numSamples; ++i) {
+        sum += labels[indices[i]];
     }
     const double nodePrediction = sum / numSamples;
     
@@ -331,8 +340,8 @@ void SingleTreeTrainer::splitNodeOptimized(Node* node,
         }
     }
 
-    // **原地分割策略**
-    auto partitionPoint = std::partition(indices.begin(), indices.end(),
+    // **原地稳定分割**：子节点保持行序，与任务队列路径相同，后续累加顺序一致
+    auto partitionPoint = std::stable_partition(indices.begin(), indices.end(),
         [&](int idx) {
             return data[idx * rowLength + bestFeat] <= bestThr;
         });
@@ -432,7 +441,7 @@ void SingleTreeTrainer::calculateTreeStats(const Node* node, int currentDepth,
 
 // 兼容性方法
 void SingleTreeTrainer::splitNode(Node* node,
-                                  const std::vector<double>& data,
+                                  ConstSpan<double> data,
                                   int rowLength,
                                   const std::vector<double>& labels,
                                   const std::vector<int>& indices,
@@ -442,7 +451,7 @@ void SingleTreeTrainer::splitNode(Node* node,
 }
 
 void SingleTreeTrainer::splitNodeInPlace(Node* node,
-                                         const std::vector<double>& data,
+                                         ConstSpan<double> data,
                                          int rowLength,
                                          const std::vector<double>& labels,
                                          std::vector<int>& indices,
@@ -451,7 +460,7 @@ void SingleTreeTrainer::splitNodeInPlace(Node* node,
 }
 
 void SingleTreeTrainer::splitNodeInPlaceParallel(Node* node,
-                                                 const std::vector<double>& data,
+                                                 ConstSpan<double> data,
                                                  int rowLength,
                                                  const std::vector<double>& labels,
                                                  std::vector<int>& indices,
@@ -11,37 +11,31 @@ void runXGBoostApp(const XGBoostAppOptions& opts) {
     // 读取数据
     int rowLength;
     DataIO io;
-    auto [X, y] = io.readCSV(opts.dataPath, rowLength);
+    const DataIO::ColumnSelection columns{DataIO::splitList(opts.featureColumns), opts.labelColumn};
+    auto [X, y] = io.readDataset(opts.dataPath, rowLength, columns);
     
     if (opts.verbose) {
         std::cout << "Loaded data: " << y.size() << " samples, " 
                   << (rowLength - 1) << " features" << std::endl;
     }
     
-    // 划分数据集
-    DataParams dp;
-    splitDataset(X, y, rowLength, dp);
+    // 划分数据集：训练 / 测试视图共享 X、y
+    DataViews dv = splitViews(X, y, rowLength, 0.8);
     
     // 创建训练器
     auto trainer = createXGBoostTrainer(opts);
     
     // 设置验证集（如果需要早停）
     if (opts.earlyStoppingRounds > 0 && opts.valSplit > 0) {
-        // 从训练集中再分出验证集
-        size_t trainSize = dp.y_train.size();
+        // 从训练集尾部再分出验证集（仅调整视图区间）
+        size_t trainSize = dv.train.size();
         size_t valSize = static_cast<size_t>(trainSize * opts.valSplit);
         
         if (valSize > 0) {
-            std::vector<double> X_val(dp.X_train.begin() + (trainSize - valSize) * dp.rowLength,
-                                     dp.X_train.end());
-            std::vector<double> y_val(dp.y_train.begin() + (trainSize - valSize),
-                                     dp.y_train.end());
+            dv.validation = dv.train.slice(trainSize - valSize, trainSize);
+            dv.train = dv.train.slice(0, trainSize - valSize);
             
-            // 调整训练集大小
-            dp.X_train.resize((trainSize - valSize) * dp.rowLength);
-            dp.y_train.resize(trainSize - valSize);
-            
-            trainer->setValidationData(X_val, y_val, dp.rowLength);
+            trainer->setValidationData(dv.validation);
         }
     }
     
@@ -51,13 +45,13 @@ void runXGBoostApp(const XGBoostAppOptions& opts) {
     }
     
     auto trainStart = std::chrono::high_resolution_clock::now();
-    trainer->train(dp.X_train, dp.rowLength, dp.y_train);
+    trainer->trainOnView(dv.train);
     auto trainEnd = std::chrono::high_resolution_clock::now();
     
     // 评估模型
     double trainMSE, trainMAE, testMSE, testMAE;
-    trainer->evaluate(dp.X_train, dp.rowLength, dp.y_train, trainMSE, trainMAE);
-    trainer->evaluate(dp.X_test, dp.rowLength, dp.y_test, testMSE, testMAE);
+    trainer->evaluateOnView(dv.train, trainMSE, trainMAE);
+    trainer->evaluateOnView(dv.test, testMSE, testMAE);
     
     auto totalEnd = std::chrono::high_resolution_clock::now();
     
@@ -75,7 +69,7 @@ void runXGBoostApp(const XGBoostAppOptions& opts) {
               << " | Total Time: " << totalTime.count() << "ms" << std::endl;
     
     // 输出特征重要性
-    auto importance = trainer->getFeatureImportance(dp.rowLength);
+    auto importance = trainer->getFeatureImportance(dv.rowLength);
     std::cout << "\nTop 10 Feature Importances:" << std::endl;
     std::vector<std::pair<double, int>> impWithIndex;
     for (int i = 0; i < static_cast<int>(importance.size()); ++i) {
@@ -103,6 +97,7 @@ std::unique_ptr<XGBoostTrainer> createXGBoostTrainer(const XGBoostAppOptions& op
     config.gamma = opts.gamma;
     config.subsample = opts.subsample;
     config.colsampleByTree = opts.colsampleByTree;
+    config.seed = opts.seed;
     config.verbose = opts.verbose;
     config.earlyStoppingRounds = opts.earlyStoppingRounds;
     config.tolerance = opts.tolerance;
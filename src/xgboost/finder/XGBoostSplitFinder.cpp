@@ -7,7 +7,7 @@
 #endif
 
 std::tuple<int, double, double> XGBoostSplitFinder::findBestSplit(
-    const std::vector<double>& data,
+    ConstSpan<double> data,
     int rowLength,
     const std::vector<double>& labels,
     const std::vector<int>& indices,
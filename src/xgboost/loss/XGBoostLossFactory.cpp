@@ -51,6 +51,45 @@ void XGBoostSquaredLoss::computeGradientsHessians(
     }
 }
 
+// 融合内核：预测更新 + 损失 + 梯度/Hessian 一次遍历完成（可向量化）
+double XGBoostSquaredLoss::updatePredictionsAndGradients(
+    const std::vector<double>& y_true,
+    const double* treePred,
+    double learningRate,
+    std::vector<double>& y_pred,
+    std::vector<double>& gradients,
+    std::vector<double>* hessians,
+    std::vector<double>* absGradients) const {
+
+    const size_t n = y_true.size();
+    gradients.resize(n);
+    if (hessians) hessians->resize(n);
+    if (absGradients) absGradients->resize(n);
+
+    const double* yt = y_true.data();
+    double* pred = y_pred.data();
+    double* grad = gradients.data();
+    double* hess = hessians ? hessians->data() : nullptr;
+    double* absGrad = absGradients ? absGradients->data() : nullptr;
+    double totalLoss = 0.0;
+
+    #pragma omp parallel for simd reduction(+:totalLoss) schedule(static) if(n > 2000)
+    for (size_t i = 0; i < n; ++i) {
+        double p = pred[i];
+        if (treePred) {
+            p += learningRate * treePred[i];
+            pred[i] = p;
+        }
+        const double g = p - yt[i];
+        grad[i] = g;
+        totalLoss += 0.5 * g * g;
+        if (hess) hess[i] = 1.0;
+        if (absGrad) absGrad[i] = std::abs(g);
+    }
+
+    return n > 0 ? totalLoss / n : 0.0;
+}
+
 // XGBoostLogisticLoss实现
 double XGBoostLogisticLoss::loss(double y_true, double y_pred) const {
     // 防止数值溢出
@@ -1,7 +1,7 @@
 #include "xgboost/trainer/XGBoostTrainer.hpp"
+#include "functions/random/Philox.hpp"
 #include <algorithm>
 #include <numeric>
-#include <random>
 #include <limits>
 #include <cmath>
 #ifdef _OPENMP
@@ -39,28 +39,33 @@ void XGBoostTrainer::train(const std::vector<double>& data, int rowLength, const
     std::vector<double> predictions(n, baseScore);
     std::vector<double> gradients(n), hessians(n);
     std::vector<char> rootMask(n, 1);
+    std::vector<int> subsampleIndices(config_.subsample < 1.0 ? n : 0);
+
+    validationLoss_.clear();
+    bestIteration_ = -1;
+    if (hasValidation_) {
+        valPredictions_.assign(y_val_.size(), baseScore);
+        validationLoss_.reserve(config_.numRounds);
+    }
+
+    // **优化3: 融合内核 - 损失与梯度/Hessian 一次遍历，之后每轮与预测更新合并**
+    std::vector<double> treeOutputs(n);
+    double nextLoss = lossFunction_->updatePredictionsAndGradients(
+        labels, nullptr, 0.0, predictions, gradients, &hessians);
 
     // **核心优化2: Boosting主循环**
     for (int round = 0; round < config_.numRounds; ++round) {
-        // 计算当前损失
-        const double currentLoss = lossFunction_->computeBatchLoss(labels, predictions);
-        trainingLoss_.push_back(currentLoss);
-
-        // **优化3: 并行计算梯度和Hessian**
-        lossFunction_->computeGradientsHessians(labels, predictions, gradients, hessians);
+        // 当前损失由上一轮融合内核给出
+        trainingLoss_.push_back(nextLoss);
 
         // 行采样 - XGBoost subsample功能
+        // 计数器型随机流由 (seed, 轮次) 决定，可复现；只洗出前 sampleSize 个位置
         if (config_.subsample < 1.0) {
             const size_t sampleSize = static_cast<size_t>(n * config_.subsample);
-            thread_local std::mt19937 gen(std::random_device{}());
-            thread_local std::vector<int> indices(n);
-            
-            if (indices.size() != n) {
-                indices.resize(n);
-                std::iota(indices.begin(), indices.end(), 0);
-            }
-            
-            std::shuffle(indices.begin(), indices.end(), gen);
+            std::iota(subsampleIndices.begin(), subsampleIndices.end(), 0);
+            Philox rng(config_.seed, {Philox::RowSubsample, static_cast<uint64_t>(round)});
+            rng.partialShuffle(subsampleIndices.begin(), subsampleIndices.end(), sampleSize);
+            const auto& indices = subsampleIndices;
             
             std::fill(rootMask.begin(), rootMask.end(), 0);
             for (size_t i = 0; i < sampleSize; ++i) {
@@ -74,15 +79,29 @@ void XGBoostTrainer::train(const std::vector<double>& data, int rowLength, const
         auto tree = trainSingleTree(columnData, gradients, hessians, rootMask);
         if (!tree) break;
 
-        // **优化4: 并行更新预测**
-        updatePredictions(data, rowLength, tree.get(), predictions);
+        // **优化4: 新树输出 + 融合更新预测/损失/梯度/Hessian（验证集只累加新树）**
+        computeTreeOutputs(data, rowLength, tree.get(), treeOutputs);
+        nextLoss = lossFunction_->updatePredictionsAndGradients(
+            labels, treeOutputs.data(), config_.eta, predictions, gradients, &hessians);
+        if (hasValidation_) {
+            updatePredictions(X_val_, valRowLength_, tree.get(), valPredictions_);
+        }
         model_.addTree(std::move(tree), config_.eta);
 
-        // 早停检查
-        if (hasValidation_ && config_.earlyStoppingRounds > 0) {
+        // 早停检查：有验证集时使用验证损失
+        if (hasValidation_) {
+            if (checkValidationEarlyStop(round)) {
+                if (config_.verbose) {
+                    std::cout << "Early stopping at round " << round
+                              << ", best round: " << bestIteration_ << std::endl;
+                }
+                break;
+            }
+        } else if (config_.earlyStoppingRounds > 0) {
             if (shouldEarlyStop(trainingLoss_, config_.earlyStoppingRounds)) break;
         }
     }
+    rollbackToBestIteration();
 }
 
 std::unique_ptr<Node> XGBoostTrainer::trainSingleTree(const ColumnData& columnData,
@@ -291,6 +310,24 @@ void XGBoostTrainer::updatePredictions(const std::vector<double>& data, int rowL
     }
 }
 
+void XGBoostTrainer::computeTreeOutputs(const std::vector<double>& data, int rowLength,
+                                        const Node* tree, std::vector<double>& outputs) const {
+    const size_t n = outputs.size();
+    
+    #pragma omp parallel for schedule(static, 256) if(n > 1000)
+    for (size_t i = 0; i < n; ++i) {
+        const double* sample = &data[i * rowLength];
+        const Node* cur = tree;
+        
+        while (cur && !cur->isLeaf) {
+            const double val = sample[cur->getFeatureIndex()];
+            cur = (val <= cur->getThreshold()) ? cur->getLeft() : cur->getRight();
+        }
+        
+        outputs[i] = cur ? cur->getPrediction() : 0.0;
+    }
+}
+
 void XGBoostTrainer::evaluate(const std::vector<double>& X, int rowLength,
                               const std::vector<double>& y, double& mse, double& mae) {
     const auto predictions = model_.predictBatch(X, rowLength);
@@ -329,8 +366,33 @@ bool XGBoostTrainer::shouldEarlyStop(const std::vector<double>& losses, int pati
 
 double XGBoostTrainer::computeValidationLoss() const {
     if (!hasValidation_) return 0.0;
-    const auto predictions = model_.predictBatch(X_val_, valRowLength_);
-    return lossFunction_->computeBatchLoss(y_val_, predictions);
+    return lossFunction_->computeBatchLoss(y_val_, valPredictions_);
+}
+
+bool XGBoostTrainer::checkValidationEarlyStop(int round) {
+    const double valLoss = computeValidationLoss();
+    validationLoss_.push_back(valLoss);
+
+    if (bestIteration_ < 0 || valLoss < bestValidationLoss_ - config_.tolerance) {
+        bestValidationLoss_ = valLoss;
+        bestIteration_ = round;
+        return false;
+    }
+
+    // 连续 earlyStoppingRounds 轮无改善：停止（回滚在循环结束后统一进行）
+    return config_.earlyStoppingRounds > 0 && round - bestIteration_ >= config_.earlyStoppingRounds;
+}
+
+// 有验证集时最终模型截断到验证损失最低的轮次，不论是否提前停止
+void XGBoostTrainer::rollbackToBestIteration() {
+    if (!hasValidation_ || bestIteration_ < 0) return;
+    const size_t keep = static_cast<size_t>(bestIteration_) + 1;
+    if (model_.getTreeCount() <= keep) return;
+    model_.truncate(keep);
+    if (config_.verbose) {
+        std::cout << "Rolled back to best round " << bestIteration_
+                  << " (validation loss " << bestValidationLoss_ << ")" << std::endl;
+    }
 }
 
 double XGBoostTrainer::predict(const double* sample, int rowLength) const {
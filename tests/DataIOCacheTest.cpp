@@ -0,0 +1,217 @@
+// =============================================================================
+// tests/DataIOCacheTest.cpp - 并行 CSV 解析与二进制缓存往返校验
+// =============================================================================
+#include "functions/io/DataIO.hpp"
+#include "functions/io/BinaryDataset.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const std::string& what) {
+    if (!ok) {
+        std::cerr << "FAIL: " << what << std::endl;
+        ++failures;
+    }
+}
+
+// 逐位比较（NaN 与 -0.0 也须一致）
+template <typename T>
+bool bitEqual(const std::vector<T>& a, const std::vector<T>& b) {
+    return a.size() == b.size() &&
+           (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+}
+
+// 写出格式混杂的 CSV：科学计数法、'+' 号、前导空白、-0、整数与 17 位有效数字
+void writeCSV(const std::string& path, size_t rows, int features, uint64_t seed) {
+    std::ofstream out(path);
+    for (int f = 0; f < features; ++f) out << "f" << f << ",";
+    out << "y\n";
+    uint64_t state = seed;
+    char buf[64];
+    for (size_t i = 0; i < rows; ++i) {
+        for (int f = 0; f <= features; ++f) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            const double v = static_cast<double>(state >> 11) / 9007199254740992.0 * 2000.0 - 1000.0;
+            switch ((state >> 3) % 6) {
+                case 0: std::snprintf(buf, sizeof(buf), "%.17g", v); break;
+                case 1: std::snprintf(buf, sizeof(buf), "%.6e", v / 1e5); break;
+                case 2: std::snprintf(buf, sizeof(buf), "+%.3f", v < 0 ? -v : v); break;
+                case 3: std::snprintf(buf, sizeof(buf), " %d", static_cast<int>(v)); break;
+                case 4: std::snprintf(buf, sizeof(buf), "%s", v < 0 ? "-0" : "0.5"); break;
+                default: std::snprintf(buf, sizeof(buf), "%.9g", v * 1e-300); break;
+            }
+            out << buf << (f < features ? "," : "\n");
+        }
+    }
+}
+
+// 基线语义的参考解析：std::getline 按逗号切分 + std::stod，末列为标签
+void referenceParse(const std::string& path, std::vector<double>& X, std::vector<double>& y, int& rowLength) {
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);  // 表头
+    X.clear();
+    y.clear();
+    rowLength = 0;
+    while (std::getline(in, line)) {
+        std::stringstream ss(line);
+        std::string value;
+        std::vector<double> row;
+        while (std::getline(ss, value, ',')) row.push_back(std::stod(value));
+        rowLength = static_cast<int>(row.size());
+        X.insert(X.end(), row.begin(), row.end() - 1);
+        y.push_back(row.back());
+    }
+}
+
+} // namespace
+
+int main() {
+    namespace fs = std::filesystem;
+    const fs::path dir = fs::temp_directory_path() / ("dt_cache_test_" + std::to_string(::getpid()));
+    fs::create_directories(dir);
+    const std::string csv = (dir / "data.csv").string();
+
+    const int features = 7;
+    writeCSV(csv, 20000, features, 2024);
+
+    std::vector<double> refX, refY;
+    int refRowLength = 0;
+    referenceParse(csv, refX, refY, refRowLength);
+
+    // 1. 并行 from_chars 解析与 std::stod 逐位一致
+    {
+        DataIO io;
+        io.setBinaryCacheEnabled(false);
+        int rowLength = 0;
+        auto [X, y] = io.readCSV(csv, rowLength);
+        check(rowLength == refRowLength, "parallel parser row length");
+        check(bitEqual(X, refX) && bitEqual(y, refY), "parallel parser equals std::stod");
+        check(!fs::exists(DataIO::binaryCachePath(csv)), "no cache written when disabled");
+    }
+
+    // 2. 首次读取写出缓存，再次读取走缓存，结果不变
+    {
+        DataIO io;
+        io.setBinaryCacheEnabled(true);
+        int rowLength = 0;
+        auto first = io.readCSV(csv, rowLength);
+        check(fs::exists(DataIO::binaryCachePath(csv)), "cache written on first read");
+        auto cached = BinaryDataset::open(DataIO::binaryCachePath(csv));
+        check(cached && cached->rows() == refY.size() && cached->features() == static_cast<size_t>(features),
+              "cache header");
+
+        int cachedRowLength = 0;
+        auto second = io.readCSV(csv, cachedRowLength);
+        check(cachedRowLength == refRowLength, "cached row length");
+        check(bitEqual(second.first, refX) && bitEqual(second.second, refY), "cache round trip");
+
+        // float32 缓存：逐元素等于 float64 结果的窄化
+        int f32RowLength = 0;
+        auto f32 = io.readCSVFloat(csv, f32RowLength);
+        std::vector<float> narrowed(refX.begin(), refX.end());
+        check(f32RowLength == refRowLength && bitEqual(f32.first, narrowed) && bitEqual(f32.second, refY),
+              "float32 cache round trip");
+    }
+
+    // 3. 源文件变化后缓存失效
+    {
+        writeCSV(csv, 1500, features, 7);
+        referenceParse(csv, refX, refY, refRowLength);
+        DataIO io;
+        io.setBinaryCacheEnabled(true);
+        int rowLength = 0;
+        auto [X, y] = io.readCSV(csv, rowLength);
+        check(bitEqual(X, refX) && bitEqual(y, refY), "stale cache is not used after the source changes");
+
+        // 行数使各段长度不是对齐粒度的整数倍：缓存仍须写出并可再次打开
+        auto rewritten = BinaryDataset::open(DataIO::binaryCachePath(csv));
+        check(rewritten && rewritten->rows() == refY.size(), "cache rewritten for the changed source");
+    }
+
+    // 3b. 等长改写：大小不变、修改时间被还原到改写前，缓存仍须失效
+    {
+        std::string text;
+        {
+            std::ifstream in(csv, std::ios::binary);
+            std::ostringstream ss;
+            ss << in.rdbuf();
+            text = ss.str();
+        }
+        const auto oldTime = fs::last_write_time(csv);
+        const size_t digit = text.find_first_of("123456789", text.find('\n'));
+        text[digit] = text[digit] == '9' ? '8' : static_cast<char>(text[digit] + 1);
+        {
+            std::ofstream out(csv, std::ios::binary | std::ios::trunc);
+            out << text;
+        }
+        fs::last_write_time(csv, oldTime);
+        referenceParse(csv, refX, refY, refRowLength);
+
+        DataIO io;
+        io.setBinaryCacheEnabled(true);
+        int rowLength = 0;
+        auto [X, y] = io.readCSV(csv, rowLength);
+        check(bitEqual(X, refX) && bitEqual(y, refY), "same-size rewrite with restored mtime invalidates the cache");
+        int f32RowLength = 0;
+        auto f32 = io.readCSVFloat(csv, f32RowLength);
+        std::vector<float> narrowed(refX.begin(), refX.end());
+        check(bitEqual(f32.first, narrowed), "same-size rewrite invalidates the float32 cache");
+    }
+
+    // 4. 带权重与桶号的缓存文件，以及分片行区间转置
+    {
+        const size_t rows = refY.size();
+        std::vector<double> weights(rows);
+        std::vector<uint16_t> bins(static_cast<size_t>(features) * rows);
+        for (size_t i = 0; i < rows; ++i) weights[i] = 0.5 + static_cast<double>(i % 7);
+        for (size_t k = 0; k < bins.size(); ++k) bins[k] = static_cast<uint16_t>(k % 255);
+
+        BinaryDataset::WriteOptions options;
+        options.weights = &weights;
+        options.bins = &bins;
+        options.numBins = 255;
+        const std::string path = (dir / "full.dtbin").string();
+        check(BinaryDataset::write(path, refX, refY, features, options), "write with weights and bins");
+
+        auto ds = BinaryDataset::open(path);
+        check(ds && ds->hasWeights() && ds->hasBins() && ds->numBins() == 255, "optional sections present");
+        if (ds) {
+            bool columnsOk = true;
+            for (int f = 0; f < features; ++f) {
+                for (size_t i = 0; i < rows; ++i) {
+                    columnsOk &= ds->featureColumn(f)[i] == refX[i * features + f];
+                    columnsOk &= ds->binColumn(f)[i] == bins[static_cast<size_t>(f) * rows + i];
+                }
+            }
+            check(columnsOk, "column-major features and bins");
+            check(std::memcmp(ds->weights(), weights.data(), rows * sizeof(double)) == 0, "weights");
+
+            std::vector<double> part;
+            ds->toRowMajor(part, 100, 900);
+            const std::vector<double> expected(refX.begin() + 100 * features, refX.begin() + 900 * features);
+            check(bitEqual(part, expected), "row-range transpose");
+        }
+    }
+
+    fs::remove_all(dir);
+
+    if (failures > 0) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "DataIO cache round trip: all checks passed" << std::endl;
+    return 0;
+}
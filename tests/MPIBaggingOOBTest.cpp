@@ -0,0 +1,128 @@
+// =============================================================================
+// tests/MPIBaggingOOBTest.cpp - 分布式 Bagging 与单进程结果一致性校验
+// 用法：mpirun -np N MPIBaggingOOBTest <data.csv>
+// =============================================================================
+#include "ensemble/MPIBaggingTrainer.hpp"
+#include "functions/io/DataIO.hpp"
+#include "pipeline/DatasetView.hpp"
+
+#include <mpi.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+int rank = 0;
+
+void check(bool ok, const std::string& what) {
+    if (!ok) {
+        std::cerr << "FAIL (rank " << rank << "): " << what << std::endl;
+        ++failures;
+    }
+}
+
+bool bitEqual(const std::vector<double>& a, const std::vector<double>& b) {
+    return a.size() == b.size() &&
+           (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(double)) == 0);
+}
+
+constexpr int kTrees = 12;
+constexpr double kSampleRatio = 1.0;
+constexpr int kMaxDepth = 8;
+constexpr int kMinSamplesLeaf = 2;
+constexpr uint32_t kSeed = 7;
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int threadSupport = MPI_THREAD_SINGLE;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_SERIALIZED, &threadSupport);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    if (argc < 2) {
+        if (rank == 0) std::cerr << "Usage: " << argv[0] << " <data.csv>" << std::endl;
+        MPI_Finalize();
+        return 1;
+    }
+
+    DataIO io;
+    io.setBinaryCacheEnabled(false);
+    int rowLength = 0;
+    auto [X, y] = io.readCSV(argv[1], rowLength);
+    const int numFeatures = rowLength - 1;
+    const DatasetView view(X, y, numFeatures);
+
+    // 单进程基线：同一种子、同一参数
+    BaggingTrainer serial(kTrees, kSampleRatio, kMaxDepth, kMinSamplesLeaf,
+                          "mse", "exhaustive", "none", 0.01, kSeed);
+    serial.setMaxFeatures("sqrt");
+    serial.setOOBImportance(true);
+    serial.trainOnView(view);
+    const double serialOOB = serial.getOOBError(view);
+    const std::vector<double> serialImportance = serial.getOOBPermutationImportance();
+    check(std::isfinite(serialOOB) && serialOOB > 0.0, "serial OOB error is positive");
+    check(serialImportance.size() == static_cast<size_t>(numFeatures), "serial OOB importance size");
+
+    for (const bool dynamic : {true, false}) {
+        const std::string mode = dynamic ? "dynamic" : "static";
+
+        MPIBaggingTrainer trainer(kTrees, kSampleRatio, kMaxDepth, kMinSamplesLeaf,
+                                  "mse", "exhaustive", "none", 0.01, kSeed);
+        trainer.setMaxFeatures("sqrt");
+        trainer.setOOBImportance(true);
+        trainer.setDynamicScheduling(dynamic);
+        trainer.trainOnView(view);
+
+        int localTrees = trainer.getLocalNumTrees();
+        int totalTrees = 0;
+        MPI_Allreduce(&localTrees, &totalTrees, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+        check(totalTrees == kTrees, mode + ": every tree trained exactly once");
+
+        // 各树的袋外贡献按树序号折叠：与单进程结果逐位一致，与树的分配无关
+        const double oobView = trainer.getOOBError(view);
+        const double oobRows = trainer.getOOBError(X, numFeatures, y);
+        check(oobView == serialOOB, mode + ": accumulated OOB error matches serial");
+        check(oobRows == serialOOB, mode + ": OOB error on rows matches serial");
+        check(bitEqual(trainer.getOOBPermutationImportance(numFeatures), serialImportance),
+              mode + ": OOB permutation importance matches serial");
+        if (rank == 0 && (oobView != serialOOB || oobRows != serialOOB)) {
+            std::cerr << std::setprecision(17) << "  serial " << serialOOB << " | view " << oobView
+                      << " | rows " << oobRows << std::endl;
+        }
+
+        // 未汇总森林时的批量 / 逐行预测也按树序号求和：与单进程逐位一致，与树的分配无关
+        std::vector<double> serialPred(y.size()), batchPred;
+        for (size_t i = 0; i < y.size(); ++i) serialPred[i] = serial.predict(&X[i * numFeatures], numFeatures);
+        trainer.predictBatch(X, numFeatures, batchPred);
+        check(bitEqual(batchPred, serialPred), mode + ": batch prediction matches serial");
+        bool sameRowPredictions = true;
+        for (size_t i = 0; i < y.size(); i += 7) {
+            sameRowPredictions &= trainer.predict(&X[i * numFeatures], numFeatures) == serialPred[i];
+        }
+        check(sameRowPredictions, mode + ": collective row prediction matches serial");
+
+        // 树只取决于种子与树序号：汇总后的森林与单进程森林逐位一致
+        trainer.gatherForest();
+        bool samePredictions = true;
+        for (size_t i = 0; i < y.size(); ++i) {
+            const double* sample = &X[i * numFeatures];
+            samePredictions &= trainer.predict(sample, numFeatures) == serial.predict(sample, numFeatures);
+        }
+        check(samePredictions, mode + ": gathered forest predicts like the serial forest");
+    }
+
+    int globalFailures = 0;
+    MPI_Allreduce(&failures, &globalFailures, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    if (rank == 0) {
+        if (globalFailures == 0) std::cout << "MPI Bagging OOB: all checks passed" << std::endl;
+        else std::cerr << globalFailures << " check(s) failed" << std::endl;
+    }
+    MPI_Finalize();
+    return globalFailures == 0 ? 0 : 1;
+}
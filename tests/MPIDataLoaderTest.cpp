@@ -0,0 +1,202 @@
+// =============================================================================
+// tests/MPIDataLoaderTest.cpp - 分片加载与分块集合通信校验
+// 用法：mpirun -np N MPIDataLoaderTest（N >= 2 时才覆盖跨进程拼接）
+// =============================================================================
+#include "ensemble/MPIDataLoader.hpp"
+#include "functions/io/BinaryDataset.hpp"
+#include "functions/io/DataIO.hpp"
+
+#include <mpi.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+int failures = 0;
+int rank = 0;
+int size = 1;
+
+void check(bool ok, const std::string& what) {
+    if (!ok) {
+        std::cerr << "FAIL (rank " << rank << "): " << what << std::endl;
+        ++failures;
+    }
+}
+
+template <typename T>
+bool bitEqual(const T* a, const T* b, size_t n) {
+    return n == 0 || std::memcmp(a, b, n * sizeof(T)) == 0;
+}
+
+// 行数不被进程数整除、行长各异（分片边界落在行中间）
+void writeCSV(const std::string& path, size_t firstRow, size_t rows, int features) {
+    std::ofstream out(path);
+    for (int f = 0; f < features; ++f) out << "f" << f << ",";
+    out << "y\n";
+    char buf[64];
+    for (size_t i = firstRow; i < firstRow + rows; ++i) {
+        for (int f = 0; f <= features; ++f) {
+            const double v = static_cast<double>((i * 2654435761u + f * 40503u) % 100003) / 7.0 - 5000.0;
+            std::snprintf(buf, sizeof(buf), (i + f) % 3 == 0 ? "%.17g" : "%.4f", v);
+            out << buf << (f < features ? "," : "\n");
+        }
+    }
+}
+
+void checkLoad(const std::string& spec, const std::string& label) {
+    DataIO io;
+    io.setBinaryCacheEnabled(false);
+    int refRowLength = 0;
+    auto [refX, refY] = io.readDataset(spec, refRowLength);
+
+    auto sharded = mpi_data::loadSharded(spec, MPI_COMM_WORLD);
+    check(sharded.rowLength == refRowLength, label + ": row length");
+    check(sharded.X.size() == refX.size() && bitEqual(sharded.X.data(), refX.data(), refX.size()),
+          label + ": features equal single-process readDataset");
+    check(sharded.y.size() == refY.size() && bitEqual(sharded.y.data(), refY.data(), refY.size()),
+          label + ": labels equal single-process readDataset");
+
+    unsigned long long localRows = sharded.localRows, totalRows = 0;
+    MPI_Allreduce(&localRows, &totalRows, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+    check(totalRows == refY.size(), label + ": shards cover every row once");
+
+    auto shared = mpi_data::loadShardedShared(spec, MPI_COMM_WORLD);
+    check(shared.rowLength == refRowLength, label + ": shared row length");
+    check(shared.X.size() == refX.size() && bitEqual(shared.X.data(), refX.data(), refX.size()),
+          label + ": node-shared features equal single-process readDataset");
+    check(shared.y.size() == refY.size() && bitEqual(shared.y.data(), refY.data(), refY.size()),
+          label + ": node-shared labels equal single-process readDataset");
+}
+
+// chunkElements 取很小的值，迫使每个集合操作拆成多轮
+void checkCollectives() {
+    constexpr size_t kChunk = 8;
+
+    // allgatherChunked：各进程贡献长度不同，最后一个进程不贡献
+    {
+        const size_t localCount = (rank == size - 1 && size > 1) ? 0 : static_cast<size_t>(5 * rank + 3);
+        std::vector<double> local(localCount);
+        for (size_t i = 0; i < localCount; ++i) local[i] = rank * 1000.0 + static_cast<double>(i);
+        std::vector<double> global;
+        mpi_data::allgatherChunked(local, global, MPI_COMM_WORLD, kChunk);
+
+        std::vector<double> expected;
+        for (int r = 0; r < size; ++r) {
+            const size_t n = (r == size - 1 && size > 1) ? 0 : static_cast<size_t>(5 * r + 3);
+            for (size_t i = 0; i < n; ++i) expected.push_back(r * 1000.0 + static_cast<double>(i));
+        }
+        check(global == expected, "allgatherChunked");
+    }
+
+    // bcastChunked：非 0 根进程
+    {
+        const int root = size - 1;
+        std::vector<double> data(37, -1.0);
+        if (rank == root) {
+            for (size_t i = 0; i < data.size(); ++i) data[i] = 0.25 * static_cast<double>(i);
+        }
+        mpi_data::bcastChunked(data.data(), data.size(), root, MPI_COMM_WORLD, kChunk);
+        bool ok = true;
+        for (size_t i = 0; i < data.size(); ++i) ok &= data[i] == 0.25 * static_cast<double>(i);
+        check(ok, "bcastChunked");
+    }
+
+    // gatherBytesChunked：全收集与单根收集
+    for (const int root : {-1, 0}) {
+        const size_t bytes = static_cast<size_t>(7 * rank + 1);
+        std::vector<char> local(bytes);
+        for (size_t i = 0; i < bytes; ++i) local[i] = static_cast<char>('a' + (rank + i) % 26);
+
+        std::vector<char> global;
+        std::vector<uint64_t> counts;
+        mpi_data::gatherBytesChunked(local.data(), bytes, global, counts, root, MPI_COMM_WORLD, kChunk);
+
+        const std::string label = root < 0 ? "gatherBytesChunked (all)" : "gatherBytesChunked (root)";
+        if (root < 0 || rank == root) {
+            std::vector<char> expected;
+            bool countsOk = counts.size() == static_cast<size_t>(size);
+            for (int r = 0; r < size; ++r) {
+                const size_t n = static_cast<size_t>(7 * r + 1);
+                countsOk = countsOk && counts[r] == n;
+                for (size_t i = 0; i < n; ++i) expected.push_back(static_cast<char>('a' + (r + i) % 26));
+            }
+            check(countsOk, label + ": counts");
+            check(global == expected, label + ": payload");
+        } else {
+            check(global.empty(), label + ": non-root receives nothing");
+        }
+    }
+
+    // allreduceSumChunked：整数值之和无舍入误差，可精确比较
+    {
+        std::vector<double> data(29);
+        for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<double>(rank + 1) * static_cast<double>(i);
+        mpi_data::allreduceSumChunked(data.data(), data.size(), MPI_COMM_WORLD, kChunk);
+        const double ranksSum = size * (size + 1) / 2.0;
+        bool ok = true;
+        for (size_t i = 0; i < data.size(); ++i) ok &= data[i] == ranksSum * static_cast<double>(i);
+        check(ok, "allreduceSumChunked");
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    // 分片加载不写二进制缓存，测试目录里只有显式写出的文件
+    setenv("DT_BINARY_CACHE", "0", 1);
+
+    namespace fs = std::filesystem;
+    long long tag = rank == 0 ? static_cast<long long>(::getpid()) : 0;
+    MPI_Bcast(&tag, 1, MPI_LONG_LONG, 0, MPI_COMM_WORLD);
+    const fs::path dir = fs::temp_directory_path() / ("dt_mpi_loader_test_" + std::to_string(tag));
+    const std::string csv = (dir / "data.csv").string();
+    const std::string part0 = (dir / "part0.csv").string();
+    const std::string part1 = (dir / "part1.csv").string();
+    const std::string part2 = (dir / "part2.csv").string();
+    const std::string bin = (dir / "data.dtbin").string();
+    const int features = 5;
+
+    if (rank == 0) {
+        fs::create_directories(dir);
+        writeCSV(csv, 0, 1001, features);
+        writeCSV(part0, 0, 400, features);
+        writeCSV(part1, 400, 1, features);
+        writeCSV(part2, 401, 600, features);
+
+        DataIO io;
+        io.setBinaryCacheEnabled(false);
+        int rowLength = 0;
+        auto [X, y] = io.readCSV(csv, rowLength);
+        check(BinaryDataset::write(bin, X, y, features, BinaryDataset::WriteOptions{}), "write .dtbin");
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    checkLoad(csv, "csv byte shards");
+    checkLoad(bin, "dtbin row shards");
+    checkLoad(part0 + "," + part1 + "," + part2, "multi-file");
+    checkCollectives();
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    if (rank == 0) fs::remove_all(dir);
+
+    int globalFailures = 0;
+    MPI_Allreduce(&failures, &globalFailures, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    if (rank == 0) {
+        if (globalFailures == 0) std::cout << "MPI data loader: all checks passed" << std::endl;
+        else std::cerr << globalFailures << " check(s) failed" << std::endl;
+    }
+    MPI_Finalize();
+    return globalFailures == 0 ? 0 : 1;
+}
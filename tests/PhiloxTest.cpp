@@ -0,0 +1,152 @@
+// =============================================================================
+// tests/PhiloxTest.cpp - Philox4x32-10 已知答案与流接口确定性校验
+// =============================================================================
+#include "functions/random/Philox.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const std::string& what) {
+    if (!ok) {
+        std::cerr << "FAIL: " << what << std::endl;
+        ++failures;
+    }
+}
+
+uint64_t join(uint32_t lo, uint32_t hi) {
+    return (static_cast<uint64_t>(hi) << 32) | lo;
+}
+
+// Random123 philox4x32_10 的已知答案向量（kat_vectors）：ctr[4], key[2] -> out[4]
+struct KnownAnswer {
+    std::array<uint32_t, 4> counter;
+    std::array<uint32_t, 2> key;
+    std::array<uint32_t, 4> expected;
+};
+
+const KnownAnswer kKnownAnswers[] = {
+    {{0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}, {0x00000000u, 0x00000000u},
+     {0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u}},
+    {{0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu}, {0xffffffffu, 0xffffffffu},
+     {0x408f276du, 0x41c83b0eu, 0xa20bc7c6u, 0x6d5451fdu}},
+    {{0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u}, {0xa4093822u, 0x299f31d0u},
+     {0xd16cfe09u, 0x94fdccebu, 0x5001e420u, 0x24126ea1u}},
+};
+
+void checkKnownAnswers() {
+    for (const auto& kat : kKnownAnswers) {
+        const uint64_t seed = join(kat.key[0], kat.key[1]);
+        const uint64_t blockIndex = join(kat.counter[0], kat.counter[1]);
+        const uint64_t stream = join(kat.counter[2], kat.counter[3]);
+        check(Philox::block(seed, stream, blockIndex) == kat.expected,
+              "known-answer vector for key " + std::to_string(seed));
+    }
+
+    // 流的第一个块就是 counter = {0, 0, 流号} 的块
+    Philox zero(0, 0);
+    std::array<uint32_t, 4> first{};
+    for (auto& word : first) word = zero();
+    check(first == kKnownAnswers[0].expected, "stream output starts at block 0");
+}
+
+void checkStreamAccess() {
+    const uint64_t seed = 0x0123456789ABCDEFULL;
+    const uint64_t stream = Philox::hashIds({Philox::Bootstrap, 17});
+
+    Philox sequential(seed, stream);
+    std::vector<uint32_t> outputs(64);
+    for (auto& v : outputs) v = sequential();
+
+    bool blocksOk = true;
+    for (size_t b = 0; b < outputs.size() / 4; ++b) {
+        const auto expected = Philox::block(seed, stream, b);
+        for (size_t k = 0; k < 4; ++k) blocksOk &= outputs[b * 4 + k] == expected[k];
+    }
+    check(blocksOk, "operator() walks blocks in order");
+
+    bool seekOk = true;
+    for (const uint64_t position : {0ULL, 1ULL, 3ULL, 4ULL, 13ULL, 38ULL, 63ULL}) {
+        Philox jumped(seed, stream);
+        jumped.seek(position);
+        seekOk &= jumped() == outputs[position];
+    }
+    check(seekOk, "seek matches sequential generation");
+
+    Philox mixed(seed, {Philox::Bootstrap, 17});
+    check(mixed() == outputs[0], "initializer-list constructor hashes the ids");
+
+    Philox other(seed, Philox::hashIds({Philox::Bootstrap, 18}));
+    check(other() != outputs[0], "different streams differ");
+}
+
+void checkSampling() {
+    Philox a(42, {Philox::Shuffle, 3});
+    Philox b(42, {Philox::Shuffle, 3});
+
+    bool belowOk = true;
+    for (const uint64_t n : {1ULL, 2ULL, 3ULL, 7ULL, 1000ULL, (1ULL << 63) + 5}) {
+        for (int i = 0; i < 200; ++i) {
+            const uint64_t x = a.below(n);
+            belowOk &= x < n && x == b.below(n);
+        }
+    }
+    check(belowOk, "below() is in range and deterministic");
+
+    bool uniformOk = true;
+    for (int i = 0; i < 1000; ++i) {
+        const double u = a.uniform();
+        uniformOk &= u >= 0.0 && u < 1.0 && u == b.uniform();
+    }
+    check(uniformOk, "uniform() is in [0, 1) and deterministic");
+
+    std::vector<int> x(50), y(50);
+    std::iota(x.begin(), x.end(), 0);
+    std::iota(y.begin(), y.end(), 0);
+    a.shuffle(x.begin(), x.end());
+    b.shuffle(y.begin(), y.end());
+    std::vector<int> sorted = x;
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<int> identity(50);
+    std::iota(identity.begin(), identity.end(), 0);
+    check(x == y && sorted == identity && x != identity, "shuffle is a deterministic permutation");
+}
+
+void checkNodeKey() {
+    std::vector<int> rows = {5, 9, 2, 40, 17, 3, 3, 28};
+    const uint64_t key = Philox::nodeKey(rows);
+
+    std::vector<int> permuted = rows;
+    std::reverse(permuted.begin(), permuted.end());
+    std::rotate(permuted.begin(), permuted.begin() + 3, permuted.end());
+    check(Philox::nodeKey(permuted) == key, "nodeKey ignores row order");
+
+    std::vector<int> changed = rows;
+    changed[4] = 18;
+    check(Philox::nodeKey(changed) != key, "nodeKey depends on the row set");
+    check(Philox::nodeKey({}) == 0, "nodeKey of an empty node");
+}
+
+} // namespace
+
+int main() {
+    checkKnownAnswers();
+    checkStreamAccess();
+    checkSampling();
+    checkNodeKey();
+
+    if (failures > 0) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "Philox4x32-10: all checks passed" << std::endl;
+    return 0;
+}
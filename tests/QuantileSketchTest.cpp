@@ -0,0 +1,164 @@
+// =============================================================================
+// tests/QuantileSketchTest.cpp - 分位数摘要的秩误差、合并与切点校验
+// =============================================================================
+#include "histogram/QuantileSketch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const std::string& what) {
+    if (!ok) {
+        std::cerr << "FAIL: " << what << std::endl;
+        ++failures;
+    }
+}
+
+// 近似对数正态分布、保留两位小数：大量重复取值
+std::vector<double> makeData(size_t n, uint64_t seed) {
+    std::vector<double> values(n);
+    uint64_t state = seed;
+    auto uniform = [&state]() {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (static_cast<double>(state >> 11) + 0.5) / 9007199254740992.0;
+    };
+    for (auto& v : values) {
+        const double z = std::sqrt(-2.0 * std::log(uniform())) * std::cos(6.283185307179586 * uniform());
+        v = std::round(std::exp(z) * 100.0) / 100.0;
+    }
+    return values;
+}
+
+// 返回值 v 的精确秩区间为 [#(< v), #(<= v)]，误差为目标秩到该区间的距离
+double maxRankError(const QuantileSketch& sketch, const std::vector<double>& sorted) {
+    const double n = static_cast<double>(sorted.size());
+    double worst = 0.0;
+    for (int k = 0; k <= 1000; ++k) {
+        const double target = n * k / 1000.0;
+        const double v = sketch.quantile(k / 1000.0);
+        const double lo = static_cast<double>(std::lower_bound(sorted.begin(), sorted.end(), v) - sorted.begin());
+        const double hi = static_cast<double>(std::upper_bound(sorted.begin(), sorted.end(), v) - sorted.begin());
+        worst = std::max(worst, std::max(lo - target, target - hi));
+    }
+    return worst / n;
+}
+
+void checkCutPoints(const QuantileSketch& sketch, const std::vector<double>& sorted,
+                    int numBins, const std::string& label) {
+    const std::vector<double> cuts = sketch.cutPoints(numBins);
+    bool increasing = true, observed = true, belowMax = true;
+    for (size_t b = 0; b < cuts.size(); ++b) {
+        increasing &= b == 0 || cuts[b] > cuts[b - 1];
+        observed &= std::binary_search(sorted.begin(), sorted.end(), cuts[b]);
+        belowMax &= cuts[b] < sketch.maxValue();
+    }
+    check(!cuts.empty() && static_cast<int>(cuts.size()) < numBins, label + ": cut count");
+    check(increasing, label + ": cuts strictly increasing");
+    check(observed, label + ": cuts are data values");
+    check(belowMax, label + ": cuts below the maximum");
+}
+
+// 1. 单个摘要：带重复值的秩误差对照精确排序
+void checkRankError() {
+    const std::vector<double> data = makeData(200000, 17);
+    std::vector<double> sorted = data;
+    std::sort(sorted.begin(), sorted.end());
+
+    QuantileSketch sketch(1024);
+    for (const double v : data) sketch.add(v);
+    check(sketch.totalWeight() == static_cast<double>(data.size()), "total weight");
+    check(sketch.minValue() == sorted.front() && sketch.maxValue() == sorted.back(), "min / max");
+    check(sketch.memoryEntries() < data.size() / 10, "memory stays bounded");
+
+    const double error = maxRankError(sketch, sorted);
+    check(error < 0.002, "rank error " + std::to_string(error) + " below 0.2%");
+
+    checkCutPoints(sketch, sorted, 256, "single sketch");
+    checkCutPoints(sketch, sorted, 4, "single sketch, few bins");
+}
+
+// 2. 合并：merge 与 mergeSerialized 结果逐位相同，且与单个摘要同等精度
+void checkMerge() {
+    const std::vector<double> data = makeData(200000, 29);
+    std::vector<double> sorted = data;
+    std::sort(sorted.begin(), sorted.end());
+
+    QuantileSketch single(1024), left(1024), right(1024), leftSerialized(1024);
+    for (const double v : data) single.add(v);
+    const size_t split = data.size() / 3;
+    for (size_t i = 0; i < split; ++i) {
+        left.add(data[i]);
+        leftSerialized.add(data[i]);
+    }
+    for (size_t i = split; i < data.size(); ++i) right.add(data[i]);
+
+    std::vector<double> wire;
+    right.serialize(wire);
+    left.merge(right);
+    leftSerialized.mergeSerialized(wire.data(), wire.size());
+
+    check(left.cutPoints(256) == leftSerialized.cutPoints(256), "merge and mergeSerialized agree");
+    check(left.totalWeight() == single.totalWeight() && leftSerialized.totalWeight() == single.totalWeight(),
+          "merged total weight");
+    check(left.minValue() == single.minValue() && left.maxValue() == single.maxValue() &&
+          leftSerialized.minValue() == single.minValue() && leftSerialized.maxValue() == single.maxValue(),
+          "merged min / max");
+    check(maxRankError(left, sorted) < 0.002, "merge rank error");
+    check(maxRankError(leftSerialized, sorted) < 0.002, "mergeSerialized rank error");
+    checkCutPoints(leftSerialized, sorted, 256, "mergeSerialized");
+
+    // 数据量小于摘要容量时摘要是精确的：合并结果与单个摘要完全相同
+    const std::vector<double> small(data.begin(), data.begin() + 900);
+    QuantileSketch exact(1024), a(1024), b(1024), c(1024);
+    for (size_t i = 0; i < small.size(); ++i) {
+        exact.add(small[i]);
+        (i % 2 == 0 ? a : b).add(small[i]);
+        if (i % 2 == 0) c.add(small[i]);
+    }
+    std::vector<double> bWire;
+    b.serialize(bWire);
+    a.merge(b);
+    c.mergeSerialized(bWire.data(), bWire.size());
+    bool quantilesEqual = true;
+    for (int k = 0; k <= 100; ++k) {
+        quantilesEqual &= a.quantile(k / 100.0) == exact.quantile(k / 100.0);
+        quantilesEqual &= c.quantile(k / 100.0) == exact.quantile(k / 100.0);
+    }
+    check(quantilesEqual, "exact merge equals a single sketch");
+    check(a.cutPoints(32) == exact.cutPoints(32) && c.cutPoints(32) == exact.cutPoints(32),
+          "exact merge cut points equal a single sketch");
+}
+
+// 3. 并行构建与逐个写入精度一致
+void checkBuild() {
+    const std::vector<double> data = makeData(300000, 41);
+    std::vector<double> sorted = data;
+    std::sort(sorted.begin(), sorted.end());
+
+    const QuantileSketch built = QuantileSketch::build(data.data(), data.size(), 1024);
+    check(built.totalWeight() == static_cast<double>(data.size()), "build total weight");
+    check(maxRankError(built, sorted) < 0.002, "build rank error");
+    checkCutPoints(built, sorted, 64, "build");
+}
+
+} // namespace
+
+int main() {
+    checkRankError();
+    checkMerge();
+    checkBuild();
+
+    if (failures > 0) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "QuantileSketch: all checks passed" << std::endl;
+    return 0;
+}